@@ -2,7 +2,11 @@
 
 #include "ga/ga-mpi.h"
 #include "tamm/proc_group.hpp"
+#include <algorithm>
 #include <atomic>
+#include <deque>
+#include <limits>
+#include <vector>
 
 namespace tamm {
 
@@ -32,6 +36,16 @@ class AtomicCounter {
    */
   virtual int64_t fetch_add(int64_t index, int64_t sz) = 0;
 
+  /**
+   * @brief Hint the number of tasks that will be dispatched through a counter.
+   *
+   * Local (non-collective) call. Counters that hand out tasks in chunks use it
+   * to size the chunks and to detect when the task range is exhausted.
+   * @param index The @p index-th counter
+   * @param ntasks Number of tasks; tasks are numbered from the initial value
+   */
+  virtual void set_task_count(int64_t index, int64_t ntasks) {}
+
   /**
    * Destructor.
    * @pre The counter has already been deallocated.
@@ -91,18 +105,27 @@ class AtomicCounterGA : public AtomicCounter {
     char name[] = "atomic-counter";
     ga_ = NGA_Create_config64(MT_C_LONGLONG, 1, &size, name, nullptr, ga_pg_);
     //EXPECTS(ga_ != 0);
+    allocated_ = true;
+    reset(init_val);
+  }
+
+  /**
+   * @brief Set all counters of an allocated counter array back to a value.
+   *
+   * Collective on the process group; cheaper than re-creating the array when
+   * the same counters are reused across executions.
+   * @param init_val Value to which all counters are set
+   */
+  void reset(int64_t init_val) {
+    EXPECTS(allocated_ == true);
     if(GA_Pgroup_nodeid(ga_pg_) == 0) {
       int64_t lo[1] = {0};
       int64_t hi[1] = {num_counters_ - 1};
       int64_t ld = -1;
-      long long buf[num_counters_];
-      for(int i=0; i<num_counters_; i++) {
-        buf[i] = init_val;
-      }
-      NGA_Put64(ga_, lo, hi, buf, &ld);
+      std::vector<long long> buf(num_counters_, init_val);
+      NGA_Put64(ga_, lo, hi, buf.data(), &ld);
     }
     GA_Pgroup_sync(ga_pg_);
-    allocated_ = true;
   }
 
   /**
@@ -132,6 +155,24 @@ class AtomicCounterGA : public AtomicCounter {
     return ret;
   }
 
+  /**
+   * @brief Read a counter without modifying it.
+   *
+   * A plain one-sided get, cheaper for the owner of the counter than
+   * fetch_add(index, 0) when the value is polled.
+   * @param index The @p index-th counter
+   * @return Current value of the counter
+   */
+  int64_t read(int64_t index) {
+    EXPECTS(allocated_ == true);
+    long long val;
+    NGA_Get64(ga_, &index, &index, &val, nullptr);
+    return val;
+  }
+
+  /// Number of counters in the array
+  int64_t size() const { return num_counters_; }
+
   /**
    * @copydoc AtomicCounter::~AtomicCounter()
    */
@@ -171,5 +212,284 @@ class AtomicCounterGA : public AtomicCounter {
 
 };
 
+/**
+ * @brief Chunked atomic counter with work stealing.
+ *
+ * Drop-in replacement for AtomicCounterGA in the `next == taskcount` loops,
+ * where fetch_add(index, 1) returns the next task index of the calling rank.
+ * Instead of one remote atomic per task on a single rank, every rank owns a
+ * word in its local part of a GA, packing the range of tasks it currently
+ * holds as (end << 32 | next). A task is taken with an atomic increment of the
+ * local word. When the word is exhausted, the rank claims a guided chunk of
+ * tasks, max(min_chunk, remaining / (2 * nfetchers)), from the global counter.
+ * Once the global counter is exhausted (requires set_task_count()), idle
+ * ranks steal the upper half of the range held by another fetching rank,
+ * trying ranks on the same node first.
+ *
+ * In the sub-group loops only the root of each group calls fetch_add and
+ * broadcasts the task; the other ranks pass fetches = false, so that chunks
+ * are sized for, and stolen from, the fetching ranks only.
+ *
+ * Tasks returned to a rank are strictly increasing, as the loops require;
+ * std::numeric_limits<int64_t>::max() is returned once no task is left.
+ * Only increments of 1 are supported.
+ */
+class AtomicCounterChunked : public AtomicCounter {
+ public:
+  /**
+   * @brief Construct the counter. Does not allocate it.
+   * @param pg Process group in which the counter arrays are created
+   * @param num_counters Number of independent counters
+   * @param fetches Whether the calling rank calls fetch_add
+   * @param min_chunk Smallest number of tasks claimed from the global counter
+   */
+  AtomicCounterChunked(const ProcGroup& pg, int64_t num_counters, bool fetches = true,
+                       int64_t min_chunk = 1)
+      : allocated_{false},
+        num_counters_{num_counters},
+        fetches_{fetches},
+        min_chunk_{std::max<int64_t>(min_chunk, 1)},
+        init_val_{0},
+        pg_{pg} { }
+
+  /**
+   * @brief Allocate the global counters and the per-rank task words.
+   *
+   * Collective on the process group; also gathers the fetching ranks.
+   * @param init_val Index of the first task of every counter
+   */
+  void allocate(int64_t init_val) {
+    EXPECTS(allocated_ == false);
+    ga_pg_  = pg_.ga_pg();
+    nranks_ = GA_Pgroup_nnodes(ga_pg_);
+    rank_   = GA_Pgroup_nodeid(ga_pg_);
+
+    std::vector<long> fetching(nranks_, 0);
+    fetching[rank_] = fetches_ ? 1 : 0;
+    GA_Pgroup_lgop(ga_pg_, fetching.data(), nranks_, const_cast<char*>("+"));
+    fetchers_.clear();
+    for(int r = 0; r < nranks_; r++)
+      if(fetching[r]) fetchers_.push_back(r);
+    EXPECTS(!fetchers_.empty());
+
+    int64_t size = num_counters_;
+    char gname[] = "atomic-counter-global";
+    ga_global_ = NGA_Create_config64(MT_C_LONGLONG, 1, &size, gname, nullptr, ga_pg_);
+
+    // rank r owns a (word, steal lock) pair per counter
+    int64_t wsize = 2 * num_counters_ * nranks_;
+    int64_t nblock = nranks_;
+    std::vector<int64_t> map(nranks_);
+    for(int r = 0; r < nranks_; r++) map[r] = 2 * num_counters_ * r;
+    char wname[] = "atomic-counter-words";
+    ga_words_ = NGA_Create_irreg_config64(MT_C_LONGLONG, 1, &wsize, wname, &nblock,
+                                          map.data(), ga_pg_);
+
+    // ranks are assumed to be numbered contiguously within a node
+    ppn_ = std::max(1, std::min(GA_Cluster_nprocs(GA_Cluster_nodeid()), nranks_));
+
+    allocated_ = true;
+    reset(init_val);
+  }
+
+  /**
+   * @brief Reset all counters to a value. Collective on the process group.
+   * @param init_val Index of the first task of every counter
+   */
+  void reset(int64_t init_val) {
+    EXPECTS(allocated_ == true);
+    GA_Zero(ga_words_);
+    if(rank_ == 0) {
+      int64_t lo[1] = {0};
+      int64_t hi[1] = {num_counters_ - 1};
+      int64_t ld = -1;
+      std::vector<long long> buf(num_counters_, init_val);
+      NGA_Put64(ga_global_, lo, hi, buf.data(), &ld);
+    }
+    init_val_ = init_val;
+    state_.assign(num_counters_, State{});
+    for(auto& s: state_) {
+      s.last        = init_val - 1;
+      s.global_seen = init_val;
+    }
+    GA_Pgroup_sync(ga_pg_);
+  }
+
+  /**
+   * @brief Deallocate the counter arrays. Collective on the process group.
+   */
+  void deallocate() {
+    EXPECTS(allocated_ == true);
+    GA_Pgroup_sync(ga_pg_);
+    GA_Destroy(ga_words_);
+    GA_Destroy(ga_global_);
+    state_.clear();
+    allocated_ = false;
+  }
+
+  /**
+   * @copydoc AtomicCounter::set_task_count()
+   */
+  void set_task_count(int64_t index, int64_t ntasks) {
+    EXPECTS(allocated_ == true);
+    state_[index].ntasks = init_val_ + ntasks;
+  }
+
+  /**
+   * @brief Next task index of the calling rank for the @p index-th counter.
+   * @param index The @p index-th counter
+   * @param amount Must be 1
+   * @return Next task index, or std::numeric_limits<int64_t>::max() when done
+   */
+  int64_t fetch_add(int64_t index, int64_t amount) {
+    EXPECTS(allocated_ == true);
+    EXPECTS(amount == 1);
+    EXPECTS(fetches_);
+    State& s = state_[index];
+    int64_t widx = word_index(rank_, index);
+
+    while(true) {
+      if(s.live) {
+        long long old = NGA_Read_inc64(ga_words_, &widx, 1);
+        s.next = low(old) + 1;
+        s.end  = high(old);
+        if(low(old) < high(old)) return s.last = low(old);
+        s.live = false;
+      }
+      if(!s.pending.empty()) {
+        auto& r = s.pending.front();
+        int64_t t = r.first++;
+        if(r.first == r.second) s.pending.pop_front();
+        return s.last = t;
+      }
+      if(!s.global_done && refill(s, index)) continue;
+      if(s.ntasks >= 0 && steal(s, index)) continue;
+      return std::numeric_limits<int64_t>::max();
+    }
+  }
+
+  /// Number of counters in the array
+  int64_t size() const { return num_counters_; }
+
+  /**
+   * @copydoc AtomicCounter::~AtomicCounter()
+   */
+  ~AtomicCounterChunked() {
+    EXPECTS_NOTHROW(allocated_ == false);
+  }
+
+ private:
+  struct State {
+    int64_t next = 0;         // next field of the own word, as last observed
+    int64_t end = 0;          // end field of the own word, as last observed
+    bool live = false;        // own word may still hold tasks
+    bool global_done = false; // global counter known to be exhausted
+    int64_t last = -1;        // last task returned to this rank
+    int64_t global_seen = 0;  // global counter value after the last refill
+    int64_t ntasks = -1;      // one past the last task index, -1 if unknown
+    std::deque<std::pair<int64_t, int64_t>> pending; // private [begin, end) ranges
+  };
+
+  static int64_t low(long long w) { return static_cast<int64_t>(w & 0xffffffffLL); }
+  static int64_t high(long long w) { return static_cast<int64_t>(w >> 32); }
+
+  int64_t word_index(int rank, int64_t index) const {
+    return 2 * (num_counters_ * rank + index);
+  }
+
+  /// Claim a chunk from the global counter and install it in the own word
+  bool refill(State& s, int64_t index) {
+    int64_t chunk = min_chunk_;
+    if(s.ntasks >= 0)
+      chunk = std::max<int64_t>(min_chunk_, (s.ntasks - s.global_seen) / (2 * fetchers_.size()));
+    int64_t g     = NGA_Read_inc64(ga_global_, &index, chunk);
+    s.global_seen = g + chunk;
+    int64_t e     = g + chunk;
+    if(s.ntasks >= 0) {
+      if(e >= s.ntasks) s.global_done = true;
+      e = std::min(e, s.ntasks);
+      if(g >= e) return false;
+    }
+
+    // thieves only move the end field; whatever they removed from an empty
+    // word since our last observation is kept as a private range
+    int64_t widx  = word_index(rank_, index);
+    long long inc = static_cast<long long>(g - s.next) +
+                    (static_cast<long long>(e - s.end) << 32);
+    long long old = NGA_Read_inc64(ga_words_, &widx, inc);
+    int64_t d     = s.end - high(old);
+    s.next        = g;
+    s.end         = e - d;
+    s.live        = true;
+    if(d > 0) s.pending.emplace_back(std::max(g, e - d), e);
+    return true;
+  }
+
+  /// Take the upper half of another fetching rank's range; same-node ranks
+  /// first
+  bool steal(State& s, int64_t index) {
+    const int node0 = rank_ - rank_ % ppn_;
+    const int node1 = std::min(node0 + ppn_, nranks_);
+    // fetching ranks on this node are fetchers_[f0, f1)
+    const int f0 = std::lower_bound(fetchers_.begin(), fetchers_.end(), node0) - fetchers_.begin();
+    const int f1 = std::lower_bound(fetchers_.begin(), fetchers_.end(), node1) - fetchers_.begin();
+    const int me = std::lower_bound(fetchers_.begin(), fetchers_.end(), rank_) - fetchers_.begin();
+    const int nlocal  = f1 - f0;
+    const int nremote = std::min(static_cast<int>(fetchers_.size()) - nlocal, 4);
+    std::vector<int> victims;
+    for(int i = 1; i < nlocal; i++) victims.push_back(fetchers_[f0 + (me - f0 + i) % nlocal]);
+    uint64_t h = static_cast<uint64_t>(rank_) * 2654435761ULL + s.last + 1;
+    for(int i = 0; i < nremote; i++) {
+      h     = h * 6364136223846793005ULL + 1442695040888963407ULL;
+      int f = static_cast<int>((h >> 33) % (fetchers_.size() - nlocal));
+      victims.push_back(fetchers_[f < f0 ? f : f + nlocal]);
+    }
+
+    for(int v: victims) {
+      int64_t widx = word_index(v, index);
+      int64_t lidx = widx + 1;
+      if(NGA_Read_inc64(ga_words_, &lidx, 1) != 0) {
+        NGA_Read_inc64(ga_words_, &lidx, -1);
+        continue;
+      }
+      long long w;
+      NGA_Get64(ga_words_, &widx, &widx, &w, nullptr);
+      int64_t lo = std::max(low(w), s.last + 1);
+      int64_t k  = (high(w) - lo + 1) / 2;
+      int64_t b = 0, e = 0;
+      if(k > 0) {
+        // the global counter is exhausted, so the owner no longer refills and
+        // with the lock held the end field can only be moved by us: the
+        // claimed range stays above the last task returned to this rank
+        long long old = NGA_Read_inc64(ga_words_, &widx, -(static_cast<long long>(k) << 32));
+        e = high(old);
+        b = std::max(low(old), e - k);
+      }
+      NGA_Read_inc64(ga_words_, &lidx, -1);
+      if(b < e) {
+        EXPECTS(b > s.last);
+        s.pending.emplace_back(b, e);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int ga_global_;
+  int ga_words_;
+  bool allocated_;
+  int64_t num_counters_;
+  bool fetches_;
+  int64_t min_chunk_;
+  int64_t init_val_;
+  ProcGroup pg_;
+  int ga_pg_;
+  int nranks_;
+  int rank_;
+  int ppn_;
+  std::vector<int> fetchers_; // ranks that call fetch_add, sorted
+  std::vector<State> state_;
+};
+
 } // namespace tamm
 
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "tamm/tamm.hpp"
+
+#include <atomic>
+#include <fcntl.h>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+namespace tamm {
+
+/**
+ * @brief Asynchronous checkpointing of tensors to the HDF5 files read by
+ * read_from_disk.
+ *
+ * write() copies the blocks each rank owns into a staging buffer and returns;
+ * a helper thread then writes the staged blocks into the file while the
+ * caller continues. The file and its dataset are created up front with the
+ * storage allocated, so the helper thread writes raw data at known offsets
+ * with POSIX I/O and makes no MPI or HDF5 calls.
+ *
+ * Files are written under a temporary name and renamed over the previous
+ * checkpoint only once all ranks have finished, so an interrupted write
+ * never replaces a complete restart file.
+ *
+ * @tparam T Type of element in each tensor
+ */
+template<typename T>
+class AsyncCheckpoint {
+ public:
+  /**
+   * @param ec Execution context in which the tensors are allocated
+   * @param collective Use collective MPI-IO for the tensors that are written
+   * synchronously, as write_to_disk does
+   */
+  explicit AsyncCheckpoint(ExecutionContext& ec, bool collective = false):
+    ec_{ec}, collective_{collective} {}
+
+  AsyncCheckpoint(const AsyncCheckpoint&) = delete;
+  AsyncCheckpoint& operator=(const AsyncCheckpoint&) = delete;
+
+  /// Joins a pending write without committing it; call wait() to commit
+  ~AsyncCheckpoint() {
+    if(writer_.joinable()) writer_.join();
+  }
+
+  /**
+   * @brief Start writing tensors[i] to filenames[i] in the background.
+   *
+   * Waits for the previous checkpoint first. The tensors can be modified as
+   * soon as this returns. Tensors whose blocks cannot be read from the local
+   * buffer are written synchronously. Collective on the process group of
+   * @p ec.
+   */
+  void write(const std::vector<Tensor<T>>& tensors,
+             const std::vector<std::string>& filenames) {
+    EXPECTS(tensors.size() == filenames.size());
+    wait();
+
+    failed_ = false;
+    for(size_t i = 0; i < tensors.size(); i++) {
+      Tensor<T> tensor = tensors[i];
+      CheckpointFile file;
+      file.filename = filenames[i];
+      file.tmpname  = filenames[i] + ".tmp";
+
+      if(!internal::has_local_blocks(ec_, tensor)) {
+        write_to_disk(tensor, file.tmpname, true, false, 0, collective_);
+        files_.push_back(std::move(file));
+        continue;
+      }
+
+      // stage the blocks of this rank, merging runs that are contiguous in the
+      // file; block_file_offsets is in loop-nest order, so a block's file
+      // offset is found by binary search
+      const auto block_offsets = internal::block_file_offsets(tensor());
+      const hsize_t total =
+        block_offsets.empty() ? 0 :
+        block_offsets.back().offset + tensor.block_size(block_offsets.back().blockid);
+      internal::local_block_for(ec_, tensor(), [&](const IndexVector& blockid, T* buf, size_t size) {
+        auto bfo = std::lower_bound(block_offsets.begin(), block_offsets.end(), blockid,
+                                    [](const internal::BlockFileOffset& lhs, const IndexVector& rhs) {
+                                      return lhs.blockid < rhs;
+                                    });
+        EXPECTS(bfo != block_offsets.end() && bfo->blockid == blockid);
+
+        if(!file.runs.empty() &&
+           file.runs.back().file_offset + file.runs.back().size == bfo->offset)
+          file.runs.back().size += size;
+        else
+          file.runs.push_back({bfo->offset, file.data.size(), size});
+        file.data.insert(file.data.end(), buf, buf + size);
+      });
+
+      int64_t data_offset = 0;
+      if(ec_.pg().rank() == 0) data_offset = create_file(file.tmpname, total);
+      ec_.pg().broadcast(&data_offset, 0);
+      file.data_offset = data_offset;
+      // the file could not be created: nothing is written and wait() keeps
+      // the previous checkpoint
+      if(data_offset < 0) {
+        failed_ = true;
+        file.runs.clear();
+      }
+      files_.push_back(std::move(file));
+    }
+    // all snapshots are taken before any rank updates the tensors again
+    ec_.pg().barrier();
+
+    writer_ = std::thread([this]() {
+      for(auto& file: files_)
+        if(!file.runs.empty() && !write_runs(file)) failed_ = true;
+    });
+  }
+
+  /**
+   * @brief Completion fence: wait until the pending checkpoint is written on
+   * all ranks and commit it by renaming the files into place. If any rank
+   * failed to write, or a rename fails, the remaining temporary files are
+   * removed and the previous checkpoint is kept for them. Collective on the
+   * process group of @p ec.
+   *
+   * @return whether the checkpoint was committed, the same on all ranks
+   */
+  bool wait() {
+    if(files_.empty()) return true;
+    if(writer_.joinable()) writer_.join();
+
+    int failed = failed_ ? 1 : 0;
+    failed     = ec_.pg().allreduce(&failed, ReduceOp::max);
+
+    if(ec_.pg().rank() == 0) {
+      std::string error;
+      if(failed) error = "write failed";
+      for(const auto& file: files_) {
+        std::error_code ec;
+        if(failed) {
+          std::filesystem::remove(file.tmpname, ec);
+          continue;
+        }
+        std::filesystem::rename(file.tmpname, file.filename, ec);
+        if(ec) {
+          error  = "renaming " + file.tmpname + " failed: " + ec.message();
+          failed = 1;
+          std::filesystem::remove(file.tmpname, ec);
+        }
+      }
+      if(failed)
+        std::cerr << "Error writing checkpoint " << files_[0].filename << " (" << error
+                  << "), keeping the previous one for the files not renamed" << std::endl;
+      else
+        sync_dir(files_[0].filename);
+    }
+    ec_.pg().broadcast(&failed, 0);
+    files_.clear();
+    return failed == 0;
+  }
+
+ private:
+  /// Staged blocks of one file; runs are (file offset, staging offset, size)
+  /// in elements, data_offset is the byte offset of the dataset in the file
+  struct CheckpointFile {
+    struct Run {
+      hsize_t file_offset;
+      size_t  staging_offset;
+      size_t  size;
+    };
+    std::string      filename;
+    std::string      tmpname;
+    std::vector<T>   data;
+    std::vector<Run> runs;
+    int64_t          data_offset = 0;
+  };
+
+  /// Create the file with a contiguous, allocated dataset of @p total
+  /// elements as write_to_disk does, and return the dataset's byte offset,
+  /// or -1 if the file cannot be created
+  static int64_t create_file(const std::string& filename, hsize_t total) {
+    hid_t hdf5_dt = get_hdf5_dt<T>();
+    auto file_id  = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if(file_id < 0) return -1;
+
+    hsize_t dims   = std::max<hsize_t>(total, 1);
+    auto dataspace = H5Screate_simple(1, &dims, NULL);
+    auto dcpl      = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_layout(dcpl, H5D_CONTIGUOUS);
+    H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY);
+    H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER);
+    auto dataset = H5Dcreate(file_id, "tensor", hdf5_dt, dataspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+    const haddr_t offset = H5Dget_offset(dataset);
+    EXPECTS(offset != HADDR_UNDEF);
+
+    H5Dclose(dataset);
+    H5Pclose(dcpl);
+    H5Sclose(dataspace);
+    H5Fclose(file_id);
+    return static_cast<int64_t>(offset);
+  }
+
+  /// Write the staged runs of a file and flush it to storage; runs on the
+  /// helper thread
+  static bool write_runs(const CheckpointFile& file) {
+    int fd = ::open(file.tmpname.c_str(), O_WRONLY);
+    if(fd < 0) return false;
+    bool ok = true;
+    for(const auto& run: file.runs) {
+      const char* buf = reinterpret_cast<const char*>(file.data.data() + run.staging_offset);
+      size_t nbytes   = run.size * sizeof(T);
+      off_t  pos      = file.data_offset + run.file_offset * sizeof(T);
+      while(ok && nbytes > 0) {
+        const ssize_t n = ::pwrite(fd, buf, nbytes, pos);
+        if(n <= 0) ok = false;
+        else {
+          buf += n;
+          pos += n;
+          nbytes -= n;
+        }
+      }
+    }
+    if(::fsync(fd) != 0) ok = false;
+    ::close(fd);
+    return ok;
+  }
+
+  /// Flush the directory entry of a renamed file
+  static void sync_dir(const std::string& filename) {
+    auto dir = std::filesystem::path(filename).parent_path();
+    if(dir.empty()) dir = ".";
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if(fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+  }
+
+  ExecutionContext& ec_;
+  bool collective_;
+  std::vector<CheckpointFile> files_;
+  std::thread writer_;
+  std::atomic<bool> failed_{false};
+};
+
+} // namespace tamm
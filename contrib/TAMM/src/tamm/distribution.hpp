@@ -308,6 +308,57 @@ public:
         return proc_offsets_[proc.value() + 1] - proc_offsets_[proc.value()];
     }
 
+    /**
+     * @brief Calls func(blockid, offset) for each block stored on @p proc, in
+     * the order of the blocks in its buffer
+     *
+     * Only the key/offset range of @p proc is visited, so the cost does not
+     * depend on the number of blocks stored elsewhere.
+     *
+     * @param [in] proc process whose blocks are visited
+     * @param [in] func called with the block id and its offset in the buffer
+     */
+    template<typename Func>
+    void for_each_local_block(Proc proc, Func&& func) const {
+        EXPECTS(proc >= 0 && proc < nproc_);
+        const Offset lo = proc_offsets_[proc.value()];
+        const Offset hi = proc_offsets_[proc.value() + 1];
+        auto by_offset  = [](const KeyOffsetPair& hv, const Offset& v) {
+            return hv.offset_ < v;
+        };
+        auto first = std::lower_bound(hash_.begin(), hash_.end(), lo, by_offset);
+        auto last  = std::lower_bound(first, hash_.end(), hi, by_offset);
+        for(auto itr = first; itr != last; ++itr) {
+            func(block_id(itr->key_), Offset{itr->offset_ - lo});
+        }
+    }
+
+    /**
+     * @brief Whether @p other is built on the same tiled index spaces and
+     * stores the same blocks at the same offsets on every process, so that
+     * the local buffers of tensors with the two distributions line up
+     *
+     * Unlike operator==, which only compares hash values, every block is
+     * checked.
+     *
+     * @param [in] other distribution to compare with
+     */
+    bool same_layout(const Distribution_NW& other) const {
+        if(tensor_structure_ == nullptr || other.tensor_structure_ == nullptr)
+            return false;
+        if(nproc_ != other.nproc_ || total_size_ != other.total_size_ ||
+           hash_.size() != other.hash_.size() ||
+           proc_offsets_ != other.proc_offsets_)
+            return false;
+        if(tensor_structure_->tindices() != other.tensor_structure_->tindices())
+            return false;
+        return std::equal(hash_.begin(), hash_.end(), other.hash_.begin(),
+                          [](const KeyOffsetPair& lhs, const KeyOffsetPair& rhs) {
+                              return lhs.key_ == rhs.key_ &&
+                                     lhs.offset_ == rhs.offset_;
+                          });
+    }
+
     Size max_proc_buf_size() const override {
       return max_proc_buf_size_;
     }
@@ -378,6 +429,21 @@ private:
         return key;
     }
 
+    /**
+     * @brief Inverse of compute_key()
+     *
+     * @param [in] key key value of a block
+     * @returns the block id
+     */
+    IndexVector block_id(Key key) const {
+        IndexVector blockid(key_offsets_.size());
+        for(size_t i = 0; i < key_offsets_.size(); i++) {
+            blockid[i] = key / key_offsets_[i].value();
+            key %= key_offsets_[i].value();
+        }
+        return blockid;
+    }
+
     Size max_proc_buf_size_;           /**< Max buffer size on any rank */
     Size max_block_size_;              /**< Max size of any block */
     Offset total_size_;                /**< Total size of the distribution */
@@ -19,6 +19,7 @@
 #endif
 
 #include <complex>
+#include <cstddef>
 #include <numeric>
 #include <vector>
 
@@ -50,6 +51,220 @@ namespace tamm {
 
 namespace kernels {
 
+namespace detail {
+
+/**
+ * @brief Scratch space owned by the calling thread and reused across calls.
+ *
+ * Each slot grows to the largest request seen on the thread and is never
+ * shrunk, so steady-state kernel calls do not touch the heap. Buffers that
+ * are live at the same time must use different slots.
+ */
+inline void* scratch_space(size_t slot, size_t bytes) {
+    thread_local std::vector<std::vector<std::max_align_t>> slots;
+    if(slots.size() <= slot) slots.resize(slot + 1);
+    const size_t words =
+      (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    if(slots[slot].size() < words) slots[slot].resize(words);
+    return slots[slot].data();
+}
+
+template<typename T>
+T* scratch_buffer(size_t slot, size_t n) {
+    return static_cast<T*>(scratch_space(slot, n * sizeof(T)));
+}
+
+template<typename T> struct real_type { using type = T; };
+template<typename T> struct real_type<std::complex<T>> { using type = T; };
+template<typename T> using real_type_t = typename real_type<T>::type;
+
+/**
+ * @brief Check whether a block is laid out as [batch, rows, cols] (@p trans
+ * false) or [batch, cols, rows] (@p trans true), i.e. whether it can be
+ * handed to GEMM as is.
+ */
+inline bool gemm_layout(const IntLabelVec& labels, const IntLabelVec& batch,
+                        const IntLabelVec& rows, const IntLabelVec& cols,
+                        bool& trans) {
+    if(labels.size() != batch.size() + rows.size() + cols.size()) return false;
+    if(!std::equal(batch.begin(), batch.end(), labels.begin())) return false;
+    auto mid = labels.begin() + batch.size();
+    if(std::equal(rows.begin(), rows.end(), mid) &&
+       std::equal(cols.begin(), cols.end(), mid + rows.size())) {
+        trans = false;
+        return true;
+    }
+    if(std::equal(cols.begin(), cols.end(), mid) &&
+       std::equal(rows.begin(), rows.end(), mid + cols.size())) {
+        trans = true;
+        return true;
+    }
+    return false;
+}
+
+} // namespace detail
+
+/**
+ * @brief Contract blocks that are already in GEMM layout directly from the
+ * source buffers, without permuting into intermediate buffers.
+ *
+ * C must be [batch, aouter, bouter] or [batch, bouter, aouter] (the latter is
+ * computed as C^T = B^T A^T), and each operand [batch, outer, inner] or
+ * [batch, inner, outer], the transposed forms handled by Op::Trans.
+ *
+ * @return false if the layouts do not allow it; nothing is computed then
+ */
+template<typename T, typename T1>
+bool block_multiply_direct(T alpha, const T1* abuf, const IntLabelVec& alabels,
+                           const T1* bbuf, const IntLabelVec& blabels,
+                           T1* cbuf, const IntLabelVec& clabels,
+                           const IntLabelVec& batch_labels,
+                           const IntLabelVec& aouter_labels,
+                           const IntLabelVec& bouter_labels,
+                           const IntLabelVec& inner_labels, int B, int M,
+                           int N, int K, bool is_assign) {
+    bool swap_ab = false;
+    if(!detail::gemm_layout(clabels, batch_labels, aouter_labels,
+                              bouter_labels, swap_ab))
+        return false;
+
+    const T1* lbuf = swap_ab ? bbuf : abuf;
+    const T1* rbuf = swap_ab ? abuf : bbuf;
+    const IntLabelVec& llabels = swap_ab ? blabels : alabels;
+    const IntLabelVec& rlabels = swap_ab ? alabels : blabels;
+    const IntLabelVec& rows    = swap_ab ? bouter_labels : aouter_labels;
+    const IntLabelVec& cols    = swap_ab ? aouter_labels : bouter_labels;
+    const int R                = swap_ab ? N : M;
+    const int C                = swap_ab ? M : N;
+
+    bool ltrans = false, rtrans = false;
+    if(!detail::gemm_layout(llabels, batch_labels, rows, inner_labels, ltrans) ||
+       !detail::gemm_layout(rlabels, batch_labels, inner_labels, cols, rtrans))
+        return false;
+
+    const T1 beta = is_assign ? T1{0} : T1{1};
+    for(int i = 0; i < B; i++) {
+        blas::gemm(blas::Layout::RowMajor,
+                   ltrans ? blas::Op::Trans : blas::Op::NoTrans,
+                   rtrans ? blas::Op::Trans : blas::Op::NoTrans, R, C, K, alpha,
+                   lbuf + static_cast<size_t>(i) * R * K, ltrans ? R : K,
+                   rbuf + static_cast<size_t>(i) * K * C, rtrans ? K : C, beta,
+                   cbuf + static_cast<size_t>(i) * R * C, C);
+    }
+    return true;
+}
+
+/**
+ * @brief Contract blocks of mixed real and complex types with real GEMMs.
+ *
+ * A complex operand is never up-converted. When C is complex, the complex
+ * operand is permuted so that its outer index is fastest and is read as a
+ * real matrix with 2x the columns (interleaved real/imag pairs); a complex A
+ * is handled as C^T = B^T A^T so that it is always the right operand. Real
+ * operands with a complex C go through one real GEMM and are widened on the
+ * way out; a complex operand with a real C contributes its real part.
+ * Requires no reduction labels.
+ */
+template<typename T, typename T1, typename T2, typename T3>
+void block_multiply_mixed(T alpha, const T2* abuf, const SizeVec& adims,
+                          const IntLabelVec& alabels, const T3* bbuf,
+                          const SizeVec& bdims, const IntLabelVec& blabels,
+                          T1* cbuf, const SizeVec& cdims,
+                          const IntLabelVec& clabels,
+                          const IntLabelVec& batch_labels,
+                          const SizeVec& batch_dims,
+                          const IntLabelVec& aouter_labels,
+                          const SizeVec& aouter_dims,
+                          const IntLabelVec& bouter_labels,
+                          const SizeVec& bouter_dims,
+                          const IntLabelVec& inner_labels,
+                          const SizeVec& inner_dims, int B, int M, int N,
+                          int K, bool is_assign) {
+    using internal::is_complex_v;
+    using TR = detail::real_type_t<T1>;
+    static_assert(std::is_same_v<TR, detail::real_type_t<T2>> &&
+                  std::is_same_v<TR, detail::real_type_t<T3>>);
+    static_assert(is_complex_v<T1> || !(is_complex_v<T2> && is_complex_v<T3>));
+
+    constexpr bool swap_ab = is_complex_v<T1> && is_complex_v<T2>;
+    constexpr bool wide = is_complex_v<T1> && (is_complex_v<T2> || is_complex_v<T3>);
+    const int R = swap_ab ? N : M;
+    const int C = swap_ab ? M : N;
+    const int W = wide ? 2 : 1;
+
+    auto cat = [](auto v, const auto& v1, const auto& v2) {
+        v.insert(v.end(), v1.begin(), v1.end());
+        v.insert(v.end(), v2.begin(), v2.end());
+        return v;
+    };
+    const auto& row_labels = swap_ab ? bouter_labels : aouter_labels;
+    const auto& row_dims   = swap_ab ? bouter_dims : aouter_dims;
+    const auto& col_labels = swap_ab ? aouter_labels : bouter_labels;
+    const auto& col_dims   = swap_ab ? aouter_dims : bouter_dims;
+    const IntLabelVec l_labels = cat(batch_labels, row_labels, inner_labels);
+    const SizeVec l_dims       = cat(batch_dims, row_dims, inner_dims);
+    const IntLabelVec r_labels = cat(batch_labels, inner_labels, col_labels);
+    const SizeVec r_dims       = cat(batch_dims, inner_dims, col_dims);
+    const IntLabelVec p_labels = cat(batch_labels, row_labels, col_labels);
+    const SizeVec p_dims       = cat(batch_dims, row_dims, col_dims);
+
+    // permute an operand into GEMM order and return it as real data
+    auto gemm_operand = [&](const auto* src, const SizeVec& dims,
+                            const IntLabelVec& labels, const SizeVec& gdims,
+                            const IntLabelVec& glabels, size_t slot) {
+        using TS = std::remove_const_t<std::remove_pointer_t<decltype(src)>>;
+        const size_t n = std::accumulate(dims.begin(), dims.end(), Size{1},
+                                         std::multiplies<Size>()).value();
+        if constexpr(is_complex_v<TS> && !is_complex_v<T1>) {
+            TR* re = detail::scratch_buffer<TR>(3, n);
+            for(size_t i = 0; i < n; i++) re[i] = std::real(src[i]);
+            TR* dst = detail::scratch_buffer<TR>(slot, n);
+            assign<TR>(dst, gdims, glabels, TR{1}, re, dims, labels, true);
+            return static_cast<const TR*>(dst);
+        } else {
+            TS* dst = detail::scratch_buffer<TS>(slot, n);
+            assign<TS>(dst, gdims, glabels, TS{1}, src, dims, labels, true);
+            return reinterpret_cast<const TR*>(dst);
+        }
+    };
+
+    const TR* lbuf;
+    const TR* rbuf;
+    if constexpr(swap_ab) {
+        lbuf = gemm_operand(bbuf, bdims, blabels, l_dims, l_labels, 0);
+        rbuf = gemm_operand(abuf, adims, alabels, r_dims, r_labels, 1);
+    } else {
+        lbuf = gemm_operand(abuf, adims, alabels, l_dims, l_labels, 0);
+        rbuf = gemm_operand(bbuf, bdims, blabels, r_dims, r_labels, 1);
+    }
+
+    const size_t psize = static_cast<size_t>(B) * R * C * W;
+    TR* pbuf = detail::scratch_buffer<TR>(2, psize);
+    for(int i = 0; i < B; i++) {
+        blas::gemm(blas::Layout::RowMajor, blas::Op::NoTrans, blas::Op::NoTrans,
+                   R, W * C, K, TR{1}, lbuf + static_cast<size_t>(i) * R * K, K,
+                   rbuf + static_cast<size_t>(i) * K * C * W, W * C, TR{0},
+                   pbuf + static_cast<size_t>(i) * R * C * W, W * C);
+    }
+
+    T1 scale;
+    if constexpr(is_complex_v<T> && !is_complex_v<T1>) scale = std::real(alpha);
+    else scale = static_cast<T1>(alpha);
+
+    if constexpr(wide) {
+        assign<T1>(cbuf, cdims, clabels, scale, reinterpret_cast<const T1*>(pbuf),
+                   p_dims, p_labels, is_assign);
+    } else if constexpr(is_complex_v<T1>) {
+        TR* cperm = detail::scratch_buffer<TR>(3, psize);
+        assign<TR>(cperm, cdims, clabels, TR{1}, pbuf, p_dims, p_labels, true);
+        for(size_t i = 0; i < psize; i++) {
+            cbuf[i] = (is_assign ? T1{0} : cbuf[i]) + scale * cperm[i];
+        }
+    } else {
+        assign<T1>(cbuf, cdims, clabels, scale, pbuf, p_dims, p_labels, is_assign);
+    }
+}
+
 template<typename T, typename T1, typename T2, typename T3>
 void block_multiply(bool &isgpuOp,
         #ifdef USE_TALSH
@@ -202,25 +417,56 @@ void block_multiply(bool &isgpuOp,
     int areduce_ld = B * abatch_ld;
     int breduce_ld = B * bbatch_ld;
 
+  bool host_gemm = (AR == 1 && BR == 1);
+#ifdef USE_DPCPP
+  host_gemm = host_gemm && hw != ExecutionHW::GPU;
+#endif
+
   auto bmult_cpu_lambda = [&](){
-    std::vector<T2> ainter_buf(static_cast<size_t>(asize.value()));
-    std::vector<T3> binter_buf(static_cast<size_t>(bsize.value()));
-    std::vector<T1> cinter_buf(static_cast<size_t>(csize.value()));
-    assign<T2>(ainter_buf.data(), ainter_dims, ainter_labels, T2{1}, abuf, adims,
+    if constexpr(std::is_same_v<T1,T2> && std::is_same_v<T1,T3>) {
+      if(host_gemm &&
+         block_multiply_direct(alpha, abuf, alabels, bbuf, blabels, cbuf,
+                               clabels, batch_labels, aouter_labels,
+                               bouter_labels, inner_labels, B, M, N, K,
+                               is_assign))
+          return;
+    }
+    else if constexpr(std::is_same_v<detail::real_type_t<T1>, detail::real_type_t<T2>> &&
+                      std::is_same_v<detail::real_type_t<T1>, detail::real_type_t<T3>> &&
+                      (internal::is_complex_v<T1> ||
+                       !(internal::is_complex_v<T2> && internal::is_complex_v<T3>))) {
+      if(host_gemm) {
+        block_multiply_mixed(alpha, abuf, adims, alabels, bbuf, bdims, blabels,
+                             cbuf, cdims, clabels, batch_labels, batch_dims,
+                             aouter_labels, aouter_dims, bouter_labels,
+                             bouter_dims, inner_labels, inner_dims, B, M, N, K,
+                             is_assign);
+        return;
+      }
+    }
+
+    const size_t ainter_size = static_cast<size_t>(asize.value());
+    const size_t binter_size = static_cast<size_t>(bsize.value());
+    const size_t cinter_size = static_cast<size_t>(csize.value());
+    T2* ainter_buf = detail::scratch_buffer<T2>(0, ainter_size);
+    T3* binter_buf = detail::scratch_buffer<T3>(1, binter_size);
+    T1* cinter_buf = detail::scratch_buffer<T1>(2, cinter_size);
+    std::fill(cinter_buf, cinter_buf + cinter_size, T1{0});
+    assign<T2>(ainter_buf, ainter_dims, ainter_labels, T2{1}, abuf, adims,
            alabels, true);
-    assign<T3>(binter_buf.data(), binter_dims, binter_labels, T3{1}, bbuf, bdims,
+    assign<T3>(binter_buf, binter_dims, binter_labels, T3{1}, bbuf, bdims,
            blabels, true);
 #ifdef USE_DPCPP
   T2* ainter_buf_dev; T3* binter_buf_dev;  T1* cinter_buf_dev;
   if(hw == ExecutionHW::GPU) {
-    ainter_buf_dev = sycl::malloc_device<T2>(ainter_buf.size(), *dev_queue);
-    binter_buf_dev = sycl::malloc_device<T3>(binter_buf.size(), *dev_queue);
-    cinter_buf_dev = sycl::malloc_device<T1>(cinter_buf.size(), *dev_queue);
+    ainter_buf_dev = sycl::malloc_device<T2>(ainter_size, *dev_queue);
+    binter_buf_dev = sycl::malloc_device<T3>(binter_size, *dev_queue);
+    cinter_buf_dev = sycl::malloc_device<T1>(cinter_size, *dev_queue);
 
     // host-->device copy
-    dev_queue->memcpy(ainter_buf_dev, ainter_buf.data(), ainter_buf.size()*sizeof(T2)).wait();
-    dev_queue->memcpy(binter_buf_dev, binter_buf.data(), binter_buf.size()*sizeof(T3)).wait();
-    dev_queue->memcpy(cinter_buf_dev, cinter_buf.data(), cinter_buf.size()*sizeof(T1)).wait();
+    dev_queue->memcpy(ainter_buf_dev, ainter_buf, ainter_size*sizeof(T2)).wait();
+    dev_queue->memcpy(binter_buf_dev, binter_buf, binter_size*sizeof(T3)).wait();
+    dev_queue->memcpy(cinter_buf_dev, cinter_buf, cinter_size*sizeof(T1)).wait();
   }
 #endif
 
@@ -246,19 +492,19 @@ void block_multiply(bool &isgpuOp,
                 else {
                   blas::gemm(blas::Layout::RowMajor,
                              transA, transB, M, N, K, alpha,
-                             ainter_buf.data() + ari * areduce_ld + i * abatch_ld,
+                             ainter_buf + ari * areduce_ld + i * abatch_ld,
                              ainter_ld,
-                             binter_buf.data() + bri * breduce_ld + i * bbatch_ld,
-                             binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                             binter_buf + bri * breduce_ld + i * bbatch_ld,
+                             binter_ld, beta, cinter_buf + i * cbatch_ld,
                              cinter_ld);
                 }
 #else
                   blas::gemm(blas::Layout::RowMajor,
                     transA, transB, M, N, K, alpha,
-                    ainter_buf.data() + ari * areduce_ld + i * abatch_ld,
+                    ainter_buf + ari * areduce_ld + i * abatch_ld,
                     ainter_ld,
-                    binter_buf.data() + bri * breduce_ld + i * bbatch_ld,
-                    binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                    binter_buf + bri * breduce_ld + i * bbatch_ld,
+                    binter_ld, beta, cinter_buf + i * cbatch_ld,
                     cinter_ld);
 #endif
               }
@@ -267,7 +513,7 @@ void block_multiply(bool &isgpuOp,
 #ifdef USE_DPCPP
       // device-->host copy
       if(hw == ExecutionHW::GPU) {
-        dev_queue->memcpy(cinter_buf.data(), cinter_buf_dev, cinter_buf.size()*sizeof(T1)).wait();
+        dev_queue->memcpy(cinter_buf, cinter_buf_dev, cinter_size*sizeof(T1)).wait();
       }
 #endif
       }
@@ -281,9 +527,9 @@ void block_multiply(bool &isgpuOp,
           std::vector<T1> bbuf_complex(bsize.value());
           T3* bbuf_comp_ptr = reinterpret_cast<T3*>(&bbuf_complex[0]);
           if constexpr(std::is_same_v<T3,double>)
-            bli_dcopyv(BLIS_NO_CONJUGATE,bsize.value(),&binter_buf[0],1,bbuf_comp_ptr,2);
+            bli_dcopyv(BLIS_NO_CONJUGATE,bsize.value(),binter_buf,1,bbuf_comp_ptr,2);
           else if constexpr(std::is_same_v<T3,float>)
-            bli_scopyv(BLIS_NO_CONJUGATE,bsize.value(),&binter_buf[0],1,bbuf_comp_ptr,2);
+            bli_scopyv(BLIS_NO_CONJUGATE,bsize.value(),binter_buf,1,bbuf_comp_ptr,2);
 #ifdef USE_DPCPP
           T1* bbuf_complex_dev;
           if(hw == ExecutionHW::GPU) {
@@ -308,19 +554,19 @@ void block_multiply(bool &isgpuOp,
     else {
                 blas::gemm(blas::Layout::RowMajor,
                   transA, transB, M, N, K, alpha,
-                  ainter_buf.data() + ari * areduce_ld + i * abatch_ld,
+                  ainter_buf + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
                   bbuf_complex.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);      
     }
 #else
                 blas::gemm(blas::Layout::RowMajor,
                   transA, transB, M, N, K, alpha,
-                  ainter_buf.data() + ari * areduce_ld + i * abatch_ld,
+                  ainter_buf + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
                   bbuf_complex.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);
 #endif
               }
@@ -329,13 +575,13 @@ void block_multiply(bool &isgpuOp,
 #ifdef USE_DPCPP
           // device-->host copy
           if(hw == ExecutionHW::GPU) 
-            dev_queue->memcpy(cinter_buf.data(), cinter_buf_dev, cinter_buf.size()*sizeof(T1)).wait();
+            dev_queue->memcpy(cinter_buf, cinter_buf_dev, cinter_size*sizeof(T1)).wait();
 #endif
         } //is_complex<T1>
         else {
           //T1,T2 (C,A) are real, T3 (B) is complex
           std::vector<T1> bbuf_real(bsize.value());
-          T1* bbuf_comp_ptr = reinterpret_cast<T1*>(&binter_buf[0]);
+          T1* bbuf_comp_ptr = reinterpret_cast<T1*>(binter_buf);
           if constexpr(std::is_same_v<T1,double>)
             bli_dcopyv(BLIS_NO_CONJUGATE,bsize.value(),bbuf_comp_ptr,2,&bbuf_real[0],1);
           else if constexpr(std::is_same_v<T1,float>)
@@ -364,19 +610,19 @@ void block_multiply(bool &isgpuOp,
     else {
                 blas::gemm(blas::Layout::RowMajor,
                   transA, transB, M, N, K, alpha,
-                  ainter_buf.data() + ari * areduce_ld + i * abatch_ld,
+                  ainter_buf + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
                   bbuf_real.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);      
     }
 #else
                 blas::gemm(blas::Layout::RowMajor,
                   transA, transB, M, N, K, alpha,
-                  ainter_buf.data() + ari * areduce_ld + i * abatch_ld,
+                  ainter_buf + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
                   bbuf_real.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);
 #endif
               }
@@ -385,7 +631,7 @@ void block_multiply(bool &isgpuOp,
 #ifdef USE_DPCPP
           // device-->host copy
           if(hw == ExecutionHW::GPU)
-            dev_queue->memcpy(cinter_buf.data(), cinter_buf_dev, cinter_buf.size()*sizeof(T1)).wait();
+            dev_queue->memcpy(cinter_buf, cinter_buf_dev, cinter_size*sizeof(T1)).wait();
 #endif
         } //is_real<T1>
 
@@ -396,9 +642,9 @@ void block_multiply(bool &isgpuOp,
           std::vector<T1> abuf_complex(asize.value());
           T2* abuf_comp_ptr = reinterpret_cast<T2*>(&abuf_complex[0]);
           if constexpr(std::is_same_v<T2,double>)
-            bli_dcopyv(BLIS_NO_CONJUGATE,asize.value(),&ainter_buf[0],1,abuf_comp_ptr,2);
+            bli_dcopyv(BLIS_NO_CONJUGATE,asize.value(),ainter_buf,1,abuf_comp_ptr,2);
           else if constexpr(std::is_same_v<T2,float>)
-            bli_scopyv(BLIS_NO_CONJUGATE,asize.value(),&ainter_buf[0],1,abuf_comp_ptr,2);
+            bli_scopyv(BLIS_NO_CONJUGATE,asize.value(),ainter_buf,1,abuf_comp_ptr,2);
 #ifdef USE_DPCPP
           T1* abuf_complex_dev;
           if(hw == ExecutionHW::GPU) {
@@ -425,8 +671,8 @@ void block_multiply(bool &isgpuOp,
             transA, transB, M, N, K, alpha,
             abuf_complex.data() + ari * areduce_ld + i * abatch_ld,
             ainter_ld,
-            binter_buf.data() + bri * breduce_ld + i * bbatch_ld,
-            binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+            binter_buf + bri * breduce_ld + i * bbatch_ld,
+            binter_ld, beta, cinter_buf + i * cbatch_ld,
             cinter_ld);      
     }
 #else
@@ -434,8 +680,8 @@ void block_multiply(bool &isgpuOp,
                   transA, transB, M, N, K, alpha,
                   abuf_complex.data() + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
-                  binter_buf.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_buf + bri * breduce_ld + i * bbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);
 #endif
               }
@@ -444,13 +690,13 @@ void block_multiply(bool &isgpuOp,
 #ifdef USE_DPCPP
         // device-->host copy
         if(hw == ExecutionHW::GPU)
-          dev_queue->memcpy(cinter_buf.data(), cinter_buf_dev, cinter_buf.size()*sizeof(T1)).wait();
+          dev_queue->memcpy(cinter_buf, cinter_buf_dev, cinter_size*sizeof(T1)).wait();
 #endif
         }
         else{
           //T1,T3 (C,B) are real, T2 (A) is complex
           std::vector<T1> abuf_real(asize.value());
-          T1* abuf_comp_ptr = reinterpret_cast<T1*>(&ainter_buf[0]);
+          T1* abuf_comp_ptr = reinterpret_cast<T1*>(ainter_buf);
           if constexpr(std::is_same_v<T1,double>)
             bli_dcopyv(BLIS_NO_CONJUGATE,asize.value(),abuf_comp_ptr,2,&abuf_real[0],1);
           else if constexpr(std::is_same_v<T1,float>)
@@ -481,8 +727,8 @@ void block_multiply(bool &isgpuOp,
                   transA, transB, M, N, K, alpha,
                   abuf_real.data() + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
-                  binter_buf.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_buf + bri * breduce_ld + i * bbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);      
     }
 #else
@@ -490,8 +736,8 @@ void block_multiply(bool &isgpuOp,
                   transA, transB, M, N, K, alpha,
                   abuf_real.data() + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
-                  binter_buf.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_buf + bri * breduce_ld + i * bbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);
 #endif
               }
@@ -500,7 +746,7 @@ void block_multiply(bool &isgpuOp,
 #ifdef USE_DPCPP
         // device-->host copy
         if(hw == ExecutionHW::GPU)
-          dev_queue->memcpy(cinter_buf.data(), cinter_buf_dev, cinter_buf.size()*sizeof(T1)).wait();
+          dev_queue->memcpy(cinter_buf, cinter_buf_dev, cinter_size*sizeof(T1)).wait();
 #endif
         }
 
@@ -514,12 +760,12 @@ void block_multiply(bool &isgpuOp,
           T2* bbuf_comp_ptr = reinterpret_cast<T2*>(&bbuf_complex[0]);
 
           if constexpr(std::is_same_v<T2,double>) {
-            bli_dcopyv(BLIS_NO_CONJUGATE,asize.value(),&ainter_buf[0],1,abuf_comp_ptr,2);
-            bli_dcopyv(BLIS_NO_CONJUGATE,bsize.value(),&binter_buf[0],1,bbuf_comp_ptr,2);
+            bli_dcopyv(BLIS_NO_CONJUGATE,asize.value(),ainter_buf,1,abuf_comp_ptr,2);
+            bli_dcopyv(BLIS_NO_CONJUGATE,bsize.value(),binter_buf,1,bbuf_comp_ptr,2);
           }
           else if constexpr(std::is_same_v<T2,float>) {
-            bli_scopyv(BLIS_NO_CONJUGATE,asize.value(),&ainter_buf[0],1,abuf_comp_ptr,2);
-            bli_scopyv(BLIS_NO_CONJUGATE,bsize.value(),&binter_buf[0],1,bbuf_comp_ptr,2);
+            bli_scopyv(BLIS_NO_CONJUGATE,asize.value(),ainter_buf,1,abuf_comp_ptr,2);
+            bli_scopyv(BLIS_NO_CONJUGATE,bsize.value(),binter_buf,1,bbuf_comp_ptr,2);
           }
 #ifdef USE_DPCPP
     T1* abuf_complex_dev; T2* bbuf_complex_dev;
@@ -551,7 +797,7 @@ void block_multiply(bool &isgpuOp,
                   abuf_complex.data() + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
                   bbuf_complex.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);      
     }
 #else
@@ -560,7 +806,7 @@ void block_multiply(bool &isgpuOp,
                   abuf_complex.data() + ari * areduce_ld + i * abatch_ld,
                   ainter_ld,
                   bbuf_complex.data() + bri * breduce_ld + i * bbatch_ld,
-                  binter_ld, beta, cinter_buf.data() + i * cbatch_ld,
+                  binter_ld, beta, cinter_buf + i * cbatch_ld,
                   cinter_ld);
 #endif
               }
@@ -569,7 +815,7 @@ void block_multiply(bool &isgpuOp,
 #ifdef USE_DPCPP
       // device-->host copy
       if(hw == ExecutionHW::GPU)
-        dev_queue->memcpy(cinter_buf.data(), cinter_buf_dev, cinter_buf.size()*sizeof(T1)).wait();
+        dev_queue->memcpy(cinter_buf, cinter_buf_dev, cinter_size*sizeof(T1)).wait();
 #endif
       }
 
@@ -586,7 +832,7 @@ void block_multiply(bool &isgpuOp,
     }
 #endif
 
-    assign<T1>(cbuf, cdims, clabels, T{1}, cinter_buf.data(), cinter_dims,
+    assign<T1>(cbuf, cdims, clabels, T{1}, cinter_buf, cinter_dims,
            cinter_labels, is_assign);
     };
     #ifndef USE_TALSH
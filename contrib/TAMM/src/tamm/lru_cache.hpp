@@ -1,95 +1,251 @@
 #pragma once
 
-#include <map>
+#include "tamm/errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <unordered_map>
 #include <vector>
-#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace tamm {
 
-template <typename KeyEl, typename Value>
+/**
+ * @brief LRU cache of values keyed by short index tuples.
+ *
+ * Keys are stored as fixed-size arrays of up to @p MaxKeyLen elements and
+ * looked up in a hash map; entries are linked in an intrusive LRU list over
+ * a node pool that is reused after eviction, so a lookup is O(1) and does not
+ * allocate once the pool has grown. The capacity is in bytes of cached
+ * values; the values returned by the two most recent accesses of a shard
+ * are never evicted.
+ *
+ * The cache can be split into shards with separate capacity and LRU order.
+ * Inside an OpenMP parallel region each thread uses the shard of its thread
+ * number, so threads can use the cache concurrently without locking.
+ *
+ * @tparam KeyEl Type of the key elements
+ * @tparam Value Type of the cached values
+ * @tparam MaxKeyLen Maximum number of elements in a key
+ */
+template <typename KeyEl, typename Value, size_t MaxKeyLen = 6>
 class LRUCache {
  public:
- using Key = std::vector<KeyEl>;
-  LRUCache(uint32_t max_size) : max_size_{max_size} { }
+  using Key = std::array<KeyEl, MaxKeyLen>;
 
-  void reset_clock() { cycle_ = 0; }
+  /**
+   * @brief Construct an empty cache.
+   * @param max_bytes Capacity in bytes of cached values, split among shards;
+   *        0 disables caching
+   * @param nshards Number of shards
+   */
+  LRUCache(size_t max_bytes, uint32_t nshards = 1)
+      : max_bytes_{max_bytes},
+        shards_(std::max(nshards, 1u)) { }
 
-  uint32_t max_size() const { return max_size_; }
+  size_t max_bytes() const { return max_bytes_; }
+
+  /**
+   * @brief Look up a key, inserting it on a miss.
+   *
+   * On a miss the returned value is empty (default-constructed) and is
+   * expected to be filled by the caller. The reference stays valid until the
+   * second next access of the same shard.
+   * @return Whether the key was cached, and its value
+   */
+  std::pair<bool, Value&> log_access(std::initializer_list<KeyEl> key) {
+    return log_access(make_key(key.begin(), key.end()));
+  }
+
+  std::pair<bool, Value&> log_access(const std::vector<KeyEl>& key) {
+    return log_access(make_key(key.begin(), key.end()));
+  }
 
   std::pair<bool, Value&> log_access(const Key& key) {
-    bool hit = false;
-    if (max_size_ == 0) {
-      clear(); // "hack" to disable cache
+    Shard& s = shard();
+    settle(s);
+    if(max_bytes_ == 0) clear(s); // "hack" to disable cache
+
+    ++s.cycle;
+    auto it = s.index.find(key);
+    if(it != s.index.end()) {
+      Node& n = s.nodes[it->second];
+      ++s.histogram[log2_bin(s.cycle - n.cycle)];
+      n.cycle = s.cycle;
+      unlink(s, it->second);
+      push_front(s, it->second);
+      return {true, n.value};
     }
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
-      // hit
-      hit = true;
-      auto c2k_it = cycle_to_key_.find(it->second);
-      //EXPECTS(c2k_it != cycle_to_key_.end());      
-      auto dist = std::distance(c2k_it, cycle_to_key_.end());
-      ++reuse_distance_histogram_[dist-1];
-      cycle_to_key_.erase(c2k_it);
-      // it->second = cycle_;
-      cache_.erase(it); 
-      // cache_[key] = cycle_;
-      // cycle_to_key_[cycle_] = key;
-      cache_.insert({key,cycle_});
-      cycle_to_key_.insert({cycle_,key});
-    } else {  // miss
-      hit = false;
-      ++reuse_distance_histogram_[max_size_];
-      if (cache_.size() == max_size_ && max_size_ > 0) {   // eviction
-        auto c2k_it = cycle_to_key_.begin();  // oldest entry
-        cache_.erase(c2k_it->second);
-        cached_value_.erase(c2k_it->second);
-        cycle_to_key_.erase(c2k_it);
-      }
-      // cycle_to_key_[cycle_] = key;
-      // cache_[key] = cycle_;
-      cycle_to_key_.insert({cycle_,key});
-      cache_.insert({key,cycle_});
+
+    ++s.histogram.back();
+    uint32_t id;
+    if(!s.free.empty()) {
+      id = s.free.back();
+      s.free.pop_back();
+    } else {
+      id = static_cast<uint32_t>(s.nodes.size());
+      s.nodes.emplace_back();
     }
-    ++cycle_;
-    return {hit, cached_value_[key]};
+    Node& n = s.nodes[id];
+    n.key   = key;
+    n.bytes = 0;
+    n.cycle = s.cycle;
+    s.index.emplace(key, id);
+    push_front(s, id);
+    return {false, n.value};
   }
 
-  Value& access(const Key& key) {
-    EXPECTS(cached_value_.find(key) != cached_value_.end());
-    return *cached_value_.find(key);
+  /**
+   * @brief Value of a cached key, without updating the LRU order.
+   * @pre The key is cached in the shard of the calling thread
+   */
+  Value& access(const std::vector<KeyEl>& key) {
+    Shard& s = shard();
+    auto it  = s.index.find(make_key(key.begin(), key.end()));
+    EXPECTS(it != s.index.end());
+    return s.nodes[it->second].value;
   }
 
-  const Value& access(const Key& key) const {
-    EXPECTS(cached_value_.find(key) != cached_value_.end());
-    return *cached_value_.find(key);
+  /**
+   * @brief Append the reuse distance histogram, summed over shards.
+   *
+   * Element i counts hits whose previous access of the key was between 2^i
+   * and 2^(i+1)-1 accesses earlier; the last element counts misses.
+   */
+  void gather_stats(std::vector<size_t>& vec) const {
+    std::vector<size_t> sum(nbins + 1, 0);
+    for(const auto& s: shards_)
+      for(size_t i = 0; i <= nbins; i++) sum[i] += s.histogram[i];
+    vec.insert(vec.end(), sum.begin(), sum.end());
   }
 
-  void gather_stats(std::vector<uint32_t>& vec) {
-    for (uint32_t i = 0; i <= max_size_; i++) {
-      vec.push_back(reuse_distance_histogram_[i]);
-    }
+  void reset_stats() {
+    for(auto& s: shards_) std::fill(s.histogram.begin(), s.histogram.end(), 0);
   }
 
   void clear() {
-    cache_.clear();
-    cycle_to_key_.clear();
-    cached_value_.clear();
+    for(auto& s: shards_) clear(s);
   }
 
  private:
-  template <typename T>
-  struct KeyComp {
-    bool operator()(const std::vector<T>& v1, const std::vector<T>& v2) const {
-      return std::lexicographical_compare(v1.begin(), v1.end(), v2.begin(),
-                                          v2.end());
+  static constexpr uint32_t nil   = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t   nbins = 64;
+
+  struct Node {
+    Key      key;
+    Value    value;
+    size_t   bytes = 0;
+    uint64_t cycle = 0;
+    uint32_t prev  = nil;
+    uint32_t next  = nil;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      uint64_t h = 14695981039346656037ULL;
+      for(const auto& k: key) h = (h ^ static_cast<uint64_t>(k)) * 1099511628211ULL;
+      return static_cast<size_t>(h ^ (h >> 29));
     }
   };
-  uint32_t max_size_;
-  uint32_t cycle_;
-  std::map<Key, uint32_t, KeyComp<KeyEl>> cache_;
-  std::map<uint32_t, Key> cycle_to_key_;
-  std::map<Key, Value> cached_value_;
-  std::map<uint32_t, uint32_t> reuse_distance_histogram_;
+
+  struct Shard {
+    std::deque<Node>      nodes; // stable addresses for returned references
+    std::vector<uint32_t> free;
+    std::unordered_map<Key, uint32_t, KeyHash> index;
+    uint32_t head = nil;
+    uint32_t tail = nil;
+    size_t   bytes = 0;
+    uint64_t cycle = 0;
+    std::vector<size_t> histogram = std::vector<size_t>(nbins + 1, 0);
+  };
+
+  template <typename It>
+  static Key make_key(It first, It last) {
+    EXPECTS(static_cast<size_t>(std::distance(first, last)) <= MaxKeyLen);
+    Key key;
+    key.fill(std::numeric_limits<KeyEl>::max());
+    std::copy(first, last, key.begin());
+    return key;
+  }
+
+  static size_t log2_bin(uint64_t dist) {
+    size_t bin = 0;
+    while(dist >>= 1) bin++;
+    return bin;
+  }
+
+  template <typename V>
+  static size_t value_bytes(const V&) { return sizeof(V); }
+
+  template <typename T, typename A>
+  static size_t value_bytes(const std::vector<T, A>& v) {
+    return sizeof(v) + v.capacity() * sizeof(T);
+  }
+
+  Shard& shard() {
+#ifdef _OPENMP
+    if(shards_.size() > 1) return shards_[omp_get_thread_num() % shards_.size()];
+#endif
+    return shards_[0];
+  }
+
+  void unlink(Shard& s, uint32_t id) {
+    Node& n = s.nodes[id];
+    if(n.prev != nil) s.nodes[n.prev].next = n.next;
+    else s.head = n.next;
+    if(n.next != nil) s.nodes[n.next].prev = n.prev;
+    else s.tail = n.prev;
+    n.prev = n.next = nil;
+  }
+
+  void push_front(Shard& s, uint32_t id) {
+    Node& n = s.nodes[id];
+    n.prev  = nil;
+    n.next  = s.head;
+    if(s.head != nil) s.nodes[s.head].prev = id;
+    s.head = id;
+    if(s.tail == nil) s.tail = id;
+  }
+
+  /// Account the size of the last accessed value, which the caller may have
+  /// filled, and evict from the tail while over capacity
+  void settle(Shard& s) {
+    if(s.head == nil) return;
+    Node& h = s.nodes[s.head];
+    s.bytes -= h.bytes;
+    h.bytes = value_bytes(h.value);
+    s.bytes += h.bytes;
+
+    const size_t cap = max_bytes_ / shards_.size();
+    while(s.bytes > cap && s.index.size() > 2) {
+      uint32_t id = s.tail;
+      Node&    n  = s.nodes[id];
+      unlink(s, id);
+      s.index.erase(n.key);
+      s.bytes -= n.bytes;
+      n.bytes = 0;
+      n.value = Value{};
+      s.free.push_back(id);
+    }
+  }
+
+  void clear(Shard& s) {
+    s.nodes.clear();
+    s.free.clear();
+    s.index.clear();
+    s.head = s.tail = nil;
+    s.bytes = 0;
+  }
+
+  size_t max_bytes_;
+  std::vector<Shard> shards_;
 };  // class LRUCache
 }  // namespace tamm
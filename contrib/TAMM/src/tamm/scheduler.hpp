@@ -1,6 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
 #include <set>
+#include <thread>
 
 #include "ga/ga-mpi.h"
 #include "tamm/dag_impl.hpp"
@@ -13,6 +18,191 @@ namespace tamm {
 
 using internal::DAGImpl;
 
+namespace internal {
+
+/**
+ * @brief Wait until counter @p index of @p ac reaches @p target.
+ *
+ * Polls with a plain get and backs off exponentially between polls, so that
+ * ranks waiting on the same op do not keep the owner of the counter busy.
+ */
+inline void wait_for_counter(AtomicCounterGA& ac, int64_t index, int64_t target) {
+    std::chrono::microseconds delay{1};
+    constexpr std::chrono::microseconds max_delay{256};
+    while(ac.read(index) < target) {
+        std::this_thread::sleep_for(delay);
+        delay = std::min(2 * delay, max_delay);
+    }
+}
+
+} // namespace internal
+
+/**
+ * @brief A list of operations captured once from a Scheduler and executed
+ * repeatedly.
+ *
+ * The dependency graph and level order are computed when the plan is built,
+ * and the atomic counters used to hand out tasks are kept across executions
+ * and only reset. Tensors allocated in the captured list stay allocated for
+ * the lifetime of the plan; their deallocations run when the plan is
+ * destroyed, or earlier in release(). Destruction is collective on the
+ * process group of the plan, like the deallocations it runs.
+ *
+ * Tensors used by the plan can be rebound for a single execution with bind():
+ * the storage of the bound tensor is swapped in for the duration of the run.
+ * @ingroup operations
+ */
+class ExecutionPlan {
+public:
+    ExecutionPlan()                     = default;
+    ExecutionPlan(const ExecutionPlan&) = delete;
+    ExecutionPlan(ExecutionPlan&&)      = default;
+    ExecutionPlan& operator=(const ExecutionPlan&) = delete;
+    ExecutionPlan& operator=(ExecutionPlan&& other) {
+        if(this != &other) {
+            release();
+            ec_       = other.ec_;
+            ops_      = std::move(other.ops_);
+            order_    = std::move(other.order_);
+            deps_     = std::move(other.deps_);
+            deallocs_ = std::move(other.deallocs_);
+            bindings_ = std::move(other.bindings_);
+            ac_       = std::move(other.ac_);
+            done_ac_  = std::move(other.done_ac_);
+            async_    = other.async_;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Construct a plan from ops that are already in dependency order.
+     *
+     * @param [in] ec execution context the plan runs on
+     * @param [in] ops compute ops (no allocations or deallocations)
+     * @param [in] order (level, op index) pairs sorted by level
+     * @param [in] deps immediate predecessors of each op
+     * @param [in] deallocs deallocations deferred to the end of the plan
+     */
+    ExecutionPlan(ExecutionContext& ec, std::vector<std::shared_ptr<Op>> ops,
+                  std::vector<std::pair<size_t, size_t>> order,
+                  std::vector<std::vector<size_t>> deps,
+                  std::vector<std::shared_ptr<Op>> deallocs) :
+      ec_{&ec},
+      ops_{std::move(ops)},
+      order_{std::move(order)},
+      deps_{std::move(deps)},
+      deallocs_{std::move(deallocs)} {
+        EXPECTS(order_.size() == ops_.size() && deps_.size() == ops_.size());
+        // ac_ hands out the tasks of each op, done_ac_ counts the ranks that
+        // finished it
+        ac_ = std::make_unique<AtomicCounterChunked>(ec_->pg(), ops_.size());
+        ac_->allocate(0);
+        done_ac_ = std::make_unique<AtomicCounterGA>(ec_->pg(), ops_.size());
+        done_ac_->allocate(0);
+    }
+
+    ~ExecutionPlan() {
+        // GA may already be finalized when a plan outlives the run
+        if(ac_ == nullptr || !GA_Initialized()) return;
+        try {
+            release();
+        } catch(...) {
+            std::cerr << "ExecutionPlan: failed to release the plan" << std::endl;
+        }
+    }
+
+    size_t size() const { return ops_.size(); }
+
+    /**
+     * @brief Make execute() run without barriers between dependency levels.
+     */
+    ExecutionPlan& async(bool enable = true) {
+        async_ = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Use the storage of @p tensor in place of @p slot for the next
+     * execute().
+     *
+     * Both tensors must be allocated over the same tiled index spaces.
+     */
+    template<typename T>
+    ExecutionPlan& bind(Tensor<T> slot, Tensor<T> tensor) {
+        bindings_.push_back([slot, tensor]() mutable { slot.swap_storage(tensor); });
+        return *this;
+    }
+
+    void execute(ExecutionHW execute_on = ExecutionHW::CPU) {
+        EXPECTS(ac_ != nullptr);
+        for(auto& b : bindings_) b();
+
+        const size_t nops    = ops_.size();
+        const int64_t nranks = ec_->pg().size().value();
+        ac_->reset(0);
+        done_ac_->reset(0);
+
+        std::vector<bool> done(nops, false);
+        size_t lvl = 0;
+        for(size_t i = 0; i < nops; i++) {
+            const size_t op_id = order_[i].second;
+            if(async_) {
+                for(auto d : deps_[op_id]) {
+                    if(done[d]) continue;
+                    internal::wait_for_counter(*done_ac_, d, nranks);
+                    done[d] = true;
+                }
+            } else if(order_[i].first != lvl) {
+                EXPECTS(order_[i].first == lvl + 1);
+                ec_->pg().barrier();
+                lvl += 1;
+            }
+
+            ec_->set_ac(IndexedAC(ac_.get(), op_id));
+            if(ops_[op_id]->exhw_ != ExecutionHW::DEFAULT)
+                execute_on = ops_[op_id]->exhw_;
+            if(async_) {
+                GA_Init_fence();
+                ops_[op_id]->execute(*ec_, execute_on);
+                GA_Fence();
+                done_ac_->fetch_add(op_id, 1);
+            } else {
+                ops_[op_id]->execute(*ec_, execute_on);
+            }
+        }
+
+        ec_->pg().barrier();
+        ec_->set_ac(IndexedAC(nullptr, 0));
+        for(auto& b : bindings_) b();
+        bindings_.clear();
+    }
+
+    /**
+     * @brief Run the deferred deallocations and free the counters before
+     * the plan goes out of scope. Called by the destructor otherwise.
+     */
+    void release() {
+        if(ac_ == nullptr) return;
+        for(auto& op : deallocs_) op->execute(*ec_);
+        deallocs_.clear();
+        ac_->deallocate();
+        ac_.reset();
+        done_ac_->deallocate();
+        done_ac_.reset();
+    }
+
+private:
+    ExecutionContext* ec_ = nullptr;
+    std::vector<std::shared_ptr<Op>> ops_;
+    std::vector<std::pair<size_t, size_t>> order_;
+    std::vector<std::vector<size_t>> deps_;
+    std::vector<std::shared_ptr<Op>> deallocs_;
+    std::vector<std::function<void()>> bindings_;
+    std::unique_ptr<AtomicCounterChunked> ac_;
+    std::unique_ptr<AtomicCounterGA> done_ac_;
+    bool async_ = false;
+}; // class ExecutionPlan
+
 /**
  * @brief Scheduler to execute a list of operations.
  * @ingroup operations
@@ -154,35 +344,173 @@ public:
         return has_dependence(R1, W1, A1, R2, W2, A2);
     }
 
+    /**
+     * @brief Immediate predecessors of each op in [start_id, end_id), in one pass
+     * over the ops.
+     *
+     * Per tensor we track the last writer, the accumulates and the reads since
+     * then. Accumulates into the same tensor do not depend on each other. Ops
+     * that conflict only through an older writer are covered transitively.
+     *
+     * @return for each op, the (start_id-relative) indices of the ops it depends on
+     */
+    std::vector<std::vector<size_t>> op_dependencies(
+      const std::vector<std::shared_ptr<Op>>& ops, size_t start_id,
+      size_t end_id) {
+        EXPECTS(start_id >= 0 && start_id <= ops.size());
+        EXPECTS(end_id >= start_id && end_id <= ops.size());
+
+        struct TensorAccess {
+            int64_t writer = -1;
+            std::vector<size_t> accums;
+            std::vector<size_t> reads;
+        };
+        std::map<TensorBase*, TensorAccess> access;
+        std::vector<std::vector<size_t>> deps(end_id - start_id);
+
+        for(size_t i = 0; i < end_id - start_id; i++) {
+            const Op* op = ops[start_id + i].get();
+            auto& dep = deps[i];
+
+            for(auto* t : op->reads()) {
+                auto& ta = access[t];
+                if(ta.writer >= 0) dep.push_back(ta.writer);
+                dep.insert(dep.end(), ta.accums.begin(), ta.accums.end());
+            }
+            if(auto* t = op->accumulates(); t != nullptr) {
+                auto& ta = access[t];
+                if(ta.writer >= 0) dep.push_back(ta.writer);
+                dep.insert(dep.end(), ta.reads.begin(), ta.reads.end());
+            }
+            if(auto* t = op->writes(); t != nullptr) {
+                auto& ta = access[t];
+                if(ta.writer >= 0) dep.push_back(ta.writer);
+                dep.insert(dep.end(), ta.accums.begin(), ta.accums.end());
+                dep.insert(dep.end(), ta.reads.begin(), ta.reads.end());
+            }
+            std::sort(dep.begin(), dep.end());
+            dep.erase(std::unique(dep.begin(), dep.end()), dep.end());
+            // an op that reads and updates the same tensor does not depend on itself
+            dep.erase(std::remove(dep.begin(), dep.end(), i), dep.end());
+
+            for(auto* t : op->reads()) access[t].reads.push_back(i);
+            if(auto* t = op->accumulates(); t != nullptr) access[t].accums.push_back(i);
+            if(auto* t = op->writes(); t != nullptr) {
+                auto& ta = access[t];
+                ta.writer = i;
+                ta.accums.clear();
+                ta.reads.clear();
+            }
+        }
+        return deps;
+    }
+
     std::vector<std::pair<size_t, size_t>> levelize_and_order(
       const std::vector<std::shared_ptr<Op>>& ops, size_t start_id,
       size_t end_id) {
         EXPECTS(start_id >= 0 && start_id <= ops.size());
         EXPECTS(end_id >= start_id && end_id <= ops.size());
 
-        std::vector<std::pair<size_t, size_t>> order;
+        auto deps = op_dependencies(ops, start_id, end_id);
 
+        std::vector<std::pair<size_t, size_t>> order;
         for(size_t i = start_id; i < end_id; i++) {
-            order.push_back(std::make_pair(0, i));
-        }
-        for(size_t i = 0; i < end_id - start_id - 1; i++) {
-            for(size_t j = i + 1; j < end_id - start_id; j++) {
-                if(op_has_dependence(ops[start_id + i].get(),
-                                     ops[start_id + j].get())) {
-                    order[j].first =
-                      std::max(order[i].first + 1, order[j].first);
-                }
+            size_t lvl = 0;
+            for(auto d : deps[i - start_id]) {
+                lvl = std::max(order[d].first + 1, lvl);
             }
+            order.push_back(std::make_pair(lvl, i));
         }
-        std::sort(order.begin(), order.end(),
+        std::stable_sort(order.begin(), order.end(),
                   [](const auto& lhs, const auto& rhs) {
                       return lhs.first < rhs.first;
                   });
         return order;
     }
 
+    /**
+     * @brief Make execute() use execute_async() (except when profiling).
+     */
+    Scheduler& async(bool enable = true) {
+        async_ = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Run the pending ops without barriers between dependency levels.
+     *
+     * Ops run in level order, but an op only waits for its own predecessors:
+     * after its share of an op a rank fences its one-sided updates and bumps
+     * the op's completion counter, and a dependent op waits until that counter
+     * reaches the number of ranks.
+     *
+     * The counters are kept by the scheduler (and its copies) and only reset
+     * between executions; they grow when a longer op list is executed.
+     */
+    void execute_async(ExecutionHW execute_on = ExecutionHW::CPU) {
+        if(start_idx_ == ops_.size()) return;
+
+        auto deps  = op_dependencies(ops_, start_idx_, ops_.size());
+        auto order = levelize_and_order(ops_, start_idx_, ops_.size());
+        const size_t nops = order.size();
+        const int64_t nranks = ec().pg().size().value();
+
+        // ac hands out the tasks of each op, done_ac counts the ranks that
+        // finished it
+        AtomicCounterChunked& ac = async_counter(async_ac_, nops);
+        AtomicCounterGA& done_ac = async_counter(async_done_ac_, nops);
+
+        std::vector<bool> done(nops, false);
+        for(size_t i = 0; i < nops; i++) {
+            const size_t op_id = order[i].second - start_idx_;
+            for(auto d : deps[op_id]) {
+                if(done[d]) continue;
+                internal::wait_for_counter(done_ac, d, nranks);
+                done[d] = true;
+            }
+
+            ec().set_ac(IndexedAC(&ac, op_id));
+            if (ops_[order[i].second]->exhw_ != ExecutionHW::DEFAULT) 
+                execute_on = ops_[order[i].second]->exhw_;
+            GA_Init_fence();
+            ops_[order[i].second]->execute(ec(), execute_on);
+            GA_Fence();
+            done_ac.fetch_add(op_id, 1);
+        }
+
+        ec().pg().barrier();
+        start_idx_ = ops_.size();
+        ec().set_ac(IndexedAC(nullptr, 0));
+    }
+
+    /**
+     * @brief Capture the pending ops into an ExecutionPlan.
+     *
+     * Allocations in the pending list are performed now and stay live until
+     * the plan is destroyed or released, which also runs the deallocations. The
+     * pending ops are consumed as if executed.
+     */
+    ExecutionPlan compile() {
+        std::vector<std::shared_ptr<Op>> ops, deallocs;
+        for(size_t i = start_idx_; i < ops_.size(); i++) {
+            if(ops_[i]->op_type() == OpType::alloc) ops_[i]->execute(ec());
+            else if(ops_[i]->op_type() == OpType::dealloc) deallocs.push_back(ops_[i]);
+            else ops.push_back(ops_[i]);
+        }
+        start_idx_ = ops_.size();
+
+        auto deps  = op_dependencies(ops, 0, ops.size());
+        auto order = levelize_and_order(ops, 0, ops.size());
+        return ExecutionPlan{ec(), std::move(ops), std::move(order),
+                             std::move(deps), std::move(deallocs)};
+    }
+
     void execute(ExecutionHW execute_on = ExecutionHW::CPU, bool profile = false) {
         if(start_idx_ == ops_.size()) return;
+        if(async_ && !profile) {
+            execute_async(execute_on);
+            return;
+        }
 #if 0
         auto order = levelize_and_order(ops_, start_idx_, ops_.size());
         EXPECTS(order.size() == ops_.size() - start_idx_);
@@ -226,7 +554,7 @@ public:
         auto order = levelize_and_order(ops_, start_idx_, ops_.size());
         EXPECTS(order.size() == ops_.size() - start_idx_);
         size_t lvl           = 0;
-        AtomicCounter* ac = new AtomicCounterGA(ec().pg(), order.size());
+        AtomicCounter* ac = new AtomicCounterChunked(ec().pg(), order.size());
         ac->allocate(0);
         auto misc_end = std::chrono::high_resolution_clock::now();
         double misc_time = std::chrono::duration_cast<std::chrono::duration<double>>((misc_end - misc_start)).count();
@@ -525,8 +853,33 @@ private:
     //     // 5. every non-output (not in live_out) tensor must be
     //     // deallocated
     // }
+    /// Counters of execute_async() held in @p ac with at least @p size
+    /// entries, reset to 0. Freed collectively when the last copy of the
+    /// scheduler goes away.
+    template<typename Counter>
+    Counter& async_counter(std::shared_ptr<Counter>& ac, int64_t size) {
+        if(ac != nullptr && ac->size() >= size) {
+            ac->reset(0);
+            return *ac;
+        }
+        if(ac != nullptr) size = std::max(size, 2 * ac->size());
+        ac.reset(); // the old array is freed before the new one is created
+        ac = std::shared_ptr<Counter>(
+          new Counter(ec().pg(), size), [](Counter* c) {
+              // after GA is finalized the array is gone; the handle is left behind
+              if(!GA_Initialized()) return;
+              c->deallocate();
+              delete c;
+          });
+        ac->allocate(0);
+        return *ac;
+    }
+
     std::vector<std::shared_ptr<Op>> ops_;
     size_t start_idx_ = 0;
+    bool async_ = false;
+    std::shared_ptr<AtomicCounterChunked> async_ac_;
+    std::shared_ptr<AtomicCounterGA> async_done_ac_;
 
 }; // class Scheduler
 
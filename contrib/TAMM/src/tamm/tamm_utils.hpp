@@ -295,6 +295,98 @@ ExecutionContext& get_ec(LabeledTensor<TensorType> ltensor) {
     return *(ltensor.tensor().execution_context());
 }
 
+namespace internal {
+
+/**
+ * @brief Whether the blocks of a tensor owned by this rank can be accessed in
+ * place in its local buffer, with @p ec spanning the tensor's process group
+ */
+template<typename TensorType>
+bool has_local_blocks(ExecutionContext& ec, const Tensor<TensorType>& tensor) {
+    const auto kind = tensor.kind();
+    return tensor.is_allocated() &&
+           (kind == TensorBase::TensorKind::normal ||
+            kind == TensorBase::TensorKind::spin) &&
+           tensor.distribution().kind() == DistributionKind::nw &&
+           tensor.execution_context()->pg() == ec.pg();
+}
+
+/**
+ * @brief Whether the local buffers of @p x and @p y hold the same blocks at
+ * the same offsets, so that they can be combined element by element
+ */
+template<typename TensorType>
+bool same_local_layout(ExecutionContext& ec, const Tensor<TensorType>& x,
+                       const Tensor<TensorType>& y) {
+    if(!has_local_blocks(ec, x) || !has_local_blocks(ec, y)) return false;
+    if(x.tiled_index_spaces() != y.tiled_index_spaces()) return false;
+    return static_cast<const Distribution_NW&>(x.distribution())
+      .same_layout(static_cast<const Distribution_NW&>(y.distribution()));
+}
+
+/**
+ * @brief Calls func(blockid, buf, size) for each non-zero block of a tensor
+ * slice owned by this rank, where buf points to the block in the local buffer.
+ * Unlike block_for, no task counter, copies or communication are involved.
+ *
+ * Only the blocks this rank owns are visited, filtered by the tiles of the
+ * slice in each mode. Slices over dependent index spaces or with repeated
+ * labels fall back to walking all blocks of the slice.
+ *
+ * @pre has_local_blocks(ec, ltensor.tensor())
+ */
+template<typename TensorType, typename Func>
+void local_block_for(ExecutionContext& ec, LabeledTensor<TensorType> ltensor,
+                     Func&& func) {
+    Tensor<TensorType> tensor = ltensor.tensor();
+    TensorType* lbuf          = tensor.access_local_buf();
+    const auto& dist          = tensor.distribution();
+    const Proc me             = ec.pg().rank();
+    const auto& labels        = ltensor.labels();
+    const auto& tis_list      = tensor.tiled_index_spaces();
+
+    bool by_mode = tensor.dep_map().empty();
+    for(size_t i = 0; by_mode && i < labels.size(); i++) {
+        by_mode = !labels[i].tiled_index_space().is_dependent();
+        for(size_t j = 0; by_mode && j < i; j++) by_mode = !(labels[i] == labels[j]);
+    }
+
+    if(by_mode) {
+        // tiles of the tensor's index space covered by the slice, per mode
+        std::vector<std::vector<bool>> in_slice(labels.size());
+        bool full = true;
+        for(size_t i = 0; i < labels.size(); i++) {
+            const auto& label_tis = labels[i].tiled_index_space();
+            if(label_tis == tis_list[i]) continue;
+            full = false;
+            in_slice[i].assign(tis_list[i].num_tiles(), false);
+            for(size_t t = 0; t < label_tis.num_tiles(); t++)
+                in_slice[i][label_tis.translate(t, tis_list[i])] = true;
+        }
+
+        static_cast<const Distribution_NW&>(dist).for_each_local_block(
+          me, [&](const IndexVector& blockid, Offset offset) {
+              if(!full) {
+                  for(size_t i = 0; i < blockid.size(); i++)
+                      if(!in_slice[i].empty() && !in_slice[i][blockid[i]]) return;
+              }
+              func(blockid, lbuf + offset.value(), tensor.block_size(blockid));
+          });
+        return;
+    }
+
+    LabelLoopNest loop_nest{labels};
+    for(const auto& bid : loop_nest) {
+        const IndexVector blockid = translate_blockid(bid, ltensor);
+        if(!tensor.is_non_zero(blockid)) continue;
+        auto [proc, offset] = dist.locate(blockid);
+        if(proc != me) continue;
+        func(blockid, lbuf + offset.value(), tensor.block_size(blockid));
+    }
+}
+
+} // namespace internal
+
 /**
  * @brief Update input LabeledTensor object with a lambda function
  *
@@ -794,16 +886,146 @@ hid_t get_hdf5_dt() {
     }
 }
 
+namespace internal {
+
+/// A non-zero block of a tensor and the element offset at which it is
+/// stored in the files of write_to_disk and read_from_disk
+struct BlockFileOffset {
+    IndexVector blockid;
+    hsize_t offset;
+};
+
+/**
+ * @brief File offsets of the non-zero blocks of a tensor slice, which are
+ * stored back to back in loop-nest order. Computed as one prefix sum over the
+ * loop nest, so that the I/O routines do not rescan it for every block.
+ */
+template<typename TensorType>
+std::vector<BlockFileOffset> block_file_offsets(LabeledTensor<TensorType> ltensor) {
+    Tensor<TensorType> tensor = ltensor.tensor();
+    std::vector<BlockFileOffset> offsets;
+    hsize_t offset = 0;
+
+    LabelLoopNest loop_nest{ltensor.labels()};
+    for(const IndexVector& bid : loop_nest) {
+        const IndexVector blockid = translate_blockid(bid, ltensor);
+        if(!tensor.is_non_zero(blockid)) continue;
+        offsets.push_back({blockid, offset});
+        offset += tensor.block_size(blockid);
+    }
+    return offsets;
+}
+
+/**
+ * @brief Collective transfer of a tensor slice to (@p write) or from the 1-D
+ * dataset of an open HDF5 file, with the file layout of block_file_offsets.
+ *
+ * The non-zero blocks are split into contiguous runs of about equal size, one
+ * per rank of @p ec, so that the part of the file handled by a rank is a
+ * single hyperslab. Each rank gathers its run into a buffer and moves it with
+ * one collective MPI-IO call per round of at most @p max_bytes, instead of
+ * one small independent transfer per block.
+ *
+ * @pre The file was opened on the communicator of @p ec
+ */
+template<typename TensorType>
+void collective_block_io(ExecutionContext& ec, LabeledTensor<TensorType> ltensor,
+                         const std::vector<BlockFileOffset>& block_offsets,
+                         hid_t dataset, hid_t file_dataspace, hid_t hdf5_dt, bool write,
+                         size_t max_bytes = 256 * 1024 * 1024) {
+    Tensor<TensorType> tensor = ltensor.tensor();
+    const size_t nranks       = ec.pg().size().value();
+    const size_t rank         = ec.pg().rank().value();
+    const size_t nblocks      = block_offsets.size();
+
+    hsize_t total = 0;
+    if(nblocks > 0)
+        total = block_offsets.back().offset + tensor.block_size(block_offsets.back().blockid);
+    auto end_offset = [&](size_t b) {
+        return b < nblocks ? block_offsets[b].offset : total;
+    };
+
+    // rank r handles the blocks starting in [r*total/nranks, (r+1)*total/nranks)
+    auto first_block = [&](size_t r) -> size_t {
+        const hsize_t start = static_cast<hsize_t>(
+          static_cast<long double>(total) * r / nranks);
+        return std::lower_bound(block_offsets.begin(), block_offsets.end(), start,
+                                [](const BlockFileOffset& bfo, hsize_t off) {
+                                    return bfo.offset < off;
+                                }) - block_offsets.begin();
+    };
+    const size_t lo = first_block(rank);
+    const size_t hi = first_block(rank + 1);
+
+    // rounds of whole blocks, each at most max_bytes unless a block is larger
+    const hsize_t max_elems = std::max<size_t>(max_bytes / sizeof(TensorType), 1);
+    std::vector<std::pair<size_t, size_t>> rounds;
+    for(size_t b = lo; b < hi;) {
+        size_t e = b + 1;
+        while(e < hi && end_offset(e + 1) - block_offsets[b].offset <= max_elems) e++;
+        rounds.push_back({b, e});
+        b = e;
+    }
+    int64_t nrounds = rounds.size();
+    nrounds         = ec.pg().allreduce(&nrounds, ReduceOp::max);
+
+    auto xfer_plist = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_COLLECTIVE);
+
+    std::vector<TensorType> buf;
+    for(int64_t r = 0; r < nrounds; r++) {
+        // ranks with fewer rounds still take part with an empty selection
+        size_t b = 0, e = 0;
+        if(r < static_cast<int64_t>(rounds.size())) std::tie(b, e) = rounds[r];
+        const hsize_t offset = b < e ? block_offsets[b].offset : 0;
+        hsize_t count        = b < e ? end_offset(e) - offset : 0;
+        buf.resize(std::max<hsize_t>(count, 1));
+
+        hsize_t mcount     = buf.size();
+        auto mem_dataspace = H5Screate_simple(1, &mcount, NULL);
+        if(count > 0) {
+            hsize_t stride = 1;
+            H5Sselect_hyperslab(file_dataspace, H5S_SELECT_SET, &offset, &stride, &count, NULL);
+        } else {
+            H5Sselect_none(file_dataspace);
+            H5Sselect_none(mem_dataspace);
+        }
+
+        if(write) {
+            for(size_t i = b; i < e; i++) {
+                const auto& bfo = block_offsets[i];
+                tensor.get(bfo.blockid, {buf.data() + (bfo.offset - offset),
+                                         tensor.block_size(bfo.blockid)});
+            }
+            H5Dwrite(dataset, hdf5_dt, mem_dataspace, file_dataspace, xfer_plist, buf.data());
+        } else {
+            H5Dread(dataset, hdf5_dt, mem_dataspace, file_dataspace, xfer_plist, buf.data());
+            for(size_t i = b; i < e; i++) {
+                const auto& bfo = block_offsets[i];
+                tensor.put(bfo.blockid, {buf.data() + (bfo.offset - offset),
+                                         tensor.block_size(bfo.blockid)});
+            }
+        }
+        H5Sclose(mem_dataspace);
+    }
+    H5Pclose(xfer_plist);
+}
+
+} // namespace internal
+
 /**
  * @brief write tensor to disk using HDF5
  *
  * @tparam TensorType the type of the elements in the tensor
  * @param tensor to write to disk
  * @param filename to write to disk
+ * @param collective write contiguous runs of blocks with collective MPI-IO
+ *        (see internal::collective_block_io) instead of one write per block
  */
 template<typename TensorType>
 void write_to_disk(Tensor<TensorType> tensor, const std::string& filename, 
-                    bool tammio=true, bool profile=false, int nagg_hint=0) {
+                    bool tammio=true, bool profile=false, int nagg_hint=0,
+                    bool collective=false) {
 
     ExecutionContext& gec = get_ec(tensor());
     auto io_t1 = std::chrono::high_resolution_clock::now();
@@ -840,13 +1062,12 @@ void write_to_disk(Tensor<TensorType> tensor, const std::string& filename,
         ExecutionContext& ec = gec;
     #endif
         auto ltensor = tensor();
-        LabelLoopNest loop_nest{ltensor.labels()};  
+        const auto block_offsets = internal::block_file_offsets(ltensor);
 
         int ierr;
         // MPI_File fh;
         MPI_Info info;
         // MPI_Status status;
-        hsize_t file_offset;
         MPI_Info_create(&info);
         MPI_Info_set(info,"cb_nodes",std::to_string(nagg).c_str());    
         // MPI_File_open(ec.pg().comm(), filename.c_str(), MPI_MODE_CREATE|MPI_MODE_WRONLY,
@@ -892,20 +1113,14 @@ void write_to_disk(Tensor<TensorType> tensor, const std::string& filename,
         xfer_plist = H5Pcreate (H5P_DATASET_XFER);
         auto ret=H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_INDEPENDENT);
 
-        if(/*is_irreg &&*/ tammio){
-            auto lambda = [&](const IndexVector& bid) {
-                const IndexVector blockid   = internal::translate_blockid(bid, ltensor);
-
-                file_offset = 0;
-                for(const IndexVector& pbid : loop_nest) {
-                    bool is_zero = !tensor.is_non_zero(pbid);
-                    if(pbid==blockid) {
-                        if(is_zero) return; 
-                        break;
-                    }
-                    if(is_zero) continue;
-                    file_offset += tensor.block_size(pbid);
-                }
+        if(tammio && collective) {
+            internal::collective_block_io(ec, ltensor, block_offsets, dataset, file_dataspace,
+                                          hdf5_dt, true);
+        }
+        else if(/*is_irreg &&*/ tammio){
+            auto lambda = [&](const internal::BlockFileOffset& bfo) {
+                const IndexVector& blockid = bfo.blockid;
+                hsize_t file_offset        = bfo.offset;
 
                 // const tamm::TAMM_SIZE 
                 hsize_t dsize = tensor.block_size(blockid);
@@ -929,23 +1144,13 @@ void write_to_disk(Tensor<TensorType> tensor, const std::string& filename,
 
             };
         
-            block_for(ec, ltensor, lambda);
+            parallel_work(ec, block_offsets.begin(), block_offsets.end(), lambda);
         }
         else{
                 //N-D GA
-                auto ga_write_lambda = [&](const IndexVector& bid){
-                    const IndexVector blockid   = internal::translate_blockid(bid, ltensor);
-
-                    file_offset = 0;
-                    for(const IndexVector& pbid : loop_nest) {
-                        bool is_zero = !tensor.is_non_zero(pbid);
-                        if(pbid==blockid) {
-                            if(is_zero) return; 
-                            break;
-                        }
-                        if(is_zero) continue;
-                        file_offset += tensor.block_size(pbid);
-                    }
+                auto ga_write_lambda = [&](const internal::BlockFileOffset& bfo) {
+                    const IndexVector& blockid = bfo.blockid;
+                    hsize_t file_offset        = bfo.offset;
 
                     // file_offset = file_offset*sizeof(TensorType);
 
@@ -980,7 +1185,7 @@ void write_to_disk(Tensor<TensorType> tensor, const std::string& filename,
 
                 };
 
-                block_for(ec, ltensor, ga_write_lambda);
+                parallel_work(ec, block_offsets.begin(), block_offsets.end(), ga_write_lambda);
         }
         
         H5Sclose(file_dataspace);
@@ -1017,11 +1222,12 @@ void write_to_disk(Tensor<TensorType> tensor, const std::string& filename,
  * @tparam TensorType the type of the elements in the tensor
  * @param tensor to write to disk
  * @param filename to write to disk
+ * @param collective write each tensor with collective MPI-IO, as in write_to_disk
  */
 template<typename TensorType>
 void write_to_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>> tensors,
                     std::vector<std::string> filenames,
-                    bool profile=false, int nagg_hint=0) {
+                    bool profile=false, int nagg_hint=0, bool collective=false) {
 
     EXPECTS(tensors.size() == filenames.size());
 
@@ -1058,8 +1264,12 @@ void write_to_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
     MPI_Comm io_comm;
     MPI_Comm_split(world_comm, color, world_rank, &io_comm);
 
-    AtomicCounter* ac = new AtomicCounterGA(gec.pg(), 1);
+    // only the root of each I/O group fetches tensors
+    int io_rank = -1;
+    if(io_comm != MPI_COMM_NULL) MPI_Comm_rank(io_comm, &io_rank);
+    AtomicCounter* ac = new AtomicCounterChunked(gec.pg(), 1, io_rank == 0);
     ac->allocate(0);
+    ac->set_task_count(0, tensors.size());
     int64_t taskcount = 0;
     int64_t next = -1; 
     // int total_pi_pg = 0;
@@ -1099,13 +1309,12 @@ void write_to_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
                                                 std::multiplies<int64_t>());
 
           auto          ltensor = tensor();
-          LabelLoopNest loop_nest{ltensor.labels()};
+          const auto block_offsets = internal::block_file_offsets(ltensor);
 
           int ierr;
           // MPI_File fh;
           MPI_Info info;
           // MPI_Status status;
-          hsize_t file_offset;
           MPI_Info_create(&info);
           // MPI_Info_set(info,"cb_nodes",std::to_string(nagg).c_str());
           // MPI_File_open(ec.pg().comm(), filename.c_str(), MPI_MODE_CREATE|MPI_MODE_WRONLY,
@@ -1152,19 +1361,9 @@ void write_to_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
           xfer_plist = H5Pcreate(H5P_DATASET_XFER);
           auto ret   = H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_INDEPENDENT);
 
-          auto lambda = [&](const IndexVector& bid) {
-            const IndexVector blockid = internal::translate_blockid(bid, ltensor);
-
-            file_offset = 0;
-            for(const IndexVector& pbid: loop_nest) {
-              bool is_zero = !tensor.is_non_zero(pbid);
-              if(pbid == blockid) {
-                if(is_zero) return;
-                break;
-              }
-              if(is_zero) continue;
-              file_offset += tensor.block_size(pbid);
-            }
+          auto lambda = [&](const internal::BlockFileOffset& bfo) {
+            const IndexVector& blockid = bfo.blockid;
+            hsize_t file_offset        = bfo.offset;
 
             hsize_t                 dsize = tensor.block_size(blockid);
             std::vector<TensorType> dbuf(dsize);
@@ -1184,7 +1383,11 @@ void write_to_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
             H5Sclose(mem_dataspace);
           };
 
-          block_for(ec, ltensor, lambda);
+          if(collective)
+            internal::collective_block_io(ec, ltensor, block_offsets, dataset, file_dataspace,
+                                          hdf5_dt, true);
+          else
+            parallel_work(ec, block_offsets.begin(), block_offsets.end(), lambda);
 
           H5Sclose(file_dataspace);
           // H5Sclose(mem_dataspace);
@@ -1273,24 +1476,12 @@ void ga_to_tamm(ExecutionContext& ec, Tensor<TensorType>& tensor, int ga_tens) {
 }
 
 
-template<typename TensorType>
-Tensor<TensorType> redistribute_tensor(Tensor<TensorType> stensor, TiledIndexSpaceVec tis, std::vector<size_t> spins={}) {
-    ExecutionContext& ec = get_ec(stensor());
-    // int rank = ec.pg().rank().value();
-    int wmn_ga = tamm_to_ga(ec,stensor);
-    // sch.deallocate(wmn).execute();
-    Tensor<TensorType> dtensor{tis};
-    if(spins.size()>0) dtensor = Tensor<TensorType>{tis,spins};
-    Tensor<TensorType>::allocate(&ec,dtensor);
-    ga_to_tamm(ec,dtensor,wmn_ga);
-    NGA_Destroy(wmn_ga);
-
-    return dtensor;
-}
-
-
 /**
- * @brief retile a tamm tensor 
+ * @brief retile a tamm tensor
+ *
+ * Each block of the destination is assembled from the overlapping blocks of the
+ * source with one-sided gets, so no intermediate global array is created.
+ * The destination may also cover only a leading sub-range of the source.
  *
  * @param stensor source tensor
  * @param dtensor tensor after retiling.
@@ -1303,9 +1494,77 @@ void retile_tamm_tensor(Tensor<TensorType> stensor, Tensor<TensorType>& dtensor,
     ExecutionContext& ec = get_ec(stensor());
     int rank = ec.pg().rank().value();
 
-    int ga_tens = tamm_to_ga(ec,stensor);
-    ga_to_tamm(ec, dtensor, ga_tens);
-    NGA_Destroy(ga_tens);
+    const size_t ndims = dtensor.num_modes();
+    EXPECTS(stensor.num_modes() == ndims);
+    EXPECTS(stensor.is_dense() && dtensor.is_dense());
+
+    std::vector<IndexVector> s_offsets(ndims);
+    for(size_t i = 0; i < ndims; i++) s_offsets[i] = stensor.tiled_index_spaces()[i].tile_offsets();
+
+    auto retile_lambda = [&](const IndexVector& bid){
+        const IndexVector blockid =
+        internal::translate_blockid(bid, dtensor());
+
+        auto d_dims = dtensor.block_dims(blockid);
+        auto d_off  = dtensor.block_offsets(blockid);
+        std::vector<TensorType> dbuf(dtensor.block_size(blockid), 0);
+
+        // source tiles overlapping this block: [t_lo,t_hi) in each mode
+        IndexVector t_lo(ndims), t_hi(ndims);
+        for(size_t i = 0; i < ndims; i++) {
+            const auto& so = s_offsets[i];
+            EXPECTS(d_off[i] + d_dims[i] <= so.back());
+            t_lo[i] = std::upper_bound(so.begin(), so.end(), d_off[i]) - so.begin() - 1;
+            t_hi[i] = std::lower_bound(so.begin(), so.end(), d_off[i] + d_dims[i]) - so.begin();
+        }
+
+        IndexVector sid = t_lo;
+        std::vector<TensorType> sbuf;
+        std::vector<size_t> lo(ndims), hi(ndims), idx(ndims);
+        while(true) {
+            if(stensor.is_non_zero(sid)) {
+                auto s_dims = stensor.block_dims(sid);
+                auto s_off  = stensor.block_offsets(sid);
+                sbuf.resize(stensor.block_size(sid));
+                stensor.get(sid, sbuf);
+
+                for(size_t i = 0; i < ndims; i++) {
+                    lo[i] = std::max(d_off[i], s_off[i]);
+                    hi[i] = std::min(d_off[i] + d_dims[i], s_off[i] + s_dims[i]);
+                }
+
+                // copy the overlap, one contiguous run along the last mode at a time
+                const size_t run = hi[ndims-1] - lo[ndims-1];
+                idx = lo;
+                while(true) {
+                    size_t sp = 0, dp = 0;
+                    for(size_t i = 0; i < ndims; i++) {
+                        sp = sp * s_dims[i] + (idx[i] - s_off[i]);
+                        dp = dp * d_dims[i] + (idx[i] - d_off[i]);
+                    }
+                    std::copy_n(sbuf.begin() + sp, run, dbuf.begin() + dp);
+
+                    int m = static_cast<int>(ndims) - 2;
+                    for(; m >= 0; m--) {
+                        if(++idx[m] < hi[m]) break;
+                        idx[m] = lo[m];
+                    }
+                    if(m < 0) break;
+                }
+            }
+
+            int m = static_cast<int>(ndims) - 1;
+            for(; m >= 0; m--) {
+                if(++sid[m] < t_hi[m]) break;
+                sid[m] = t_lo[m];
+            }
+            if(m < 0) break;
+        }
+
+        dtensor.put(blockid, dbuf);
+    };
+
+    block_for(ec, dtensor(), retile_lambda);
 
     auto io_t2 = std::chrono::high_resolution_clock::now();
 
@@ -1314,17 +1573,48 @@ void retile_tamm_tensor(Tensor<TensorType> stensor, Tensor<TensorType>& dtensor,
     if(rank == 0 && !tname.empty()) std::cout << "Time to re-tile " << tname << " tensor: " << rt_time << " secs" << std::endl;
 }
 
+/**
+ * @brief retile a tamm tensor in place: the tensor handle is rebound to a tensor
+ *  over the new tiled index spaces and the old storage is released.
+ *
+ * @param tensor tensor to retile, must be allocated
+ * @param tis tiled index spaces of the retiled tensor
+ */
+template<typename TensorType>
+void retile_ip(Tensor<TensorType>& tensor, const TiledIndexSpaceVec& tis, std::string tname="") {
+    ExecutionContext& ec = get_ec(tensor());
+    Tensor<TensorType> dtensor{tis};
+    Tensor<TensorType>::allocate(&ec,dtensor);
+    retile_tamm_tensor(tensor,dtensor,tname);
+    Tensor<TensorType>::deallocate(tensor);
+    tensor = dtensor;
+}
+
+template<typename TensorType>
+Tensor<TensorType> redistribute_tensor(Tensor<TensorType> stensor, TiledIndexSpaceVec tis, std::vector<size_t> spins={}) {
+    ExecutionContext& ec = get_ec(stensor());
+    Tensor<TensorType> dtensor{tis};
+    if(spins.size()>0) dtensor = Tensor<TensorType>{tis,spins};
+    Tensor<TensorType>::allocate(&ec,dtensor);
+    retile_tamm_tensor(stensor,dtensor);
+
+    return dtensor;
+}
+
+
 /**
  * @brief read tensor from disk using HDF5
  *
  * @tparam TensorType the type of the elements in the tensor
  * @param tensor to read into 
  * @param filename to read from disk
+ * @param collective read contiguous runs of blocks with collective MPI-IO
+ *        (see internal::collective_block_io) instead of one read per block
  */
 template<typename TensorType>
 void read_from_disk(Tensor<TensorType> tensor, const std::string& filename, 
                     bool tammio=true, Tensor<TensorType> wtensor={}, 
-                    bool profile=false, int nagg_hint=0) {
+                    bool profile=false, int nagg_hint=0, bool collective=false) {
 
     ExecutionContext& gec = get_ec(tensor());
     auto io_t1 = std::chrono::high_resolution_clock::now();
@@ -1370,13 +1660,12 @@ void read_from_disk(Tensor<TensorType> tensor, const std::string& filename,
             tensor = wtensor;
 
         auto ltensor = tensor();
-        LabelLoopNest loop_nest{ltensor.labels()};     
+        const auto block_offsets = internal::block_file_offsets(ltensor);
 
         int ierr;
         // MPI_File fh;
         MPI_Info info;
         // MPI_Status status;
-        hsize_t file_offset;
         MPI_Info_create(&info);
         // MPI_Info_set(info,"romio_cb_read", "enable");
         // MPI_Info_set(info,"striping_unit","4194304"); 
@@ -1414,20 +1703,14 @@ void read_from_disk(Tensor<TensorType> tensor, const std::string& filename,
         xfer_plist = H5Pcreate (H5P_DATASET_XFER);
         auto ret=H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_INDEPENDENT);
 
-        if(/*is_irreg &&*/ tammio) {
-            auto lambda = [&](const IndexVector& bid) {
-                const IndexVector blockid   = internal::translate_blockid(bid, ltensor);
-
-                file_offset = 0;
-                for(const IndexVector& pbid : loop_nest) {
-                    bool is_zero = !tensor.is_non_zero(pbid);
-                    if(pbid==blockid) {
-                        if(is_zero) return; 
-                        break;
-                    }
-                    if(is_zero) continue;
-                    file_offset += tensor.block_size(pbid);
-                }
+        if(tammio && collective) {
+            internal::collective_block_io(ec, ltensor, block_offsets, dataset, file_dataspace,
+                                          hdf5_dt, false);
+        }
+        else if(/*is_irreg &&*/ tammio) {
+            auto lambda = [&](const internal::BlockFileOffset& bfo) {
+                const IndexVector& blockid = bfo.blockid;
+                hsize_t file_offset        = bfo.offset;
 
                 // file_offset = file_offset*sizeof(TensorType);
 
@@ -1456,23 +1739,12 @@ void read_from_disk(Tensor<TensorType> tensor, const std::string& filename,
 
             };
 
-                block_for(ec, ltensor, lambda);
+                parallel_work(ec, block_offsets.begin(), block_offsets.end(), lambda);
         }
          else {
-                auto ga_read_lambda = [&](const IndexVector& bid){
-                    const IndexVector blockid =
-                    internal::translate_blockid(bid, tensor());
-
-                    file_offset = 0;
-                    for(const IndexVector& pbid : loop_nest) {
-                        bool is_zero = !tensor.is_non_zero(pbid);
-                        if(pbid==blockid) {
-                            if(is_zero) return; 
-                            break;
-                        }
-                        if(is_zero) continue;
-                        file_offset += tensor.block_size(pbid);
-                    }
+                auto ga_read_lambda = [&](const internal::BlockFileOffset& bfo) {
+                    const IndexVector& blockid = bfo.blockid;
+                    hsize_t file_offset        = bfo.offset;
 
                     // file_offset = file_offset*sizeof(TensorType);
 
@@ -1510,7 +1782,7 @@ void read_from_disk(Tensor<TensorType> tensor, const std::string& filename,
                    
                 };
                 
-                block_for(ec, tensor(), ga_read_lambda);
+                parallel_work(ec, block_offsets.begin(), block_offsets.end(), ga_read_lambda);
         }
 
         H5Sclose(file_dataspace);
@@ -1552,11 +1824,12 @@ void read_from_disk(Tensor<TensorType> tensor, const std::string& filename,
  * @tparam TensorType the type of the elements in the tensor
  * @param tensor to read into 
  * @param filename to read from disk
+ * @param collective read each tensor with collective MPI-IO, as in read_from_disk
  */
 template<typename TensorType>
 void read_from_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>> tensors,
                     std::vector<std::string> filenames, std::vector<Tensor<TensorType>> wtensors={}, 
-                    bool profile=false, int nagg_hint=0) {
+                    bool profile=false, int nagg_hint=0, bool collective=false) {
 
     EXPECTS(tensors.size() == filenames.size());
 
@@ -1593,8 +1866,12 @@ void read_from_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
     MPI_Comm io_comm;
     MPI_Comm_split(world_comm, color, world_rank, &io_comm);
 
-    AtomicCounter* ac = new AtomicCounterGA(gec.pg(), 1);
+    // only the root of each I/O group fetches tensors
+    int io_rank = -1;
+    if(io_comm != MPI_COMM_NULL) MPI_Comm_rank(io_comm, &io_rank);
+    AtomicCounter* ac = new AtomicCounterChunked(gec.pg(), 1, io_rank == 0);
     ac->allocate(0);
+    ac->set_task_count(0, tensors.size());
     int64_t taskcount = 0;
     int64_t next = -1; 
     // int total_pi_pg = 0;
@@ -1625,13 +1902,12 @@ void read_from_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
           }
 
           auto          ltensor = tensor();
-          LabelLoopNest loop_nest{ltensor.labels()};
+          const auto block_offsets = internal::block_file_offsets(ltensor);
 
           int ierr;
           // MPI_File fh;
           MPI_Info info;
           // MPI_Status status;
-          hsize_t file_offset;
           MPI_Info_create(&info);
           // MPI_Info_set(info,"romio_cb_read", "enable");
           // MPI_Info_set(info,"striping_unit","4194304");
@@ -1669,19 +1945,9 @@ void read_from_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
           xfer_plist = H5Pcreate(H5P_DATASET_XFER);
           auto ret   = H5Pset_dxpl_mpio(xfer_plist, H5FD_MPIO_INDEPENDENT);
 
-          auto lambda = [&](const IndexVector& bid) {
-            const IndexVector blockid   = internal::translate_blockid(bid, ltensor);
-
-            file_offset = 0;
-            for(const IndexVector& pbid : loop_nest) {
-              bool is_zero = !tensor.is_non_zero(pbid);
-              if(pbid == blockid) {
-                if(is_zero) return;
-                break;
-              }
-              if(is_zero) continue;
-              file_offset += tensor.block_size(pbid);
-            }
+          auto lambda = [&](const internal::BlockFileOffset& bfo) {
+            const IndexVector& blockid = bfo.blockid;
+            hsize_t file_offset        = bfo.offset;
 
             // file_offset = file_offset*sizeof(TensorType);
 
@@ -1709,7 +1975,11 @@ void read_from_disk_group(ExecutionContext& gec, std::vector<Tensor<TensorType>>
             H5Sclose(mem_dataspace);
           };
 
-          block_for(ec, ltensor, lambda);
+          if(collective)
+            internal::collective_block_io(ec, ltensor, block_offsets, dataset, file_dataspace,
+                                          hdf5_dt, false);
+          else
+            parallel_work(ec, block_offsets.begin(), block_offsets.end(), lambda);
 
           H5Sclose(file_dataspace);
           // H5Sclose(mem_dataspace);
@@ -1866,6 +2136,13 @@ TensorType linf_norm(LabeledTensor<TensorType> ltensor) {
     TensorType glinfnorm        = 0;
     Tensor<TensorType> tensor = ltensor.tensor();
 
+    if(internal::has_local_blocks(gec, tensor)) {
+        internal::local_block_for(gec, ltensor, [&](const IndexVector&, TensorType* buf, size_t size) {
+            for(size_t c = 0; c < size; c++) linfnorm = std::max<TensorType>(linfnorm, std::fabs(buf[c]));
+        });
+        return gec.pg().allreduce(&linfnorm, ReduceOp::max);
+    }
+
     #ifdef TU_SG
     MPI_Comm sub_comm;
     int rank = gec.pg().rank().value();
@@ -2050,12 +2327,20 @@ void write_to_disk_hdf5(Tensor<T> tensor, std::string filename,
  * @param ltensor tensor to operate on
  * @param func function to be applied to each element
  */
-template<typename TensorType>
-void apply_ewise_ip(LabeledTensor<TensorType> ltensor,
-                 std::function<TensorType(TensorType)> func) {
+template<typename TensorType, typename Func>
+void apply_ewise_ip(LabeledTensor<TensorType> ltensor, Func func) {
     ExecutionContext& gec = get_ec(ltensor);
     Tensor<TensorType> tensor = ltensor.tensor();
 
+    // owner computes: each rank updates its own blocks in place
+    if(internal::has_local_blocks(gec, tensor)) {
+        internal::local_block_for(gec, ltensor, [&](const IndexVector&, TensorType* buf, size_t size) {
+            for(size_t c = 0; c < size; c++) buf[c] = func(buf[c]);
+        });
+        gec.pg().barrier();
+        return;
+    }
+
     #ifdef TU_SG
     MPI_Comm sub_comm;
     get_subgroup_info(gec,tensor,sub_comm);
@@ -2091,7 +2376,7 @@ void apply_ewise_ip(LabeledTensor<TensorType> ltensor,
 // These routines update the tensor in-place
 template<typename TensorType>
 void conj_ip(LabeledTensor<TensorType> ltensor) {
-    std::function<TensorType(TensorType)> func = [&](TensorType a) {
+    auto func = [](TensorType a) -> TensorType {
         return std::conj(a);
     };
     apply_ewise_ip(ltensor, func);
@@ -2105,7 +2390,7 @@ void conj_ip(Tensor<TensorType> tensor) {
 template<typename TensorType>
 void scale_ip(LabeledTensor<TensorType> ltensor,
            TensorType alpha) {
-    std::function<TensorType(TensorType)> func = [&](TensorType a) {
+    auto func = [alpha](TensorType a) {
         return alpha * a;
     };
     apply_ewise_ip(ltensor, func);
@@ -2365,6 +2650,17 @@ TensorType norm(ExecutionContext& gec, LabeledTensor<TensorType> ltensor) {
     TensorType gsumsq         = 0;
     Tensor<TensorType> tensor = ltensor.tensor();
 
+    if(internal::has_local_blocks(gec, tensor)) {
+        internal::local_block_for(gec, ltensor, [&](const IndexVector&, TensorType* buf, size_t size) {
+            if constexpr(internal::is_complex_v<TensorType>)
+                for(size_t c = 0; c < size; c++) lsumsq += buf[c] * std::conj(buf[c]);
+            else
+                for(size_t c = 0; c < size; c++) lsumsq += buf[c] * buf[c];
+        });
+        gsumsq = gec.pg().allreduce(&lsumsq, ReduceOp::sum);
+        return std::sqrt(gsumsq);
+    }
+
     #ifdef TU_SG
     MPI_Comm sub_comm;
     int rank = gec.pg().rank().value();
@@ -2403,6 +2699,81 @@ TensorType norm(ExecutionContext& gec, LabeledTensor<TensorType> ltensor) {
     return std::sqrt(gsumsq);
 }
 
+namespace internal {
+
+/**
+ * @brief This rank's contribution to the inner product <x|y>, summing
+ * conj(x)*y over the blocks of x it owns. Matching blocks of y are read in
+ * place when y has the same block layout as x (same_local_layout), and
+ * fetched otherwise.
+ */
+template<typename TensorType>
+TensorType local_dot(ExecutionContext& ec, Tensor<TensorType> x, Tensor<TensorType> y) {
+    TensorType lsum = 0;
+    auto accumulate = [&](const TensorType* xbuf, const TensorType* ybuf, size_t size) {
+        if constexpr(is_complex_v<TensorType>)
+            for(size_t c = 0; c < size; c++) lsum += std::conj(xbuf[c]) * ybuf[c];
+        else
+            for(size_t c = 0; c < size; c++) lsum += xbuf[c] * ybuf[c];
+    };
+
+    if(has_local_blocks(ec, x)) {
+        const TensorType* xbase = x.access_local_buf();
+        if(same_local_layout(ec, x, y)) {
+            // the owned blocks of x and y line up in the local buffers
+            const auto& dist = static_cast<const Distribution_NW&>(x.distribution());
+            accumulate(xbase, y.access_local_buf(), dist.buf_size(ec.pg().rank()).value());
+            return lsum;
+        }
+        std::vector<TensorType> ybuf;
+        local_block_for(ec, x(), [&](const IndexVector& blockid, TensorType* buf, size_t size) {
+            ybuf.resize(size);
+            y.get(blockid, ybuf);
+            accumulate(buf, ybuf.data(), size);
+        });
+        return lsum;
+    }
+
+    block_for(ec, x(), [&](const IndexVector& blockid) {
+        const tamm::TAMM_SIZE size = x.block_size(blockid);
+        std::vector<TensorType> xbuf(size), ybuf(size);
+        x.get(blockid, xbuf);
+        y.get(blockid, ybuf);
+        accumulate(xbuf.data(), ybuf.data(), size);
+    });
+    return lsum;
+}
+
+} // namespace internal
+
+/**
+ * @brief Inner products <xs[i]|ys[i]> of several tensor pairs, computed in
+ * one sweep over the local blocks with a single allreduce. The first tensor
+ * of each pair is conjugated.
+ *
+ * @pre xs[i] and ys[i] have the same tiled index spaces
+ */
+template<typename TensorType>
+std::vector<TensorType> dots(ExecutionContext& ec, const std::vector<Tensor<TensorType>>& xs,
+                             const std::vector<Tensor<TensorType>>& ys) {
+    EXPECTS(xs.size() == ys.size());
+    const size_t n = xs.size();
+    std::vector<TensorType> lsum(n), gsum(n);
+    for(size_t i = 0; i < n; i++) lsum[i] = internal::local_dot(ec, xs[i], ys[i]);
+    ec.pg().allreduce(lsum.data(), gsum.data(), static_cast<int>(n), ReduceOp::sum);
+    return gsum;
+}
+
+/**
+ * @brief 2-norms of several tensors with a single allreduce
+ */
+template<typename TensorType>
+std::vector<TensorType> norms(ExecutionContext& ec, const std::vector<Tensor<TensorType>>& tensors) {
+    std::vector<TensorType> nrm = dots(ec, tensors, tensors);
+    for(auto& v: nrm) v = std::sqrt(v);
+    return nrm;
+}
+
 template<typename TensorType>
 void gf_peak_coord(int nmodes, std::vector<TensorType> dbuf,
 std::vector<size_t> block_dims, std::vector<size_t> block_offset, 
@@ -507,6 +507,10 @@ public:
       return impl_->memory_region();
     }
 
+    void swap_storage(Tensor<T>& other) {
+      impl_->swap_storage(*other.impl_);
+    }
+
     void add_update(const TensorUpdate& new_update) {
       impl_->add_update(new_update);
     }
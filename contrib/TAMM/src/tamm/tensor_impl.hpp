@@ -498,6 +498,20 @@ public:
       proc_list_ = proc_list;
     }
 
+    /**
+     * @brief Exchange the memory regions of two allocated tensors over the
+     * same tiled index spaces, so that each handle addresses the other's data.
+     *
+     * @param [in] other tensor whose storage is exchanged with this one
+     */
+    void swap_storage(TensorImpl<T>& other) {
+      EXPECTS(is_allocated() && other.is_allocated());
+      EXPECTS(tiled_index_spaces() == other.tiled_index_spaces());
+      EXPECTS(distribution_->kind() == other.distribution_->kind());
+      EXPECTS(proc_list_ == other.proc_list_);
+      std::swap(mpb_, other.mpb_);
+    }
+
     virtual bool is_block_cyclic() {
       return false;
     }
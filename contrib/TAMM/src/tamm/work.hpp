@@ -17,6 +17,19 @@ enum class ExecutionPolicy {
     parallel //<Parallel distributed execution
 };
 
+namespace internal {
+
+/// Number of tasks in [first, last); the loop nest iterators are forward-only
+/// and define no iterator traits, so std::distance cannot be used
+template<typename Itr>
+int64_t task_count(Itr first, Itr last) {
+    int64_t n = 0;
+    for(; first != last; ++first) n++;
+    return n;
+}
+
+} // namespace internal
+
 /**
  * @brief Parallel execution using GA atomic counters
  * @tparam Itr Type of iterator
@@ -33,6 +46,7 @@ void parallel_work_ga(ExecutionContext& ec, Itr first, Itr last, Fn fn) {
     if(ec.ac().ac_) {
         AtomicCounter* ac = ec.ac().ac_;
         size_t idx = ec.ac().idx_;
+        ac->set_task_count(idx, internal::task_count(first, last));
         int64_t next = ac->fetch_add(idx, 1);
         for(int64_t count = 0; first != last; ++first, ++count) {
             if(next == count) {
@@ -41,8 +55,9 @@ void parallel_work_ga(ExecutionContext& ec, Itr first, Itr last, Fn fn) {
             }
         }
     } else {
-        AtomicCounter* ac = new AtomicCounterGA(ec.pg(), 1);
+        AtomicCounter* ac = new AtomicCounterChunked(ec.pg(), 1);
         ac->allocate(0);
+        ac->set_task_count(0, internal::task_count(first, last));
         int64_t next = ac->fetch_add(0, 1);
         for(int64_t count = 0; first != last; ++first, ++count) {
             if(next == count) {
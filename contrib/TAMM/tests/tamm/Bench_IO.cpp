@@ -0,0 +1,93 @@
+#include "ga/ga-mpi.h"
+#include "ga/ga.h"
+#include "ga/macdecls.h"
+#include "mpi.h"
+#include "tamm/tamm.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark of independent vs. collective tensor I/O
+ *
+ * Writes an n x n tensor to disk and reads it back, once with independent
+ * per-block transfers and once with aggregated collective ones, for a range
+ * of tile sizes. Only built and registered with ctest when
+ * TAMM_ENABLE_BENCHMARKS is ON.
+ *
+ * Usage: Bench_IO [n] [tilesize ...]   (defaults: 512, tile sizes 1 8 32)
+ */
+
+using namespace tamm;
+
+/// Time to write a tensor with distinct elements and read it back; aborts if
+/// the tensor read differs from the one written
+double write_read_time(ExecutionContext& ec, size_t n, size_t tilesize, bool collective) {
+    TiledIndexSpace tis{IndexSpace{range(n)}, static_cast<Tile>(tilesize)};
+    auto [i, j] = tis.labels<2>("all");
+
+    Tensor<double> A{i, j};
+    Tensor<double> B{i, j};
+    Scheduler sch{ec};
+    sch.allocate(A, B)(B() = 0.0).execute();
+
+    fill_tensor<double>(A, [&](const IndexVector& blockid, span<double> buf) {
+        auto block_dims   = A.block_dims(blockid);
+        auto block_offset = A.block_offsets(blockid);
+        size_t c          = 0;
+        for(size_t p = block_offset[0]; p < block_offset[0] + block_dims[0]; p++)
+            for(size_t q = block_offset[1]; q < block_offset[1] + block_dims[1]; q++, c++)
+                buf[c] = static_cast<double>(p * n + q);
+    });
+
+    const std::string filename = "tamm_bench_io_" + std::to_string(n) + ".h5";
+    ec.pg().barrier();
+    auto io_t1 = std::chrono::high_resolution_clock::now();
+    write_to_disk(A, filename, true, false, 0, collective);
+    read_from_disk(B, filename, true, {}, false, 0, collective);
+    auto io_t2 = std::chrono::high_resolution_clock::now();
+
+    sch(B() -= A()).execute();
+    if(tamm::norm(B) != 0.0) {
+        if(ec.pg().rank() == 0) std::cerr << "Bench_IO: tensor read back differs" << std::endl;
+        std::abort();
+    }
+
+    Tensor<double>::deallocate(A, B);
+    if(ec.pg().rank() == 0) std::remove(filename.c_str());
+    ec.pg().barrier();
+
+    double t = std::chrono::duration_cast<std::chrono::duration<double>>((io_t2 - io_t1)).count();
+    return ec.pg().allreduce(&t, ReduceOp::max);
+}
+
+int main(int argc, char* argv[]) {
+    tamm::initialize(argc, argv);
+
+    {
+        ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+        ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+
+        const size_t n = argc > 1 ? std::stoul(argv[1]) : 512;
+        std::vector<size_t> tilesizes;
+        for(int a = 2; a < argc; a++) tilesizes.push_back(std::stoul(argv[a]));
+        if(tilesizes.empty()) tilesizes = {1, 8, 32};
+
+        if(ec.pg().rank() == 0)
+            std::cout << "write+read of a " << n << " x " << n << " tensor on "
+                      << ec.pg().size().value() << " ranks" << std::endl
+                      << "tilesize, independent (s), collective (s)" << std::endl;
+        for(auto tilesize : tilesizes) {
+            const double t_ind  = write_read_time(ec, n, tilesize, false);
+            const double t_coll = write_read_time(ec, n, tilesize, true);
+            if(ec.pg().rank() == 0)
+                std::cout << tilesize << ", " << t_ind << ", " << t_coll << std::endl;
+        }
+    }
+
+    tamm::finalize();
+    return 0;
+}
@@ -0,0 +1,206 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+#include "doctest/doctest.h"
+#include "ga/ga-mpi.h"
+#include "ga/ga.h"
+#include "ga/macdecls.h"
+#include "mpi.h"
+#include "tamm/tamm.hpp"
+#include "tamm/checkpoint.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Tests for writing tensors to and reading them from disk
+ */
+
+using namespace tamm;
+
+/// Set each element of an n x n tensor to its linear index
+void fill_indices(Tensor<double> A, size_t n) {
+    fill_tensor<double>(A, [&](const IndexVector& blockid, span<double> buf) {
+        auto block_dims   = A.block_dims(blockid);
+        auto block_offset = A.block_offsets(blockid);
+        size_t c          = 0;
+        for(size_t p = block_offset[0]; p < block_offset[0] + block_dims[0]; p++)
+            for(size_t q = block_offset[1]; q < block_offset[1] + block_dims[1]; q++, c++)
+                buf[c] = static_cast<double>(p * n + q);
+    });
+}
+
+/// Fill a tensor with its element indices, write it to disk, read it back
+/// into a second tensor and return the time spent in I/O
+double write_read_tensor(ExecutionContext& ec, size_t n, size_t tilesize,
+                         bool collective = false) {
+    TiledIndexSpace tis{IndexSpace{range(n)}, static_cast<Tile>(tilesize)};
+    auto [i, j] = tis.labels<2>("all");
+
+    Tensor<double> A{i, j};
+    Tensor<double> B{i, j};
+    Tensor<double> C{i, j};
+    Scheduler sch{ec};
+    sch.allocate(A, B, C)(B() = 0.0).execute();
+
+    fill_indices(A, n);
+
+    const std::string filename = "tamm_test_io_" + std::to_string(n) + ".h5";
+    auto io_t1 = std::chrono::high_resolution_clock::now();
+    write_to_disk(A, filename, true, false, 0, collective);
+    read_from_disk(B, filename, true, {}, false, 0, collective);
+    auto io_t2 = std::chrono::high_resolution_clock::now();
+
+    sch(C() = A())(C() -= B()).execute();
+    REQUIRE(tamm::norm(C) == 0.0);
+
+    Tensor<double>::deallocate(A, B, C);
+    if(ec.pg().rank() == 0) std::remove(filename.c_str());
+    ec.pg().barrier();
+
+    return std::chrono::duration_cast<std::chrono::duration<double>>((io_t2 - io_t1)).count();
+}
+
+int main(int argc, char* argv[]) {
+
+    tamm::initialize(argc, argv);
+
+    doctest::Context context(argc, argv);
+
+    int res = context.run();
+
+    tamm::finalize();
+
+    return res;
+}
+
+TEST_CASE("Block file offsets") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+
+    TiledIndexSpace tis{IndexSpace{range(10)}, 3};
+    auto [i, j] = tis.labels<2>("all");
+    Tensor<double> A{i, j};
+    Tensor<double>::allocate(&ec, A);
+
+    auto offsets = internal::block_file_offsets(A());
+    REQUIRE(offsets.size() == 16);
+
+    hsize_t offset = 0;
+    for(const auto& bfo : offsets) {
+        REQUIRE(bfo.offset == offset);
+        offset += A.block_size(bfo.blockid);
+    }
+    REQUIRE(offset == 100);
+
+    Tensor<double>::deallocate(A);
+}
+
+TEST_CASE("Write and read a many-block tensor") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+
+    // unit tiles: 4096 and 16384 blocks. With linear-time offsets the I/O
+    // time grows about 4x; a per-block rescan of the loop nest grows 16x.
+    // The ratio is only reported, wall-clock times are not checked here.
+    const double t_small = write_read_tensor(ec, 64, 1);
+    const double t_large = write_read_tensor(ec, 128, 1);
+
+    if(ec.pg().rank() == 0)
+        std::cout << "write+read time for 4096, 16384 blocks: " << t_small << ", " << t_large
+                  << " secs (ratio " << (t_small > 0 ? t_large / t_small : 0.0) << ")"
+                  << std::endl;
+}
+
+TEST_CASE("Collective write and read") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+
+    // uneven tiles, so that the per-rank runs do not align with the tiling
+    write_read_tensor(ec, 97, 7, true);
+}
+
+TEST_CASE("Asynchronous checkpoint") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+
+    const size_t n = 97;
+    TiledIndexSpace tis{IndexSpace{range(n)}, 7};
+    auto [i, j] = tis.labels<2>("all");
+
+    Tensor<double> A{i, j};
+    Tensor<double> B{i, j};
+    Tensor<double> C{i, j};
+    Tensor<double> Ref{i, j};
+    Scheduler sch{ec};
+    sch.allocate(A, B, C, Ref)(B() = 0.0).execute();
+    fill_indices(A, n);
+    sch(Ref() = A()).execute();
+
+    const std::string filename = "tamm_test_checkpoint.h5";
+    const std::string tmpname  = filename + ".tmp";
+
+    // the file holds the values of Ref
+    auto check_file = [&]() {
+        read_from_disk(B, filename);
+        sch(C() = Ref())(C() -= B()).execute();
+        REQUIRE(tamm::norm(C) == 0.0);
+    };
+
+    SUBCASE("Write, then read back") {
+        AsyncCheckpoint<double> checkpoint{ec};
+        checkpoint.write({A}, {filename});
+        // the snapshot is taken before write() returns
+        sch(A() = 0.0).execute();
+        REQUIRE(checkpoint.wait());
+
+        REQUIRE(std::filesystem::exists(filename));
+        REQUIRE(!std::filesystem::exists(tmpname));
+        check_file();
+    }
+
+    SUBCASE("A failed write keeps the previous checkpoint") {
+        write_to_disk(A, filename);
+        // a directory in place of the temporary file makes creating it fail
+        if(ec.pg().rank() == 0) std::filesystem::create_directory(tmpname);
+        ec.pg().barrier();
+
+        sch(A() = 2.0).execute();
+        AsyncCheckpoint<double> checkpoint{ec};
+        checkpoint.write({A}, {filename});
+        REQUIRE_FALSE(checkpoint.wait());
+        check_file();
+    }
+
+    SUBCASE("A failed rename is reported on all ranks") {
+        // a directory in place of the checkpoint makes the rename fail
+        if(ec.pg().rank() == 0) std::filesystem::create_directories(filename + "/keep");
+        ec.pg().barrier();
+
+        AsyncCheckpoint<double> checkpoint{ec};
+        checkpoint.write({A}, {filename});
+        REQUIRE_FALSE(checkpoint.wait());
+        REQUIRE(std::filesystem::is_directory(filename));
+        REQUIRE(!std::filesystem::exists(tmpname));
+    }
+
+    SUBCASE("An interrupted write keeps the previous checkpoint") {
+        write_to_disk(A, filename);
+
+        sch(A() = 2.0).execute();
+        {
+            AsyncCheckpoint<double> checkpoint{ec};
+            checkpoint.write({A}, {filename});
+            // destroyed without wait(), as when the run stops mid-write
+        }
+        ec.pg().barrier();
+        check_file();
+    }
+
+    Tensor<double>::deallocate(A, B, C, Ref);
+    if(ec.pg().rank() == 0) {
+        std::filesystem::remove_all(filename);
+        std::filesystem::remove_all(tmpname);
+    }
+    ec.pg().barrier();
+}
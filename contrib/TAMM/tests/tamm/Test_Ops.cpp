@@ -1461,6 +1461,205 @@ TEST_CASE("Two-dimensional ops with flush and sync") {
     delete ec;
 }
 
+TEST_CASE("Two-dimensional ops with async scheduler") {
+    bool failed;
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext* ec = new ExecutionContext{pg, DistributionKind::nw, MemoryManagerKind::ga};
+    using T              = double;
+
+    IndexSpace IS{range(0, 10)};
+    TiledIndexSpace TIS{IS, 3};
+    TiledIndexLabel i, j, k;
+    std::tie(i, j, k) = TIS.labels<3>("all");
+
+    try {
+        failed = false;
+        Tensor<T> T1{TIS, TIS}, T2{TIS, TIS}, T3{TIS, TIS}, T4{TIS, TIS};
+        Scheduler sch{*ec};
+        sch
+          .async()
+          .allocate(T1, T2, T3, T4)
+          (T1() = 2)(T2() = 3)(T3() = 0)(T4() = 1)
+          // independent accumulates into T3, then a reader and a writer of T3
+          (T3(i, j) += T1(i, k) * T2(k, j))
+          (T3(i, j) += 0.5 * T1(i, j))
+          (T4(i, j) += T3(i, j))
+          (T3() = 7)
+          (T4(i, j) += T3(i, j))
+          .deallocate(T1, T2)
+          .execute();
+        check_value(T3, (T)7.0);
+        check_value(T4, (T)(1.0 + 10 * 2 * 3 + 0.5 * 2 + 7.0));
+
+        // the counters of the first execute are reset and reused
+        sch(T4() = 1)(T4(i, j) += 2.0 * T3(i, j)).execute();
+        check_value(T4, (T)15.0);
+        Tensor<T>::deallocate(T3, T4);
+    } catch(std::string& e) {
+        std::cerr << "Caught exception: " << e << "\n";
+        failed = true;
+    }
+    REQUIRE(!failed);
+    delete ec;
+}
+
+TEST_CASE("Two-dimensional ops with a compiled plan") {
+    bool failed;
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext* ec = new ExecutionContext{pg, DistributionKind::nw, MemoryManagerKind::ga};
+    using T              = double;
+
+    IndexSpace IS{range(0, 10)};
+    TiledIndexSpace TIS{IS, 3};
+    TiledIndexLabel i, j;
+    std::tie(i, j) = TIS.labels<2>("all");
+
+    try {
+        failed = false;
+        Tensor<T> X{TIS, TIS}, Y{TIS, TIS}, R{TIS, TIS}, I{TIS, TIS};
+        Scheduler sch{*ec};
+        sch.allocate(X, Y, R)(X() = 1)(Y() = 4).execute();
+
+        sch
+          .allocate(I)
+          (I(i, j) = 2.0 * X(i, j))
+          (R(i, j) = I(i, j))
+          (R(i, j) += X(i, j))
+          .deallocate(I);
+        ExecutionPlan plan = sch.compile();
+
+        plan.execute();
+        check_value(R, (T)3.0);
+        plan.bind(X, Y).execute();
+        check_value(R, (T)12.0);
+        check_value(X, (T)1.0);
+        check_value(Y, (T)4.0);
+        plan.async().execute();
+        check_value(R, (T)3.0);
+
+        Tensor<T>::deallocate(X, Y, R);
+    } catch(std::string& e) {
+        std::cerr << "Caught exception: " << e << "\n";
+        failed = true;
+    }
+    REQUIRE(!failed);
+    delete ec;
+}
+
+TEST_CASE("In-place elementwise operations on local blocks") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+
+    IndexSpace MO{range(10),
+                   {{"occ", {range(0, 4)}}, {"virt", {range(4, 10)}}}};
+    TiledIndexSpace tMO{MO, 2};
+
+    auto [i, j] = tMO.labels<2>("all");
+    auto [i_virt, j_virt] = tMO.labels<2>("virt");
+
+    Tensor<double> T{i, j};
+    Scheduler{ec}.allocate(T)(T() = 2.0).execute();
+
+    // 64 elements stay 2.0, the 36 virtual-virtual ones become -1.0
+    scale_ip(T(i_virt, j_virt), -0.5);
+    REQUIRE(std::abs(tamm::norm(T) - std::sqrt(292.0)) < 1e-12);
+    REQUIRE(linf_norm(T) == 2.0);
+
+    scale_ip(T, 3.0);
+    REQUIRE(std::abs(tamm::norm(T(i_virt, j_virt)) - 18.0) < 1e-12);
+
+    Tensor<double>::deallocate(T);
+}
+
+TEST_CASE("Batched norms and dot products") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+    ExecutionContext ec_dense{pg, DistributionKind::dense, MemoryManagerKind::ga};
+
+    TiledIndexSpace tMO{IndexSpace{range(10)}, 3};
+    auto [i, j] = tMO.labels<2>("all");
+
+    SUBCASE("real") {
+        Tensor<double> A{i, j}, B{i, j};
+        Scheduler{ec}.allocate(A, B)(A() = 2.0)(B() = 3.0).execute();
+        // same values, different distribution: blocks of y are fetched
+        Tensor<double> C{i, j};
+        Scheduler{ec_dense}.allocate(C)(C() = 3.0).execute();
+
+        using VTensor = std::vector<Tensor<double>>;
+        auto d = tamm::dots(ec, VTensor{A, B, A, A}, VTensor{B, B, A, C});
+        REQUIRE(d.size() == 4);
+        REQUIRE(std::abs(d[0] - 600.0) < 1e-12);
+        REQUIRE(std::abs(d[1] - 900.0) < 1e-12);
+        REQUIRE(std::abs(d[2] - 400.0) < 1e-12);
+        REQUIRE(std::abs(d[3] - 600.0) < 1e-12);
+
+        auto n = tamm::norms(ec, VTensor{A, B});
+        REQUIRE(std::abs(n[0] - 20.0) < 1e-12);
+        REQUIRE(std::abs(n[1] - 30.0) < 1e-12);
+
+        // same sizes and largest block, different tiling: the distribution
+        // hashes can agree, but the local buffers do not line up
+        TiledIndexSpace tMO_r{IndexSpace{range(10)}, {1, 3, 3, 3}};
+        auto [k, l] = tMO_r.labels<2>("all");
+        Tensor<double> D{k, l};
+        Scheduler{ec}.allocate(D).execute();
+        REQUIRE(tamm::internal::same_local_layout(ec, A, B));
+        REQUIRE_FALSE(tamm::internal::same_local_layout(ec, A, C));
+        REQUIRE_FALSE(tamm::internal::same_local_layout(ec, A, D));
+
+        Tensor<double>::deallocate(A, B, C, D);
+    }
+
+    SUBCASE("complex") {
+        using T = complex_double;
+        Tensor<T> A{i, j}, B{i, j};
+        Scheduler{ec}.allocate(A, B)(A() = T{1, 2})(B() = T{3, -1}).execute();
+        Tensor<T> C{i, j};
+        Scheduler{ec_dense}.allocate(C)(C() = T{3, -1}).execute();
+
+        // the first tensor is conjugated: (1-2i)(3-i) = 1-7i per element
+        using VTensor = std::vector<Tensor<T>>;
+        auto d = tamm::dots(ec, VTensor{A, A, B}, VTensor{B, C, A});
+        REQUIRE(std::abs(d[0] - T{100, -700}) < 1e-12);
+        REQUIRE(std::abs(d[1] - T{100, -700}) < 1e-12);
+        REQUIRE(std::abs(d[2] - T{100, 700}) < 1e-12);
+
+        auto n = tamm::norms(ec, VTensor{A});
+        REQUIRE(std::abs(n[0] - std::sqrt(500.0)) < 1e-12);
+
+        Tensor<T>::deallocate(A, B, C);
+    }
+}
+
+TEST_CASE("Chunked atomic counter") {
+    ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
+    const int rank       = pg.rank().value();
+    const int64_t ntasks = 1000;
+
+    // every task is handed out once, in increasing order on each rank
+    auto check = [&](bool fetches) {
+        AtomicCounterChunked ac{pg, 1, fetches};
+        ac.allocate(0);
+        ac.set_task_count(0, ntasks);
+        std::vector<int64_t> count(ntasks, 0), g_count(ntasks, 0);
+        if(fetches) {
+            int64_t last = -1;
+            for(int64_t t = ac.fetch_add(0, 1); t < ntasks; t = ac.fetch_add(0, 1)) {
+                REQUIRE(t > last);
+                last = t;
+                count[t]++;
+            }
+        }
+        pg.allreduce(count.data(), g_count.data(), ntasks, ReduceOp::sum);
+        REQUIRE(std::all_of(g_count.begin(), g_count.end(), [](int64_t c) { return c == 1; }));
+        ac.deallocate();
+    };
+
+    SUBCASE("all ranks fetch") { check(true); }
+    SUBCASE("only rank 0 fetches") { check(rank == 0); }
+}
+
 TEST_CASE("One-dimensional ops") {
     bool failed;
     ProcGroup pg = ProcGroup::create_coll(GA_MPI_Comm());
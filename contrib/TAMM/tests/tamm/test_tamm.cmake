@@ -4,6 +4,13 @@ add_cxx_unit_test(Test_IndexSpace)
 add_cxx_unit_test(Test_IndexLoopNest)
 # add_mpi_unit_test(Test_Tensors 2 "")
 add_mpi_unit_test(Test_Ops 2 "")
+add_mpi_unit_test(Test_IO 2 "")
 add_cxx_unit_test(Test_LabeledTensor)
 #add_mpi_unit_test(Test_OpsExpr 2 "")
 add_cxx_unit_test(Test_TiledIndexSpace)
+
+# benchmarks: opt-in, also run by hand (mpirun -n <p> ./Bench_IO [n] [tilesize ...])
+option(TAMM_ENABLE_BENCHMARKS "Build and register the TAMM benchmarks" OFF)
+if(TAMM_ENABLE_BENCHMARKS)
+  add_mpi_unit_test(Bench_IO 2 "")
+endif()
@@ -291,6 +291,10 @@ void ccsd_t_driver() {
                            fs::exists(f1file) && fs::exists(fullV2file);
 
     Tensor<T> d_v2{{N,N,N,N},{2,2}};
+
+    // Unless V2 has to be written to disk, (T) builds its V2 blocks on demand
+    // from the Cholesky vectors and never stores the N^4 tensor.
+    const bool lazy_v2 = !ccsd_options.writev;
     
     auto [MO1,total_orbitals1] = setupMOIS(sys_data,true);
     TiledIndexSpace N1 = MO1("all");
@@ -301,15 +305,19 @@ void ccsd_t_driver() {
     Tensor<T> t_d_t1{{V1,O1},{1,1}};
     Tensor<T> t_d_t2{{V1,V1,O1,O1},{2,2}};
     Tensor<T> t_d_v2{{N1,N1,N1,N1},{2,2}};
+    Tensor<T> t_cholVpr{{N1,N1,CI},{SpinPosition::upper,SpinPosition::lower,SpinPosition::ignore}};
 
-    T ccsd_t_mem = sum_tensor_sizes(d_f1,d_v2,t_d_t1,t_d_t2,t_d_v2);
+    T ccsd_t_mem = sum_tensor_sizes(d_f1,t_d_t1,t_d_t2);
+    if(lazy_v2) ccsd_t_mem += sum_tensor_sizes(cholVpr,t_cholVpr);
+    else ccsd_t_mem += sum_tensor_sizes(d_v2,t_d_v2);
     if(is_rhf) ccsd_t_mem += sum_tensor_sizes(dt1_full,dt2_full);
     else ccsd_t_mem += sum_tensor_sizes(d_t1,d_t2);
     const double Osize = MO("occ").max_num_indices()*8/(1024*1024*1024.0);
     const double Vsize = MO("virt").max_num_indices()*8/(1024*1024*1024.0);
     const double Nsize = N.max_num_indices()*8/(1024*1024*1024.0);
     //retiling allocates full GA versions of the tensors.
-    ccsd_t_mem +=  (Osize*Vsize + Vsize*Vsize*Osize*Osize + Nsize*Nsize*Nsize*Nsize);
+    ccsd_t_mem +=  (Osize*Vsize + Vsize*Vsize*Osize*Osize);
+    if(!lazy_v2) ccsd_t_mem += Nsize*Nsize*Nsize*Nsize;
 
     if(rank==0) {
         std::cout << std::string(70, '-') << std::endl;
@@ -317,7 +325,12 @@ void ccsd_t_driver() {
         std::cout << std::string(70, '-') << std::endl;
     }
 
-    if(computeTData) {
+    if(lazy_v2) {
+        Tensor<T>::allocate(&ec,t_cholVpr);
+        retile_tamm_tensor(cholVpr,t_cholVpr,"CholVpr");
+        t_d_v2 = setupLambdaV2<T>(MO1,CI,t_cholVpr);
+    }
+    else if(computeTData) {
         d_v2 = setupV2<T>(ec,MO,CI,cholVpr,chol_count, ex_hw);
         if(ccsd_options.writev) {
           write_to_disk(d_v2,fullV2file,true);
@@ -339,7 +352,8 @@ void ccsd_t_driver() {
         cout << endl << "CCSD MO Tiles = " << mo_tiles << endl;   
     }
 
-    Tensor<T>::allocate(&ec,t_d_t1,t_d_t2,t_d_v2);
+    Tensor<T>::allocate(&ec,t_d_t1,t_d_t2);
+    if(!lazy_v2) Tensor<T>::allocate(&ec,t_d_v2);
 
     if(!ccsd_t_restart) {
         if(!is_rhf) {
@@ -354,8 +368,8 @@ void ccsd_t_driver() {
         // (t_d_f1() = 0)
         (t_d_t1() = 0)
         (t_d_t2() = 0)
-        (t_d_v2() = 0)
         .execute();
+        if(!lazy_v2) Scheduler{ec}(t_d_v2() = 0).execute();
 
         TiledIndexSpace O = MO("occ");
         TiledIndexSpace V = MO("virt");
@@ -382,8 +396,6 @@ void ccsd_t_driver() {
           retile_tamm_tensor(dt1_full,t_d_t1);
           retile_tamm_tensor(dt2_full,t_d_t2);
           if(is_rhf) free_tensors(dt1_full, dt2_full);
-          retile_tamm_tensor(d_v2,t_d_v2,"V2");
-          free_tensors(d_v2);
         }        
     }
     else if(ccsd_options.writev) {
@@ -415,13 +427,15 @@ void ccsd_t_driver() {
     }
 
     bool seq_h3b=true;
-    Index cache_size=32;
-    LRUCache<Index,std::vector<T>> cache_s1t{cache_size};
-    LRUCache<Index,std::vector<T>> cache_s1v{cache_size};
-    LRUCache<Index,std::vector<T>> cache_d1t{cache_size*noab};
-    LRUCache<Index,std::vector<T>> cache_d1v{cache_size*noab};
-    LRUCache<Index,std::vector<T>> cache_d2t{cache_size*nvab};
-    LRUCache<Index,std::vector<T>> cache_d2v{cache_size*nvab};
+    auto cache_bytes = ccsd_t_cache_bytes(MO1,ccsd_options.ccsdt_cache_mem);
+    LRUCache<Index,std::vector<T>> cache_s1t{cache_bytes[0]};
+    LRUCache<Index,std::vector<T>> cache_s1v{cache_bytes[1]};
+    LRUCache<Index,std::vector<T>> cache_d1t{cache_bytes[2]};
+    LRUCache<Index,std::vector<T>> cache_d1v{cache_bytes[3]};
+    LRUCache<Index,std::vector<T>> cache_d2t{cache_bytes[4]};
+    LRUCache<Index,std::vector<T>> cache_d2v{cache_bytes[5]};
+    if(rank==0) cout << "(T) block caches per rank (MiB) = "
+                      << std::accumulate(cache_bytes.begin(), cache_bytes.end(), 0.0) / (1024*1024.0) << endl;
 
     if(rank==0 && seq_h3b) cout << "running seq h3b loop variant..." << endl;
 
@@ -501,6 +515,13 @@ void ccsd_t_driver() {
     comm_stats("D2-T2 GetTime", ccsdt_d2_t2_GetTime);
     comm_stats("D2-V2 GetTime", ccsdt_d2_v2_GetTime);
 
+    ccsd_t_cache_report(ec, "S1-T1", cache_s1t);
+    ccsd_t_cache_report(ec, "S1-V2", cache_s1v);
+    ccsd_t_cache_report(ec, "D1-T2", cache_d1t);
+    ccsd_t_cache_report(ec, "D1-V2", cache_d1v);
+    ccsd_t_cache_report(ec, "D2-T2", cache_d2t);
+    ccsd_t_cache_report(ec, "D2-V2", cache_d2v);
+
     ccsd_t_data_per_rank = (ccsd_t_data_per_rank * 8.0) / (1024*1024.0*1024); //GB
     double g_ccsd_t_data_per_rank = ec.pg().reduce(&ccsd_t_data_per_rank, ReduceOp::sum, 0);
     if(rank == 0) 
@@ -509,6 +530,7 @@ void ccsd_t_driver() {
     ec.pg().barrier();
 
     free_tensors(t_d_t1, t_d_t2, d_f1, t_d_v2);
+    if(lazy_v2) free_tensors(t_cholVpr);
 
     ec.flush_and_sync();
     // delete ec;
@@ -41,6 +41,96 @@
 //                             double* final_energy_4, double* final_energy_5)
 
 
+// Indices of the t3 tile, fastest first: t3[h3,h2,h1,p6,p5,p4].
+enum { T3_H3, T3_H2, T3_H1, T3_P6, T3_P5, T3_P4 };
+
+// A triples term computed as x = lhs * op(rhs). xidx lists the t3 indices of
+// x fastest first: the outer indices of rhs, then those of lhs.
+struct ccsd_t_cpu_gemm_term {
+    int xidx[6];
+    double sign;
+};
+
+// sd1_k: t3[h3,h2,h1,p6,p5,p4] (+/-)= t2[h7,a,b,c] * v2[x,y,z,h7]
+static const ccsd_t_cpu_gemm_term ccsd_t_cpu_d1_terms[9] = {
+    {{T3_H3, T3_H2, T3_P6, T3_P4, T3_P5, T3_H1}, -1.0},
+    {{T3_H3, T3_H1, T3_P6, T3_P4, T3_P5, T3_H2}, +1.0},
+    {{T3_H2, T3_H1, T3_P6, T3_P4, T3_P5, T3_H3}, -1.0},
+    {{T3_H3, T3_H2, T3_P4, T3_P5, T3_P6, T3_H1}, -1.0},
+    {{T3_H3, T3_H1, T3_P4, T3_P5, T3_P6, T3_H2}, +1.0},
+    {{T3_H2, T3_H1, T3_P4, T3_P5, T3_P6, T3_H3}, -1.0},
+    {{T3_H3, T3_H2, T3_P5, T3_P4, T3_P6, T3_H1}, +1.0},
+    {{T3_H3, T3_H1, T3_P5, T3_P4, T3_P6, T3_H2}, -1.0},
+    {{T3_H2, T3_H1, T3_P5, T3_P4, T3_P6, T3_H3}, +1.0}};
+
+// sd2_k: t3[h3,h2,h1,p6,p5,p4] (+/-)= t2[p7,a,b,c] * v2[p7,x,y,z]
+static const ccsd_t_cpu_gemm_term ccsd_t_cpu_d2_terms[9] = {
+    {{T3_H3, T3_P6, T3_P5, T3_P4, T3_H1, T3_H2}, -1.0},
+    {{T3_H1, T3_P6, T3_P5, T3_P4, T3_H2, T3_H3}, -1.0},
+    {{T3_H2, T3_P6, T3_P5, T3_P4, T3_H1, T3_H3}, +1.0},
+    {{T3_H3, T3_P6, T3_P4, T3_P5, T3_H1, T3_H2}, +1.0},
+    {{T3_H1, T3_P6, T3_P4, T3_P5, T3_H2, T3_H3}, +1.0},
+    {{T3_H2, T3_P6, T3_P4, T3_P5, T3_H1, T3_H3}, -1.0},
+    {{T3_H3, T3_P5, T3_P4, T3_P6, T3_H1, T3_H2}, -1.0},
+    {{T3_H1, T3_P5, T3_P4, T3_P6, T3_H2, T3_H3}, -1.0},
+    {{T3_H2, T3_P5, T3_P4, T3_P6, T3_H1, T3_H3}, +1.0}};
+
+// s1_k: t3[h3,h2,h1,p6,p5,p4] (+/-)= t1[a,b] * v2[x,y,z,w]
+static const ccsd_t_cpu_gemm_term ccsd_t_cpu_s1_terms[9] = {
+    {{T3_H3, T3_H2, T3_P6, T3_P5, T3_P4, T3_H1}, +1.0},
+    {{T3_H3, T3_H1, T3_P6, T3_P5, T3_P4, T3_H2}, -1.0},
+    {{T3_H2, T3_H1, T3_P6, T3_P5, T3_P4, T3_H3}, +1.0},
+    {{T3_H3, T3_H2, T3_P6, T3_P4, T3_P5, T3_H1}, -1.0},
+    {{T3_H3, T3_H1, T3_P6, T3_P4, T3_P5, T3_H2}, +1.0},
+    {{T3_H2, T3_H1, T3_P6, T3_P4, T3_P5, T3_H3}, -1.0},
+    {{T3_H3, T3_H2, T3_P5, T3_P4, T3_P6, T3_H1}, +1.0},
+    {{T3_H3, T3_H1, T3_P5, T3_P4, T3_P6, T3_H2}, -1.0},
+    {{T3_H2, T3_H1, T3_P5, T3_P4, T3_P6, T3_H3}, +1.0}};
+
+// x = sign * lhs * op(rhs) with lhs [rows x K] and rhs [K x cols] (or [cols x K]
+// when rhs_trans), then scatter-add x into t3. The first ncols entries of
+// xidx are the column indices, the rest the row indices.
+inline void ccsd_t_cpu_term(double* t3, const int t3_dims[6], const int xidx[6], int ncols, int K,
+                            const double* lhs, const double* rhs, bool rhs_trans, double sign,
+                            double* x)
+{
+    size_t t3_stride[6];
+    t3_stride[0] = 1;
+    for (int i = 1; i < 6; i++) t3_stride[i] = t3_stride[i - 1] * t3_dims[i - 1];
+
+    int    d[6];
+    size_t st[6];
+    int64_t N = 1, M = 1;
+    for (int i = 0; i < 6; i++)
+    {
+        d[i]  = t3_dims[xidx[i]];
+        st[i] = t3_stride[xidx[i]];
+        if (i < ncols) N *= d[i];
+        else M *= d[i];
+    }
+
+    blas::gemm(blas::Layout::RowMajor, blas::Op::NoTrans,
+               rhs_trans ? blas::Op::Trans : blas::Op::NoTrans, M, N, K, sign,
+               lhs, K, rhs, rhs_trans ? K : N, 0.0, x, N);
+
+    const size_t inner = (size_t)d[0] * d[1] * d[2];
+    #pragma omp parallel for collapse(3)
+    for (int i5 = 0; i5 < d[5]; i5++)
+    for (int i4 = 0; i4 < d[4]; i4++)
+    for (int i3 = 0; i3 < d[3]; i3++)
+    {
+        const double* xp = x + (((size_t)i5 * d[4] + i4) * d[3] + i3) * inner;
+        double*       tp = t3 + i5 * st[5] + i4 * st[4] + i3 * st[3];
+        for (int i2 = 0; i2 < d[2]; i2++)
+        for (int i1 = 0; i1 < d[1]; i1++)
+        {
+            #pragma omp simd
+            for (int i0 = 0; i0 < d[0]; i0++)
+                tp[i2 * st[2] + i1 * st[1] + i0 * st[0]] += xp[(i2 * d[1] + i1) * d[0] + i0];
+        }
+    }
+}
+
 template<typename T>
 void total_fused_ccsd_t_cpu(bool is_restricted, const Index noab, const Index nvab, int64_t rank,
                             std::vector<int>& k_spin,
@@ -151,380 +241,62 @@ void total_fused_ccsd_t_cpu(bool is_restricted, const Index noab, const Index nv
     size_t size_tensor_t3 = base_size_h3b * base_size_h2b * base_size_h1b * base_size_p6b * base_size_p5b * base_size_p4b;
 
     //
-    double* host_t3_d = (double*)malloc(sizeof(double) * size_tensor_t3);
-    double* host_t3_s = (double*)malloc(sizeof(double) * size_tensor_t3);
+    std::vector<double> host_t3_d(size_tensor_t3, 0.0);
+    std::vector<double> host_t3_s(size_tensor_t3, 0.0);
+    std::vector<double> host_t3_x(size_tensor_t3);
 
-    for (size_t i = 0; i < size_tensor_t3; i++)
+    // d1: t3 (+/-)= t2[h7,a,b,c] * v2[x,y,z,h7] as one GEMM over h7 per term
+    for (size_t idx_noab = 0; idx_noab < noab; idx_noab++)
     {
-        host_t3_d[i] = 0.000;
-        host_t3_s[i] = 0.000;
-    }
+        const int* d1_size = df_simple_d1_size + idx_noab * 7;
+        const int t3_dims[6] = {d1_size[2], d1_size[1], d1_size[0], d1_size[6], d1_size[5], d1_size[4]};
 
-    //
-    //for (size_t idx_ia6 = 0; idx_ia6 < 9; idx_ia6++){
-        // d1
-        for (size_t idx_noab = 0; idx_noab < noab; idx_noab++)
+        for (int k = 0; k < 9; k++)
         {
-            int flag_d1_1 = (int)df_simple_d1_exec[0 + (idx_noab) * 9];
-            int flag_d1_2 = (int)df_simple_d1_exec[1 + (idx_noab) * 9];
-            int flag_d1_3 = (int)df_simple_d1_exec[2 + (idx_noab) * 9];
-            int flag_d1_4 = (int)df_simple_d1_exec[3 + (idx_noab) * 9];
-            int flag_d1_5 = (int)df_simple_d1_exec[4 + (idx_noab) * 9];
-            int flag_d1_6 = (int)df_simple_d1_exec[5 + (idx_noab) * 9];
-            int flag_d1_7 = (int)df_simple_d1_exec[6 + (idx_noab) * 9];
-            int flag_d1_8 = (int)df_simple_d1_exec[7 + (idx_noab) * 9];
-            int flag_d1_9 = (int)df_simple_d1_exec[8 + (idx_noab) * 9];
-
-            int d1_base_size_h1b = (int)df_simple_d1_size[0 + (idx_noab) * 7];
-            int d1_base_size_h2b = (int)df_simple_d1_size[1 + (idx_noab) * 7];
-            int d1_base_size_h3b = (int)df_simple_d1_size[2 + (idx_noab) * 7];
-            int d1_base_size_h7b = (int)df_simple_d1_size[3 + (idx_noab) * 7];
-            int d1_base_size_p4b = (int)df_simple_d1_size[4 + (idx_noab) * 7];
-            int d1_base_size_p5b = (int)df_simple_d1_size[5 + (idx_noab) * 7];
-            int d1_base_size_p6b = (int)df_simple_d1_size[6 + (idx_noab) * 7];
-
-            double* host_d1_t2_1 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_1;
-            double* host_d1_v2_1 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_1;
-            double* host_d1_t2_2 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_2;
-            double* host_d1_v2_2 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_2;
-            double* host_d1_t2_3 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_3;
-            double* host_d1_v2_3 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_3;
-            double* host_d1_t2_4 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_4;
-            double* host_d1_v2_4 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_4;
-            double* host_d1_t2_5 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_5;
-            double* host_d1_v2_5 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_5;
-            double* host_d1_t2_6 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_6;
-            double* host_d1_v2_6 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_6;
-            double* host_d1_t2_7 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_7;
-            double* host_d1_v2_7 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_7;
-            double* host_d1_t2_8 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_8;
-            double* host_d1_v2_8 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_8;
-            double* host_d1_t2_9 = df_host_pinned_d1_t2 + max_dim_d1_t2 * flag_d1_9;
-            double* host_d1_v2_9 = df_host_pinned_d1_v2 + max_dim_d1_v2 * flag_d1_9;
-
-            #pragma omp parallel for collapse(6)
-            for (int t3_h3 = 0; t3_h3 < d1_base_size_h3b; t3_h3++)
-            for (int t3_h2 = 0; t3_h2 < d1_base_size_h2b; t3_h2++)
-            for (int t3_h1 = 0; t3_h1 < d1_base_size_h1b; t3_h1++)
-            for (int t3_p6 = 0; t3_p6 < d1_base_size_p6b; t3_p6++)
-            for (int t3_p5 = 0; t3_p5 < d1_base_size_p5b; t3_p5++)
-            for (int t3_p4 = 0; t3_p4 < d1_base_size_p4b; t3_p4++)
-            {
-                int t3_idx = t3_h3 + (t3_h2 + (t3_h1 + (t3_p6 + (t3_p5 + (t3_p4) * d1_base_size_p5b) * d1_base_size_p6b) * d1_base_size_h1b) * d1_base_size_h2b) * d1_base_size_h3b;
-
-                for (int t3_h7 = 0; t3_h7 < d1_base_size_h7b; t3_h7++)
-                {
-                    // sd1_1:  t3[h3,h2,h1,p6,p5,p4] -= t2[h7,p4,p5,h1] * v2[h3,h2,p6,h7]
-                    if (flag_d1_1 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d1_t2_1[t3_h7 + (t3_p4 + (t3_p5 + (t3_h1) * d1_base_size_p5b) * d1_base_size_p4b) * d1_base_size_h7b] *
-                                             host_d1_v2_1[t3_h3 + (t3_h2 + (t3_p6 + (t3_h7) * d1_base_size_p6b) * d1_base_size_h2b) * d1_base_size_h3b];
-                    }
-
-                    // sd1_2:  t3[h3,h2,h1,p6,p5,p4] += t2[h7,p4,p5,h2] * v2[h3,h1,p6,h7]
-                    if (flag_d1_2 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d1_t2_2[t3_h7 + (t3_p4 + (t3_p5 + (t3_h2) * d1_base_size_p5b) * d1_base_size_p4b) * d1_base_size_h7b] *
-                                             host_d1_v2_2[t3_h3 + (t3_h1 + (t3_p6 + (t3_h7) * d1_base_size_p6b) * d1_base_size_h1b) * d1_base_size_h3b];
-                    }
-
-                    // sd1_3:  t3[h3,h2,h1,p6,p5,p4] -= t2[h7,p4,p5,h3] * v2[h2,h1,p6,h7]
-                    if (flag_d1_3 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d1_t2_3[t3_h7 + (t3_p4 + (t3_p5 + (t3_h3) * d1_base_size_p5b) * d1_base_size_p4b) * d1_base_size_h7b] *
-                                             host_d1_v2_3[t3_h2 + (t3_h1 + (t3_p6 + (t3_h7) * d1_base_size_p6b) * d1_base_size_h1b) * d1_base_size_h2b];
-                    }
-
-                    // sd1_4:  t3[h3,h2,h1,p6,p5,p4] -= t2[h7,p5,p6,h1] * v2[h3,h2,p4,h7]
-                    if (flag_d1_4 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d1_t2_4[t3_h7 + (t3_p5 + (t3_p6 + (t3_h1) * d1_base_size_p6b) * d1_base_size_p5b) * d1_base_size_h7b] *
-                                             host_d1_v2_4[t3_h3 + (t3_h2 + (t3_p4 + (t3_h7) * d1_base_size_p4b) * d1_base_size_h2b) * d1_base_size_h3b];
-                    }
-
-                    // sd1_5:  t3[h3,h2,h1,p6,p5,p4] += t2[h7,p5,p6,h2] * v2[h3,h1,p4,h7]
-                    if (flag_d1_5 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d1_t2_5[t3_h7 + (t3_p5 + (t3_p6 + (t3_h2) * d1_base_size_p6b) * d1_base_size_p5b) * d1_base_size_h7b] *
-                                             host_d1_v2_5[t3_h3 + (t3_h1 + (t3_p4 + (t3_h7) * d1_base_size_p4b) * d1_base_size_h1b) * d1_base_size_h3b];
-                    }
-
-                    // sd1_6:  t3[h3,h2,h1,p6,p5,p4] -= t2[h7,p5,p6,h3] * v2[h2,h1,p4,h7]
-                    if (flag_d1_6 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d1_t2_6[t3_h7 + (t3_p5 + (t3_p6 + (t3_h3) * d1_base_size_p6b) * d1_base_size_p5b) * d1_base_size_h7b] *
-                                             host_d1_v2_6[t3_h2 + (t3_h1 + (t3_p4 + (t3_h7) * d1_base_size_p4b) * d1_base_size_h1b) * d1_base_size_h2b];
-                    }
-
-                    // sd1_7:  t3[h3,h2,h1,p6,p5,p4] += t2[h7,p4,p6,h1] * v2[h3,h2,p5,h7]
-                    if (flag_d1_7 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d1_t2_7[t3_h7 + (t3_p4 + (t3_p6 + (t3_h1) * d1_base_size_p6b) * d1_base_size_p4b) * d1_base_size_h7b] *
-                                             host_d1_v2_7[t3_h3 + (t3_h2 + (t3_p5 + (t3_h7) * d1_base_size_p5b) * d1_base_size_h2b) * d1_base_size_h3b];
-                    }
-
-                    // sd1_8:  t3[h3,h2,h1,p6,p5,p4] -= t2[h7,p4,p6,h2] * v2[h3,h1,p5,h7]
-                    if (flag_d1_8 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d1_t2_8[t3_h7 + (t3_p4 + (t3_p6 + (t3_h2) * d1_base_size_p6b) * d1_base_size_p4b) * d1_base_size_h7b] *
-                                             host_d1_v2_8[t3_h3 + (t3_h1 + (t3_p5 + (t3_h7) * d1_base_size_p5b) * d1_base_size_h1b) * d1_base_size_h3b];
-                    }
-
-                    // sd1_9:  t3[h3,h2,h1,p6,p5,p4] += t2[h7,p4,p6,h3] * v2[h2,h1,p5,h7]
-                    if (flag_d1_9 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d1_t2_9[t3_h7 + (t3_p4 + (t3_p6 + (t3_h3) * d1_base_size_p6b) * d1_base_size_p4b) * d1_base_size_h7b] *
-                                             host_d1_v2_9[t3_h2 + (t3_h1 + (t3_p5 + (t3_h7) * d1_base_size_p5b) * d1_base_size_h1b) * d1_base_size_h2b];
-                    }
-                }
-            }
+            const int flag = df_simple_d1_exec[k + idx_noab * 9];
+            if (flag < 0) continue;
+            const auto& term = ccsd_t_cpu_d1_terms[k];
+            ccsd_t_cpu_term(host_t3_d.data(), t3_dims, term.xidx, 3, d1_size[3],
+                            df_host_pinned_d1_t2 + max_dim_d1_t2 * flag,
+                            df_host_pinned_d1_v2 + max_dim_d1_v2 * flag, false,
+                            term.sign, host_t3_x.data());
         }
+    }
+
+    // d2: t3 (+/-)= t2[p7,a,b,c] * v2[p7,x,y,z] as one GEMM over p7 per term
+    for (size_t idx_nvab = 0; idx_nvab < nvab; idx_nvab++)
+    {
+        const int* d2_size = df_simple_d2_size + idx_nvab * 7;
+        const int t3_dims[6] = {d2_size[2], d2_size[1], d2_size[0], d2_size[5], d2_size[4], d2_size[3]};
 
-        // d2
-        for (size_t idx_nvab = 0; idx_nvab < nvab; idx_nvab++)
+        for (int k = 0; k < 9; k++)
         {
-            int flag_d2_1 = (int)df_simple_d2_exec[0 + (idx_nvab) * 9];
-            int flag_d2_2 = (int)df_simple_d2_exec[1 + (idx_nvab) * 9];
-            int flag_d2_3 = (int)df_simple_d2_exec[2 + (idx_nvab) * 9];
-            int flag_d2_4 = (int)df_simple_d2_exec[3 + (idx_nvab) * 9];
-            int flag_d2_5 = (int)df_simple_d2_exec[4 + (idx_nvab) * 9];
-            int flag_d2_6 = (int)df_simple_d2_exec[5 + (idx_nvab) * 9];
-            int flag_d2_7 = (int)df_simple_d2_exec[6 + (idx_nvab) * 9];
-            int flag_d2_8 = (int)df_simple_d2_exec[7 + (idx_nvab) * 9];
-            int flag_d2_9 = (int)df_simple_d2_exec[8 + (idx_nvab) * 9];
-
-            int d2_base_size_h1b = (int)df_simple_d2_size[0 + (idx_nvab) * 7];
-            int d2_base_size_h2b = (int)df_simple_d2_size[1 + (idx_nvab) * 7];
-            int d2_base_size_h3b = (int)df_simple_d2_size[2 + (idx_nvab) * 7];
-            int d2_base_size_p4b = (int)df_simple_d2_size[3 + (idx_nvab) * 7];
-            int d2_base_size_p5b = (int)df_simple_d2_size[4 + (idx_nvab) * 7];
-            int d2_base_size_p6b = (int)df_simple_d2_size[5 + (idx_nvab) * 7];
-            int d2_base_size_p7b = (int)df_simple_d2_size[6 + (idx_nvab) * 7];
-
-            double* host_d2_t2_1 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_1;
-            double* host_d2_v2_1 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_1;
-            double* host_d2_t2_2 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_2;
-            double* host_d2_v2_2 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_2;
-            double* host_d2_t2_3 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_3;
-            double* host_d2_v2_3 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_3;
-            double* host_d2_t2_4 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_4;
-            double* host_d2_v2_4 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_4;
-            double* host_d2_t2_5 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_5;
-            double* host_d2_v2_5 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_5;
-            double* host_d2_t2_6 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_6;
-            double* host_d2_v2_6 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_6;
-            double* host_d2_t2_7 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_7;
-            double* host_d2_v2_7 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_7;
-            double* host_d2_t2_8 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_8;
-            double* host_d2_v2_8 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_8;
-            double* host_d2_t2_9 = df_host_pinned_d2_t2 + max_dim_d2_t2 * flag_d2_9;
-            double* host_d2_v2_9 = df_host_pinned_d2_v2 + max_dim_d2_v2 * flag_d2_9;
-
-            #pragma omp parallel for collapse(6)
-            for (int t3_h3 = 0; t3_h3 < d2_base_size_h3b; t3_h3++)
-            for (int t3_h2 = 0; t3_h2 < d2_base_size_h2b; t3_h2++)
-            for (int t3_h1 = 0; t3_h1 < d2_base_size_h1b; t3_h1++)
-            for (int t3_p6 = 0; t3_p6 < d2_base_size_p6b; t3_p6++)
-            for (int t3_p5 = 0; t3_p5 < d2_base_size_p5b; t3_p5++)
-            for (int t3_p4 = 0; t3_p4 < d2_base_size_p4b; t3_p4++)
-            {
-                int t3_idx = t3_h3 + (t3_h2 + (t3_h1 + (t3_p6 + (t3_p5 + (t3_p4) * d2_base_size_p5b) * d2_base_size_p6b) * d2_base_size_h1b) * d2_base_size_h2b) * d2_base_size_h3b;
-
-                for (int t3_p7 = 0; t3_p7 < d2_base_size_p7b; t3_p7++)
-                {
-                    // sd2_1:  t3[h3,h2,h1,p6,p5,p4] −= t2[p7,p4,h1,h2] * v2[p7,h3,p6,p5]
-                    if (flag_d2_1 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d2_t2_1[t3_p7 + (t3_p4 + (t3_h1 + (t3_h2) * d2_base_size_h1b) * d2_base_size_p4b) * d2_base_size_p7b] *
-                                             host_d2_v2_1[t3_p7 + (t3_h3 + (t3_p6 + (t3_p5) * d2_base_size_p6b) * d2_base_size_h3b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_2:  t3[h3,h2,h1,p6,p5,p4] −= t2[p7,p4,h2,h3] * v2[p7,h1,p6,p5]
-                    if (flag_d2_2 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d2_t2_2[t3_p7 + (t3_p4 + (t3_h2 + (t3_h3) * d2_base_size_h2b) * d2_base_size_p4b) * d2_base_size_p7b] *
-                                             host_d2_v2_2[t3_p7 + (t3_h1 + (t3_p6 + (t3_p5) * d2_base_size_p6b) * d2_base_size_h1b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_3:  t3[h3,h2,h1,p6,p5,p4] += t2[p7,p4,h1,h3] * v2[p7,h2,p6,p5]
-                    if (flag_d2_3 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d2_t2_3[t3_p7 + (t3_p4 + (t3_h1 + (t3_h3) * d2_base_size_h1b) * d2_base_size_p4b) * d2_base_size_p7b] *
-                                             host_d2_v2_3[t3_p7 + (t3_h2 + (t3_p6 + (t3_p5) * d2_base_size_p6b) * d2_base_size_h2b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_4:  t3[h3,h2,h1,p6,p5,p4] += t2[p7,p5,h1,h2] * v2[p7,h3,p6,p4]
-                    if (flag_d2_4 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d2_t2_4[t3_p7 + (t3_p5 + (t3_h1 + (t3_h2) * d2_base_size_h1b) * d2_base_size_p5b) * d2_base_size_p7b] *
-                                             host_d2_v2_4[t3_p7 + (t3_h3 + (t3_p6 + (t3_p4) * d2_base_size_p6b) * d2_base_size_h3b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_5:  t3[h3,h2,h1,p6,p5,p4] += t2[p7,p5,h2,h3] * v2[p7,h1,p6,p4]
-                    if (flag_d2_5 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d2_t2_5[t3_p7 + (t3_p5 + (t3_h2 + (t3_h3) * d2_base_size_h2b) * d2_base_size_p5b) * d2_base_size_p7b] *
-                                             host_d2_v2_5[t3_p7 + (t3_h1 + (t3_p6 + (t3_p4) * d2_base_size_p6b) * d2_base_size_h1b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_6:  t3[h3,h2,h1,p6,p5,p4] −= t2[p7,p5,h1,h3] * v2[p7,h2,p6,p4]
-                    if (flag_d2_6 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d2_t2_6[t3_p7 + (t3_p5 + (t3_h1 + (t3_h3) * d2_base_size_h1b) * d2_base_size_p5b) * d2_base_size_p7b] *
-                                             host_d2_v2_6[t3_p7 + (t3_h2 + (t3_p6 + (t3_p4) * d2_base_size_p6b) * d2_base_size_h2b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_7:  t3[h3,h2,h1,p6,p5,p4] −= t2[p7,p6,h1,h2] * v2[p7,h3,p5,p4]
-                    if (flag_d2_7 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d2_t2_7[t3_p7 + (t3_p6 + (t3_h1 + (t3_h2) * d2_base_size_h1b) * d2_base_size_p6b) * d2_base_size_p7b] *
-                                             host_d2_v2_7[t3_p7 + (t3_h3 + (t3_p5 + (t3_p4) * d2_base_size_p5b) * d2_base_size_h3b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_8:  t3[h3,h2,h1,p6,p5,p4] −= t2[p7,p6,h2,h3] * v2[p7,h1,p5,p4]
-                    if (flag_d2_8 >= 0)
-                    {
-                        host_t3_d[t3_idx] -= host_d2_t2_8[t3_p7 + (t3_p6 + (t3_h2 + (t3_h3) * d2_base_size_h2b) * d2_base_size_p6b) * d2_base_size_p7b] *
-                                             host_d2_v2_8[t3_p7 + (t3_h1 + (t3_p5 + (t3_p4) * d2_base_size_p5b) * d2_base_size_h1b) * d2_base_size_p7b];
-                    }
-
-                    // sd2_9:  t3[h3,h2,h1,p6,p5,p4] += t2[p7,p6,h1,h3] * v2[p7,h2,p5,p4]
-                    if (flag_d2_9 >= 0)
-                    {
-                        host_t3_d[t3_idx] += host_d2_t2_9[t3_p7 + (t3_p6 + (t3_h1 + (t3_h3) * d2_base_size_h1b) * d2_base_size_p6b) * d2_base_size_p7b] *
-                                             host_d2_v2_9[t3_p7 + (t3_h2 + (t3_p5 + (t3_p4) * d2_base_size_p5b) * d2_base_size_h2b) * d2_base_size_p7b];
-                    }
-                }
-            }
+            const int flag = df_simple_d2_exec[k + idx_nvab * 9];
+            if (flag < 0) continue;
+            const auto& term = ccsd_t_cpu_d2_terms[k];
+            ccsd_t_cpu_term(host_t3_d.data(), t3_dims, term.xidx, 3, d2_size[6],
+                            df_host_pinned_d2_t2 + max_dim_d2_t2 * flag,
+                            df_host_pinned_d2_v2 + max_dim_d2_v2 * flag, true,
+                            term.sign, host_t3_x.data());
         }
+    }
+
+    // s1: t3 (+/-)= t1[a,b] * v2[x,y,z,w], an outer product (GEMM with K = 1)
+    {
+        const int t3_dims[6] = {df_simple_s1_size[2], df_simple_s1_size[1], df_simple_s1_size[0],
+                                df_simple_s1_size[5], df_simple_s1_size[4], df_simple_s1_size[3]};
 
-        // s1
+        for (int k = 0; k < 9; k++)
         {
-            // 	flags
-			int flag_s1_1 = (int)df_simple_s1_exec[0];
-			int flag_s1_2 = (int)df_simple_s1_exec[1];
-			int flag_s1_3 = (int)df_simple_s1_exec[2];
-			int flag_s1_4 = (int)df_simple_s1_exec[3];
-			int flag_s1_5 = (int)df_simple_s1_exec[4];
-			int flag_s1_6 = (int)df_simple_s1_exec[5];
-			int flag_s1_7 = (int)df_simple_s1_exec[6];
-			int flag_s1_8 = (int)df_simple_s1_exec[7];
-			int flag_s1_9 = (int)df_simple_s1_exec[8];
-
-            int s1_base_size_h1b = (int)df_simple_s1_size[0];
-			int s1_base_size_h2b = (int)df_simple_s1_size[1];
-			int s1_base_size_h3b = (int)df_simple_s1_size[2];
-			int s1_base_size_p4b = (int)df_simple_s1_size[3];
-			int s1_base_size_p5b = (int)df_simple_s1_size[4];
-			int s1_base_size_p6b = (int)df_simple_s1_size[5];
-
-            double* host_s1_t2;
-            double* host_s1_v2;
-
-            //
-            #pragma omp parallel for collapse(6)
-            for (int t3_h3 = 0; t3_h3 < s1_base_size_h3b; t3_h3++)
-            for (int t3_h2 = 0; t3_h2 < s1_base_size_h2b; t3_h2++)
-            for (int t3_h1 = 0; t3_h1 < s1_base_size_h1b; t3_h1++)
-            for (int t3_p6 = 0; t3_p6 < s1_base_size_p6b; t3_p6++)
-            for (int t3_p5 = 0; t3_p5 < s1_base_size_p5b; t3_p5++)
-            for (int t3_p4 = 0; t3_p4 < s1_base_size_p4b; t3_p4++)
-            {
-                int t3_idx = t3_h3 + (t3_h2 + (t3_h1 + (t3_p6 + (t3_p5 + (t3_p4) * s1_base_size_p5b) * s1_base_size_p6b) * s1_base_size_h1b) * s1_base_size_h2b) * s1_base_size_h3b;
-
-                //  s1_1: t3[h3,h2,h1,p6,p5,p4] += t1[p4,h1] * v2[h3,h2,p6,p5]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_1;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_1;
-
-                if (flag_s1_1 >= 0)
-                {
-                    host_t3_s[t3_idx] += host_s1_t2[t3_p4 + (t3_h1) * s1_base_size_p4b] *
-                                         host_s1_v2[t3_h3 + (t3_h2 + (t3_p6 + (t3_p5) * s1_base_size_p6b) * s1_base_size_h2b) * s1_base_size_h3b];
-
-                }
-
-                // s1_2: t3[h3,h2,h1,p6,p5,p4] -= t1[p4,h2] * v2[h3,h1,p6,p5]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_2;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_2;
-
-                if (flag_s1_2 >= 0)
-                {
-                    host_t3_s[t3_idx] -= host_s1_t2[t3_p4 + (t3_h2) * s1_base_size_p4b] *
-                                         host_s1_v2[t3_h3 + (t3_h1 + (t3_p6 + (t3_p5) * s1_base_size_p6b) * s1_base_size_h1b) * s1_base_size_h3b];
-                }
-
-                // s1_3: t3[h3,h2,h1,p6,p5,p4] += t1[p4,h3] * v2[h2,h1,p6,p5]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_3;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_3;
-
-                if (flag_s1_3 >= 0)
-                {
-                    host_t3_s[t3_idx] += host_s1_t2[t3_p4 + (t3_h3) * s1_base_size_p4b] *
-                                         host_s1_v2[t3_h2 + (t3_h1 + (t3_p6 + (t3_p5) * s1_base_size_p6b) * s1_base_size_h1b) * s1_base_size_h2b];
-                }
-
-                // s1_4:   t3[h3,h2,h1,p6,p5,p4] -= t1[p5,h1] * v2[h3,h2,p6,p4]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_4;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_4;
-
-                if (flag_s1_4 >= 0)
-                {
-                    host_t3_s[t3_idx] -= host_s1_t2[t3_p5 + (t3_h1) * s1_base_size_p5b] *
-                                         host_s1_v2[t3_h3 + (t3_h2 + (t3_p6 + (t3_p4) * s1_base_size_p6b) * s1_base_size_h2b) * s1_base_size_h3b];
-                }
-
-                // s1_5:   t3[h3,h2,h1,p6,p5,p4] += t1[p5,h2] * v2[h3,h1,p6,p4]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_5;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_5;
-
-                if (flag_s1_5 >= 0)
-                {
-                    host_t3_s[t3_idx] += host_s1_t2[t3_p5 + (t3_h2) * s1_base_size_p5b] *
-                                         host_s1_v2[t3_h3 + (t3_h1 + (t3_p6 + (t3_p4) * s1_base_size_p6b) * s1_base_size_h1b) * s1_base_size_h3b];
-                }
-
-                // s1_6:   t3[h3,h2,h1,p6,p5,p4] -= t1[p5,h3] * v2[h2,h1,p6,p4]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_6;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_6;
-
-                if (flag_s1_6 >= 0)
-                {
-                    host_t3_s[t3_idx] -= host_s1_t2[t3_p5 + (t3_h3) * s1_base_size_p5b] *
-                                         host_s1_v2[t3_h2 + (t3_h1 + (t3_p6 + (t3_p4) * s1_base_size_p6b) * s1_base_size_h1b) * s1_base_size_h2b];
-                }
-
-                // s1_7:   t3[h3,h2,h1,p6,p5,p4] -= t1[p6,h1] * v2[h3,h2,p5,p4]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_7;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_7;
-
-                if (flag_s1_7 >= 0)
-                {
-                    host_t3_s[t3_idx] += host_s1_t2[t3_p6 + (t3_h1) * s1_base_size_p6b] *
-                                         host_s1_v2[t3_h3 + (t3_h2 + (t3_p5 + (t3_p4) * s1_base_size_p5b) * s1_base_size_h2b) * s1_base_size_h3b];
-                }
-
-                // s1_8:   t3[h3,h2,h1,p6,p5,p4] -= t1[p6,h2] * v2[h3,h1,p5,p4]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_8;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_8;
-
-                if (flag_s1_8 >= 0)
-                {
-                    host_t3_s[t3_idx] -= host_s1_t2[t3_p6 + (t3_h2) * s1_base_size_p6b] *
-                                         host_s1_v2[t3_h3 + (t3_h1 + (t3_p5 + (t3_p4) * s1_base_size_p5b) * s1_base_size_h1b) * s1_base_size_h3b];
-                }
-
-                // s1_9:   t3[h3,h2,h1,p6,p5,p4] -= t1[p6,h3] * v2[h2,h1,p5,p4]
-                host_s1_t2 = df_host_pinned_s1_t1 + max_dim_s1_t1 * flag_s1_9;
-				host_s1_v2 = df_host_pinned_s1_v2 + max_dim_s1_v2 * flag_s1_9;
-
-                if (flag_s1_9 >= 0)
-                {
-                    host_t3_s[t3_idx] += host_s1_t2[t3_p6 + (t3_h3) * s1_base_size_p6b] *
-                                         host_s1_v2[t3_h2 + (t3_h1 + (t3_p5 + (t3_p4) * s1_base_size_p5b) * s1_base_size_h1b) * s1_base_size_h2b];
-                }
-            }
+            const int flag = df_simple_s1_exec[k];
+            if (flag < 0) continue;
+            const auto& term = ccsd_t_cpu_s1_terms[k];
+            ccsd_t_cpu_term(host_t3_s.data(), t3_dims, term.xidx, 4, 1,
+                            df_host_pinned_s1_t1 + max_dim_s1_t1 * flag,
+                            df_host_pinned_s1_v2 + max_dim_s1_v2 * flag, false,
+                            term.sign, host_t3_x.data());
         }
-    //} //idx_ia6
+    }
 
     //
     //  to calculate energies--- E(4) and E(5)
@@ -532,30 +304,32 @@ void total_fused_ccsd_t_cpu(bool is_restricted, const Index noab, const Index nv
     double final_energy_1 = 0.0;
     double final_energy_2 = 0.0;
 
-    int size_idx_h1 = (int)base_size_h1b;
-    int size_idx_h2 = (int)base_size_h2b;
-    int size_idx_h3 = (int)base_size_h3b;
-    int size_idx_p4 = (int)base_size_p4b;
-    int size_idx_p5 = (int)base_size_p5b;
-    int size_idx_p6 = (int)base_size_p6b;
-
-    //
-    for (int idx_p4 = 0; idx_p4 < size_idx_p4; idx_p4++)
-    for (int idx_p5 = 0; idx_p5 < size_idx_p5; idx_p5++)
-    for (int idx_p6 = 0; idx_p6 < size_idx_p6; idx_p6++)
-    for (int idx_h1 = 0; idx_h1 < size_idx_h1; idx_h1++)
-    for (int idx_h2 = 0; idx_h2 < size_idx_h2; idx_h2++)
-    for (int idx_h3 = 0; idx_h3 < size_idx_h3; idx_h3++)
+    const size_t size_h = base_size_h3b * base_size_h2b * base_size_h1b;
+    const size_t size_p = base_size_p6b * base_size_p5b * base_size_p4b;
+
+    // the denominator splits into an occupied and a virtual part
+    std::vector<double> evl_h(size_h), evl_p(size_p);
+    for (size_t idx_h1 = 0, i = 0; idx_h1 < base_size_h1b; idx_h1++)
+    for (size_t idx_h2 = 0; idx_h2 < base_size_h2b; idx_h2++)
+    for (size_t idx_h3 = 0; idx_h3 < base_size_h3b; idx_h3++, i++)
+        evl_h[i] = host_evl_sorted_h3b[idx_h3] + host_evl_sorted_h2b[idx_h2] + host_evl_sorted_h1b[idx_h1];
+    for (size_t idx_p4 = 0, i = 0; idx_p4 < base_size_p4b; idx_p4++)
+    for (size_t idx_p5 = 0; idx_p5 < base_size_p5b; idx_p5++)
+    for (size_t idx_p6 = 0; idx_p6 < base_size_p6b; idx_p6++, i++)
+        evl_p[i] = host_evl_sorted_p6b[idx_p6] + host_evl_sorted_p5b[idx_p5] + host_evl_sorted_p4b[idx_p4];
+
+    #pragma omp parallel for reduction(+:final_energy_1,final_energy_2)
+    for (size_t ip = 0; ip < size_p; ip++)
     {
-        //
-        int idx_t3 = idx_h3 + (idx_h2 + (idx_h1 + (idx_p6 + (idx_p5 + (idx_p4) * size_idx_p5) * size_idx_p6) * size_idx_h1) * size_idx_h2) * size_idx_h3;
-
-        //
-        double inner_factor = (host_evl_sorted_h3b[idx_h3] + host_evl_sorted_h2b[idx_h2] + host_evl_sorted_h1b[idx_h1] -
-                            host_evl_sorted_p6b[idx_p6] - host_evl_sorted_p5b[idx_p5] - host_evl_sorted_p4b[idx_p4]);
-        //
-        final_energy_1 += factor * host_t3_d[idx_t3] * (host_t3_d[idx_t3])                       / inner_factor;
-        final_energy_2 += factor * host_t3_d[idx_t3] * (host_t3_d[idx_t3] + host_t3_s[idx_t3])   / inner_factor;
+        const double* t3_d = host_t3_d.data() + ip * size_h;
+        const double* t3_s = host_t3_s.data() + ip * size_h;
+        #pragma omp simd reduction(+:final_energy_1,final_energy_2)
+        for (size_t ih = 0; ih < size_h; ih++)
+        {
+            const double inner_factor = evl_h[ih] - evl_p[ip];
+            final_energy_1 += factor * t3_d[ih] * (t3_d[ih])            / inner_factor;
+            final_energy_2 += factor * t3_d[ih] * (t3_d[ih] + t3_s[ih]) / inner_factor;
+        }
     }
 
     energy_l[0] += final_energy_1;
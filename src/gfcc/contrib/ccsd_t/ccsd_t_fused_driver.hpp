@@ -72,6 +72,96 @@ int checkCudaKernelCompatible(bool r0) {
 #endif
 
 //
+/**
+ *  (T) tasks as (p4b,p5b,p6b,h1b,h2b,h3b) block tuples; with seq_h3b h3b is
+ *  looped over inside a task and left 0. Tasks are sorted along a Morton
+ *  (Z-order) curve of their block indices, so a contiguous range of tasks,
+ *  as handed to a rank by the chunked counter, reuses the same t2/v2 blocks
+ *  and hits the LRU caches.
+ **/
+inline std::vector<std::array<size_t,6>>
+ccsd_t_task_list(size_t noab, size_t nvab, const std::vector<int>& k_spin,
+                 bool is_restricted, bool seq_h3b) {
+  auto allowed = [&](size_t p4b, size_t p5b, size_t p6b,
+                     size_t h1b, size_t h2b, size_t h3b) {
+    int sp = k_spin[p4b] + k_spin[p5b] + k_spin[p6b];
+    int sh = k_spin[h1b] + k_spin[h2b] + k_spin[h3b];
+    return sp == sh && (!is_restricted || sp + sh <= 8);
+  };
+  auto morton = [](const std::array<size_t,6>& idx) {
+    uint64_t key = 0;
+    for(int b = 9; b >= 0; b--)
+      for(int d = 0; d < 6; d++) key = (key << 1) | ((idx[d] >> b) & 1);
+    return key;
+  };
+
+  std::vector<std::pair<uint64_t,std::array<size_t,6>>> keyed;
+  for (size_t t_p4b = noab; t_p4b < noab + nvab; t_p4b++)
+  for (size_t t_p5b = t_p4b; t_p5b < noab + nvab; t_p5b++)
+  for (size_t t_p6b = t_p5b; t_p6b < noab + nvab; t_p6b++)
+  for (size_t t_h1b = 0; t_h1b < noab; t_h1b++)
+  for (size_t t_h2b = t_h1b; t_h2b < noab; t_h2b++) {
+    for (size_t t_h3b = t_h2b; t_h3b < noab; t_h3b++) {
+      if(!allowed(t_p4b,t_p5b,t_p6b,t_h1b,t_h2b,t_h3b)) continue;
+      std::array<size_t,6> task{t_p4b,t_p5b,t_p6b,t_h1b,t_h2b,seq_h3b ? 0 : t_h3b};
+      keyed.push_back({morton({t_p4b-noab,t_p5b-noab,t_p6b-noab,t_h1b,t_h2b,task[5]}),task});
+      if(seq_h3b) break;
+    }
+  }
+  std::stable_sort(keyed.begin(), keyed.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<std::array<size_t,6>> tasks(keyed.size());
+  std::transform(keyed.begin(), keyed.end(), tasks.begin(),
+                 [](const auto& kt) { return kt.second; });
+  return tasks;
+}
+
+/**
+ *  Capacities in bytes of the (T) block caches s1t, s1v, d1t, d1v, d2t, d2v.
+ *  cache_mem GiB per rank are split in proportion to the blocks each cache
+ *  needs per task; 0 disables the caches.
+ **/
+inline std::array<size_t,6> ccsd_t_cache_bytes(const TiledIndexSpace& MO, double cache_mem) {
+  const double noab = MO("occ").num_tiles();
+  const double nvab = MO("virt").num_tiles();
+  const double ts   = MO("all").max_tile_size();
+
+  const double budget = std::max(0.0, cache_mem) * 1024 * 1024 * 1024;
+
+  const double b2 = ts * ts, b4 = b2 * b2;
+  const std::array<double,6> weight{b2, b4, noab * b4, noab * b4, nvab * b4, nvab * b4};
+  const double wsum = std::accumulate(weight.begin(), weight.end(), 0.0);
+  std::array<size_t,6> bytes;
+  for(size_t i = 0; i < 6; i++) bytes[i] = static_cast<size_t>(budget * weight[i] / wsum);
+  return bytes;
+}
+
+/**
+ *  Print hit rate and reuse distance histogram of a (T) block cache, summed
+ *  over all ranks. Reuse distances are binned by powers of two.
+ **/
+template<typename T>
+void ccsd_t_cache_report(ExecutionContext& ec, const std::string& name,
+                         LRUCache<Index,std::vector<T>>& cache) {
+  std::vector<size_t> stats;
+  cache.gather_stats(stats);
+  std::vector<size_t> g_stats(stats.size());
+  ec.pg().reduce(stats.data(), g_stats.data(), stats.size(), ReduceOp::sum, 0);
+  if(ec.pg().rank() != 0) return;
+
+  const double misses = g_stats.back();
+  const double hits   = std::accumulate(g_stats.begin(), g_stats.end() - 1, 0.0);
+  std::cout << "   -> " << name << " cache (" << std::setprecision(3)
+            << cache.max_bytes() / (1024 * 1024.0) << " MiB): hit rate = "
+            << std::setprecision(3) << (hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0)
+            << "%, reuse distance histogram:";
+  for(size_t i = 0; i + 1 < g_stats.size(); i++) {
+    if(g_stats[i] > 0) std::cout << " [" << (1ULL << i) << "," << (2ULL << i) << ")=" << g_stats[i];
+  }
+  std::cout << std::endl;
+}
+
 template<typename T>
 std::tuple<double,double,double,double>
 ccsd_t_fused_driver_new(SystemData& sys_data, ExecutionContext& ec,
@@ -218,8 +308,11 @@ ccsd_t_fused_driver_new(SystemData& sys_data, ExecutionContext& ec,
   hostEnergyReduceData_t* reduceData = (hostEnergyReduceData_t*) malloc(1 * sizeof(hostEnergyReduceData_t));
 #endif
 
-  AtomicCounter* ac = new AtomicCounterGA(ec.pg(), 1);
+  const auto tasks = ccsd_t_task_list(noab, nvab, k_spin, is_restricted, seq_h3b);
+
+  AtomicCounter* ac = new AtomicCounterChunked(ec.pg(), 1);
   ac->allocate(0);
+  ac->set_task_count(0, tasks.size());
   int64_t taskcount = 0;
   int64_t next = ac->fetch_add(0, 1);
 
@@ -322,144 +415,122 @@ ccsd_t_fused_driver_new(SystemData& sys_data, ExecutionContext& ec,
       std::cout << "456123 parallel 6d loop variant" << std::endl;
       std::cout << "tile142563,kernel,memcpy,data,total" << std::endl;
     }
-    for (size_t t_p4b = noab; t_p4b < noab + nvab; t_p4b++) {
-    for (size_t t_p5b = t_p4b; t_p5b < noab + nvab; t_p5b++) {
-    for (size_t t_p6b = t_p5b; t_p6b < noab + nvab; t_p6b++) {
-    for (size_t t_h1b = 0; t_h1b < noab; t_h1b++) { //
-    for (size_t t_h2b = t_h1b; t_h2b < noab; t_h2b++) {
-    for (size_t t_h3b = t_h2b; t_h3b < noab; t_h3b++) {
-      if ((k_spin[t_p4b] + k_spin[t_p5b] + k_spin[t_p6b]) ==
-          (k_spin[t_h1b] + k_spin[t_h2b] + k_spin[t_h3b])) {
-        if ((!is_restricted) ||
-            (k_spin[t_p4b] + k_spin[t_p5b] + k_spin[t_p6b] +
-            k_spin[t_h1b] + k_spin[t_h2b] + k_spin[t_h3b]) <= 8) {
-          if (next == taskcount) {
-            // 
-            double factor = 1.0;
-            if (is_restricted) factor = 2.0;
-            if ((t_p4b == t_p5b) && (t_p5b == t_p6b)) {
-              factor /= 6.0;
-            } else if ((t_p4b == t_p5b) || (t_p5b == t_p6b)) {
-              factor /= 2.0;
-            }
-
-            if ((t_h1b == t_h2b) && (t_h2b == t_h3b)) {
-              factor /= 6.0;
-            } else if ((t_h1b == t_h2b) || (t_h2b == t_h3b)) {
-              factor /= 2.0;
-            }
+    for (const auto& task: tasks) {
+      const size_t t_p4b = task[0], t_p5b = task[1], t_p6b = task[2];
+      const size_t t_h1b = task[3], t_h2b = task[4], t_h3b = task[5];
+      if (next == taskcount) {
+        // 
+        double factor = 1.0;
+        if (is_restricted) factor = 2.0;
+        if ((t_p4b == t_p5b) && (t_p5b == t_p6b)) {
+          factor /= 6.0;
+        } else if ((t_p4b == t_p5b) || (t_p5b == t_p6b)) {
+          factor /= 2.0;
+        }
 
-            num_task++;
+        if ((t_h1b == t_h2b) && (t_h2b == t_h3b)) {
+          factor /= 6.0;
+        } else if ((t_h1b == t_h2b) || (t_h2b == t_h3b)) {
+          factor /= 2.0;
+        }
 
-          #if defined(USE_CUDA) || defined(USE_HIP) || defined(USE_DPCPP)
-            ccsd_t_fully_fused_none_df_none_task(is_restricted, 
-            #if defined(USE_DPCPP)
-              syclQue,
-            #endif
-              noab, nvab, rank,
-              k_spin,
-              k_range,
-              k_offset,
-              d_t1, d_t2, d_v2,
-              k_evl_sorted,
-              //
-              df_host_pinned_s1_t1, df_host_pinned_s1_v2,
-              df_host_pinned_d1_t2, df_host_pinned_d1_v2,
-              df_host_pinned_d2_t2, df_host_pinned_d2_v2,
-              df_host_energies,
-              // 
-              //
-              //
-              host_d1_size, host_d2_size, 
-              //
-              df_simple_s1_size, df_simple_d1_size, df_simple_d2_size,
-              df_simple_s1_exec, df_simple_d1_exec, df_simple_d2_exec,
-              //
-              df_dev_s1_t1_all, df_dev_s1_v2_all,
-              df_dev_d1_t2_all, df_dev_d1_v2_all,
-              df_dev_d2_t2_all, df_dev_d2_v2_all,
-              df_dev_energies,
-              //
-              t_h1b, t_h2b, t_h3b,
-              t_p4b, t_p5b, t_p6b,
-              factor, taskcount,
-              max_d1_kernels_pertask, max_d2_kernels_pertask,
-              //
-              size_T_s1_t1, size_T_s1_v2,
-              size_T_d1_t2, size_T_d1_v2,
-              size_T_d2_t2, size_T_d2_v2,
-              //
-              energy_l, 
-              #if defined(USE_CUDA)
-              reduceData,
-              #endif
-              cache_s1t, cache_s1v,
-              cache_d1t, cache_d1v,
-              cache_d2t, cache_d2v
-              #if defined(USE_CUDA)
-              , done_compute, done_copy
-              #endif
-              );
-          #else
-            total_fused_ccsd_t_cpu<T>(is_restricted, noab, nvab, rank,
-              k_spin,
-              k_range,
-              k_offset,
-              d_t1, d_t2, d_v2,
-              k_evl_sorted,
-              //
-              df_host_pinned_s1_t1, df_host_pinned_s1_v2,
-              df_host_pinned_d1_t2, df_host_pinned_d1_v2,
-              df_host_pinned_d2_t2, df_host_pinned_d2_v2,
-              df_host_energies,
-              host_d1_size, host_d2_size,
-              //
-              df_simple_s1_size, df_simple_d1_size, df_simple_d2_size,
-              df_simple_s1_exec, df_simple_d1_exec, df_simple_d2_exec,
-              //
-              t_h1b, t_h2b, t_h3b,
-              t_p4b, t_p5b, t_p6b,
-              factor, taskcount,
-              max_d1_kernels_pertask, max_d2_kernels_pertask,
-              //
-              size_T_s1_t1, size_T_s1_v2,
-              size_T_d1_t2, size_T_d1_v2,
-              size_T_d2_t2, size_T_d2_v2,
-              //
-              energy_l,
-              cache_s1t, cache_s1v,
-              cache_d1t, cache_d1v,
-              cache_d2t, cache_d2v);
+        num_task++;
+
+      #if defined(USE_CUDA) || defined(USE_HIP) || defined(USE_DPCPP)
+        ccsd_t_fully_fused_none_df_none_task(is_restricted, 
+        #if defined(USE_DPCPP)
+          syclQue,
+        #endif
+          noab, nvab, rank,
+          k_spin,
+          k_range,
+          k_offset,
+          d_t1, d_t2, d_v2,
+          k_evl_sorted,
+          //
+          df_host_pinned_s1_t1, df_host_pinned_s1_v2,
+          df_host_pinned_d1_t2, df_host_pinned_d1_v2,
+          df_host_pinned_d2_t2, df_host_pinned_d2_v2,
+          df_host_energies,
+          // 
+          //
+          //
+          host_d1_size, host_d2_size, 
+          //
+          df_simple_s1_size, df_simple_d1_size, df_simple_d2_size,
+          df_simple_s1_exec, df_simple_d1_exec, df_simple_d2_exec,
+          //
+          df_dev_s1_t1_all, df_dev_s1_v2_all,
+          df_dev_d1_t2_all, df_dev_d1_v2_all,
+          df_dev_d2_t2_all, df_dev_d2_v2_all,
+          df_dev_energies,
+          //
+          t_h1b, t_h2b, t_h3b,
+          t_p4b, t_p5b, t_p6b,
+          factor, taskcount,
+          max_d1_kernels_pertask, max_d2_kernels_pertask,
+          //
+          size_T_s1_t1, size_T_s1_v2,
+          size_T_d1_t2, size_T_d1_v2,
+          size_T_d2_t2, size_T_d2_v2,
+          //
+          energy_l, 
+          #if defined(USE_CUDA)
+          reduceData,
           #endif
+          cache_s1t, cache_s1v,
+          cache_d1t, cache_d1v,
+          cache_d2t, cache_d2v
+          #if defined(USE_CUDA)
+          , done_compute, done_copy
+          #endif
+          );
+      #else
+        total_fused_ccsd_t_cpu<T>(is_restricted, noab, nvab, rank,
+          k_spin,
+          k_range,
+          k_offset,
+          d_t1, d_t2, d_v2,
+          k_evl_sorted,
+          //
+          df_host_pinned_s1_t1, df_host_pinned_s1_v2,
+          df_host_pinned_d1_t2, df_host_pinned_d1_v2,
+          df_host_pinned_d2_t2, df_host_pinned_d2_v2,
+          df_host_energies,
+          host_d1_size, host_d2_size,
+          //
+          df_simple_s1_size, df_simple_d1_size, df_simple_d2_size,
+          df_simple_s1_exec, df_simple_d1_exec, df_simple_d2_exec,
+          //
+          t_h1b, t_h2b, t_h3b,
+          t_p4b, t_p5b, t_p6b,
+          factor, taskcount,
+          max_d1_kernels_pertask, max_d2_kernels_pertask,
+          //
+          size_T_s1_t1, size_T_s1_v2,
+          size_T_d1_t2, size_T_d1_v2,
+          size_T_d2_t2, size_T_d2_v2,
+          //
+          energy_l,
+          cache_s1t, cache_s1v,
+          cache_d1t, cache_d1v,
+          cache_d2t, cache_d2v);
+      #endif
 
-            next = ac->fetch_add(0, 1);
-          }
-          taskcount++;
-        }
+        next = ac->fetch_add(0, 1);
       }
-    }}}}}}
+      taskcount++;
+    }
   } // parallel h3b loop
   else
   { //seq h3b loop
-    #if 1
     if(rank==0) {
       std::cout << "14256-seq3 loop variant" << std::endl;
       std::cout << "tile142563,kernel,memcpy,data,total" << std::endl;
     }
-    for (size_t t_h1b = 0; t_h1b < noab; t_h1b++) { //
-    for (size_t t_p4b = noab; t_p4b < noab + nvab; t_p4b++) {
-    for (size_t t_h2b = t_h1b; t_h2b < noab; t_h2b++) {
-    for (size_t t_p5b = t_p4b; t_p5b < noab + nvab; t_p5b++) {
-    for (size_t t_p6b = t_p5b; t_p6b < noab + nvab; t_p6b++) {
-    #endif
-
-    #if 0
-    for (size_t t_p4b = noab; t_p4b < noab + nvab; t_p4b++) {
-    for (size_t t_p5b = t_p4b; t_p5b < noab + nvab; t_p5b++) {
-    for (size_t t_p6b = t_p5b; t_p6b < noab + nvab; t_p6b++) {
-    for (size_t t_h1b = 0; t_h1b < noab; t_h1b++) {
-    for (size_t t_h2b = t_h1b; t_h2b < noab; t_h2b++) {
-    #endif
+    for (const auto& task: tasks) {
+      const size_t t_p4b = task[0], t_p5b = task[1], t_p6b = task[2];
+      const size_t t_h1b = task[3], t_h2b = task[4];
       if (next == taskcount) {
         // if (has_GPU==1) {
         //   initmemmodule();
@@ -578,7 +649,7 @@ ccsd_t_fused_driver_new(SystemData& sys_data, ExecutionContext& ec,
         next = ac->fetch_add(0, 1);
       }
       taskcount++;
-    }}}}}
+    }
   } //end seq h3b
 
   #if defined(USE_CUDA)
@@ -669,7 +740,6 @@ ccsd_t_fused_driver_new(SystemData& sys_data, ExecutionContext& ec,
   auto total_t_time = std::chrono::duration_cast<std::chrono::duration<double>>((cc_t2 - cc_t1)).count();
 
   //
-  next = ac->fetch_add(0, 1);
   ac->deallocate();
   delete ac;
 
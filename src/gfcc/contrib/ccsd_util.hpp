@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ccse_tensors.hpp"
+#include "tamm/checkpoint.hpp"
 
 // auto lambdar2 = [](const IndexVector& blockid, span<double> buf){
 //     if((blockid[0] > blockid[1]) || (blockid[2] > blockid[3])) {
@@ -215,36 +216,17 @@ std::pair<double,double> rest(ExecutionContext& ec,
                               const TAMM_SIZE& nob, bool transpose=false) {
 
     T residual, energy;
-    Scheduler sch{ec};
-    // Tensor<T> d_r1_residual{}, d_r2_residual{};
-    // Tensor<T>::allocate(&ec,d_r1_residual, d_r2_residual);
-    sch
-      (d_r1_residual() = d_r1()  * d_r1())
-      (d_r2_residual() = d_r2()  * d_r2())
-      .execute();
-
-      auto l0 = [&]() {
-        T r1 = get_scalar(d_r1_residual);
-        T r2 = get_scalar(d_r2_residual);
-        r1 = 0.5*std::sqrt(r1);
-        r2 = 0.5*std::sqrt(r2);
-        energy = get_scalar(de);
-        residual = std::max(r1,r2);
-      };
-
-      auto l1 =  [&]() {
-        jacobi(ec, d_r1, d_t1, -1.0 * zshiftl, transpose, p_evl_sorted,noa,nob);
-      };
-      auto l2 = [&]() {
-        jacobi(ec, d_r2, d_t2, -2.0 * zshiftl, transpose, p_evl_sorted,noa,nob);
-      };
-
-      l0();
-      l1();
-      l2();
-
-      // Tensor<T>::deallocate(d_r1_residual, d_r2_residual);
-      
+    // the Jacobi pass also accumulates the squared residual norms
+    T rsq[2], g_rsq[2];
+    rsq[0] = jacobi(ec, d_r1, d_t1, -1.0 * zshiftl, transpose, p_evl_sorted,noa,nob);
+    rsq[1] = jacobi(ec, d_r2, d_t2, -2.0 * zshiftl, transpose, p_evl_sorted,noa,nob);
+    ec.pg().allreduce(rsq, g_rsq, 2, ReduceOp::sum);
+
+    T r1 = 0.5*std::sqrt(g_rsq[0]);
+    T r2 = 0.5*std::sqrt(g_rsq[1]);
+    energy = get_scalar(de);
+    residual = std::max(r1,r2);
+
     return {residual, energy};
 }
 
@@ -264,36 +246,17 @@ std::pair<double,double> rest_cs(ExecutionContext& ec,
 			       const bool not_spin_orbital=false) {
 
     T residual, energy;
-    Scheduler sch{ec};
-    // Tensor<T> d_r1_residual{}, d_r2_residual{};
-    // Tensor<T>::allocate(&ec,d_r1_residual, d_r2_residual);
-    sch
-      (d_r1_residual() = d_r1()  * d_r1())
-      (d_r2_residual() = d_r2()  * d_r2())
-      .execute();
-
-      auto l0 = [&]() {
-        T r1 = get_scalar(d_r1_residual);
-        T r2 = get_scalar(d_r2_residual);
-        r1 = 0.5*std::sqrt(r1);
-        r2 = 0.5*std::sqrt(r2);
-        energy = get_scalar(de);
-        residual = std::max(r1,r2);
-      };
-
-      auto l1 =  [&]() {
-        jacobi_cs(ec, d_r1, d_t1, -1.0 * zshiftl, transpose, p_evl_sorted,noa,nva,not_spin_orbital);
-      };
-      auto l2 = [&]() {
-        jacobi_cs(ec, d_r2, d_t2, -2.0 * zshiftl, transpose, p_evl_sorted,noa,nva,not_spin_orbital);
-      };
-
-      l0();
-      l1();
-      l2();
-
-      // Tensor<T>::deallocate(d_r1_residual, d_r2_residual);
-      
+    // the Jacobi pass also accumulates the squared residual norms
+    T rsq[2], g_rsq[2];
+    rsq[0] = jacobi_cs(ec, d_r1, d_t1, -1.0 * zshiftl, transpose, p_evl_sorted,noa,nva,not_spin_orbital);
+    rsq[1] = jacobi_cs(ec, d_r2, d_t2, -2.0 * zshiftl, transpose, p_evl_sorted,noa,nva,not_spin_orbital);
+    ec.pg().allreduce(rsq, g_rsq, 2, ReduceOp::sum);
+
+    T r1 = 0.5*std::sqrt(g_rsq[0]);
+    T r2 = 0.5*std::sqrt(g_rsq[1]);
+    energy = get_scalar(de);
+    residual = std::max(r1,r2);
+
     return {residual, energy};
 }
 
@@ -592,6 +555,78 @@ V2Tensors<T> setupV2Tensors(ExecutionContext& ec, Tensor<T> cholVpr, ExecutionHW
   return v2tensors;
 }
 
+// On-demand V2 for (T): each get() of block {p,q,r,s} evaluates
+// sum_c L(p,r,c) L(q,s,c) - L(p,s,c) L(q,r,c) from cholVpr with two GEMMs,
+// so only cholVpr (N^2 x Nchol) is resident instead of the N^4 d_v2.
+// The (p,r) slices of cholVpr are kept in a small LRU cache.
+template<typename T>
+Tensor<T> setupLambdaV2(TiledIndexSpace& MO, TiledIndexSpace& CI, Tensor<T> cholVpr,
+                        size_t slice_cache_mem = size_t{1} << 28) {
+
+    TiledIndexSpace N = MO("all");
+    const Index nci_tiles = CI.num_tiles();
+    const int64_t nchol   = CI.max_num_indices();
+
+    // a GEMM holds references to two slices; the cache keeps the values of
+    // the two most recent accesses alive
+    auto slice_cache = std::make_shared<LRUCache<Index,std::vector<T>>>(slice_cache_mem);
+
+    // L(p,r,c) for the block pair (pb,rb), as a [dp*dr x nchol] matrix
+    auto get_slice = [=](Index pb, Index rb) -> const std::vector<T>& {
+        auto [hit, slice] = slice_cache->log_access({pb,rb});
+        if(hit) return slice;
+        const int64_t dpr = N.tile_size(pb) * N.tile_size(rb);
+        slice.assign(dpr*nchol, 0);
+        int64_t coff = 0;
+        for(Index cb = 0; cb < nci_tiles; cb++) {
+            const int64_t dc = CI.tile_size(cb);
+            std::vector<T> cbuf(dpr*dc);
+            cholVpr.get({pb,rb,cb}, cbuf);
+            for(int64_t pr = 0; pr < dpr; pr++)
+                std::copy_n(&cbuf[pr*dc], dc, &slice[pr*nchol + coff]);
+            coff += dc;
+        }
+        return slice;
+    };
+
+    auto v2_lambda = [=](const IndexVector& blockid, span<T> buf) {
+        const Index pb = blockid[0], qb = blockid[1], rb = blockid[2], sb = blockid[3];
+        const int64_t dp = N.tile_size(pb), dq = N.tile_size(qb);
+        const int64_t dr = N.tile_size(rb), ds = N.tile_size(sb);
+        std::fill(buf.begin(), buf.end(), T{0});
+        std::vector<T> tmp(dp*dq*dr*ds);
+
+        // +(pr|qs): tmp[(p,r)][(q,s)]
+        if(N.spin(pb) == N.spin(rb) && N.spin(qb) == N.spin(sb)) {
+            const auto& l_pr = get_slice(pb,rb);
+            const auto& l_qs = get_slice(qb,sb);
+            blas::gemm(blas::Layout::RowMajor, blas::Op::NoTrans, blas::Op::Trans,
+                       dp*dr, dq*ds, nchol, 1.0, l_pr.data(), nchol, l_qs.data(), nchol,
+                       0.0, tmp.data(), dq*ds);
+            for(int64_t p = 0; p < dp; p++)
+            for(int64_t q = 0; q < dq; q++)
+            for(int64_t r = 0; r < dr; r++)
+            for(int64_t s = 0; s < ds; s++)
+                buf[((p*dq+q)*dr+r)*ds+s] += tmp[(p*dr+r)*dq*ds + q*ds+s];
+        }
+        // -(ps|qr): tmp[(p,s)][(q,r)]
+        if(N.spin(pb) == N.spin(sb) && N.spin(qb) == N.spin(rb)) {
+            const auto& l_ps = get_slice(pb,sb);
+            const auto& l_qr = get_slice(qb,rb);
+            blas::gemm(blas::Layout::RowMajor, blas::Op::NoTrans, blas::Op::Trans,
+                       dp*ds, dq*dr, nchol, 1.0, l_ps.data(), nchol, l_qr.data(), nchol,
+                       0.0, tmp.data(), dq*dr);
+            for(int64_t p = 0; p < dp; p++)
+            for(int64_t q = 0; q < dq; q++)
+            for(int64_t r = 0; r < dr; r++)
+            for(int64_t s = 0; s < ds; s++)
+                buf[((p*dq+q)*dr+r)*ds+s] -= tmp[(p*ds+s)*dq*dr + q*dr+r];
+        }
+    };
+
+    return Tensor<T>{{N,N,N,N}, v2_lambda};
+}
+
 template<typename T>
 Tensor<T> setupV2(ExecutionContext& ec, TiledIndexSpace& MO, TiledIndexSpace& CI,
                   Tensor<T> cholVpr, const tamm::Tile chol_count, 
@@ -264,6 +264,8 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
     double thresh      = sys_data.options_map.ccsd_options.threshold;
     bool   writet      = sys_data.options_map.ccsd_options.writet;
     int    writet_iter = sys_data.options_map.ccsd_options.writet_iter;
+    bool   coll_io     = sys_data.options_map.ccsd_options.collective_io;
+    bool   async_io    = sys_data.options_map.ccsd_options.writet_async;
     double zshiftl     = sys_data.options_map.ccsd_options.lshift;
     bool   profile     = sys_data.options_map.ccsd_options.profile_ccsd;
     double residual    = 0.0;
@@ -276,6 +278,16 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
     std::string t1file = out_fp+".t1amp";
     std::string t2file = out_fp+".t2amp";                       
 
+    // with writet_async the amplitudes are written while the iterations continue
+    AsyncCheckpoint<T> checkpoint{ec, coll_io};
+    auto write_amplitudes = [&]() {
+      if(async_io) checkpoint.write({t1_aa, t2_abab}, {t1file, t2file});
+      else {
+        write_to_disk(t1_aa,t1file,true,false,0,coll_io);
+        write_to_disk(t2_abab,t2file,true,false,0,coll_io);
+      }
+    };
+
     std::cout.precision(15);
 
     const TiledIndexSpace &O = MO("occ");
@@ -413,6 +425,21 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
         Tensor<T> d_r1_residual{}, d_r2_residual{};
         Tensor<T>::allocate(&ec,d_r1_residual, d_r2_residual);
 
+        DIIS<T> diis_engine{ec, {d_r1s, d_r2s}, {d_t1s, d_t2s}};
+
+        // the energy and residual ops are the same every iteration, so they are
+        // captured once into a plan; profiling needs the per-op timers of execute()
+        auto ccsd_iteration_ops = [&]() {
+            ccsd_e_cs(sch, MO, CI, d_e, t1_aa, t2_abab, t2_aaaa, f1_se, chol3d_se);
+            ccsd_t1_cs(sch, MO, CI, r1_aa, t1_aa, t2_abab, f1_se, chol3d_se);
+            ccsd_t2_cs(sch, MO, CI, r2_abab, t1_aa, t2_abab, t2_aaaa, f1_se, chol3d_se);
+        };
+        ExecutionPlan ccsd_plan;
+        if(!profile) {
+            ccsd_iteration_ops();
+            ccsd_plan = sch.compile();
+        }
+
         for(int titer = 0; titer < maxiter; titer += ndiis) {
         for(int iter = titer; iter < std::min(titer + ndiis, maxiter); iter++) {
             const auto timer_start = std::chrono::high_resolution_clock::now();
@@ -425,11 +452,11 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
                ((d_t2s[off])()  = t2_abab())
                .execute();
 
-            ccsd_e_cs(sch, MO, CI, d_e, t1_aa, t2_abab, t2_aaaa, f1_se, chol3d_se);
-            ccsd_t1_cs(sch, MO, CI, r1_aa, t1_aa, t2_abab, f1_se, chol3d_se);
-            ccsd_t2_cs(sch, MO, CI, r2_abab, t1_aa, t2_abab, t2_aaaa, f1_se, chol3d_se);
-
-            sch.execute(exhw, profile);
+            if(profile) {
+                ccsd_iteration_ops();
+                sch.execute(exhw, profile);
+            }
+            else ccsd_plan.execute(exhw);
 
             std::tie(residual, energy) = rest_cs(ec, MO, r1_aa, r2_abab, t1_aa, t2_abab,
                                             d_e, d_r1_residual, d_r2_residual, p_evl_sorted,
@@ -440,6 +467,7 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
             sch((d_r1s[off])() = r1_aa())
                 ((d_r2s[off])() = r2_abab())
                 .execute();
+            diis_engine.update(off);
 
             const auto timer_end = std::chrono::high_resolution_clock::now();
             auto iter_time = std::chrono::duration_cast<std::chrono::duration<double>>((timer_end - timer_start)).count();
@@ -447,8 +475,7 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
             iteration_print(sys_data, ec.pg(), iter, residual, energy, iter_time);
 
             if(writet && ( ((iter+1)%writet_iter == 0) || (residual < thresh) ) ) {
-                write_to_disk(t1_aa,t1file);
-                write_to_disk(t2_abab,t2file);
+                write_amplitudes();
             }        
 
             if(residual < thresh) { 
@@ -465,12 +492,10 @@ std::tuple<double,double> cd_ccsd_cs_driver(SystemData& sys_data, ExecutionConte
             std::cout << std::right << "5" << std::endl;
         }
 
-        std::vector<std::vector<Tensor<T>>> rs{d_r1s, d_r2s};
-        std::vector<std::vector<Tensor<T>>> ts{d_t1s, d_t2s};
-        std::vector<Tensor<T>> next_t{t1_aa, t2_abab};
-        diis<T>(ec, rs, ts, next_t);
+        diis_engine.extrapolate({t1_aa, t2_abab});
 
     }
+    checkpoint.wait();
 
     if(profile) {
         std::string profile_csv = out_fp + "_profile.csv";
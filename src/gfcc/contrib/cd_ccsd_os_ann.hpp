@@ -444,6 +444,8 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
     double thresh      = sys_data.options_map.ccsd_options.threshold;
     bool   writet      = sys_data.options_map.ccsd_options.writet;
     int    writet_iter = sys_data.options_map.ccsd_options.writet_iter;
+    bool   coll_io     = sys_data.options_map.ccsd_options.collective_io;
+    bool   async_io    = sys_data.options_map.ccsd_options.writet_async;
     double zshiftl     = sys_data.options_map.ccsd_options.lshift;
     bool   profile     = sys_data.options_map.ccsd_options.profile_ccsd;    
     double residual    = 0.0;
@@ -456,6 +458,16 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
     std::string t1file = out_fp+".t1amp";
     std::string t2file = out_fp+".t2amp";                       
 
+    // with writet_async the amplitudes are written while the iterations continue
+    AsyncCheckpoint<T> checkpoint{ec, coll_io};
+    auto write_amplitudes = [&]() {
+      if(async_io) checkpoint.write({d_t1, d_t2}, {t1file, t2file});
+      else {
+        write_to_disk(d_t1,t1file,true,false,0,coll_io);
+        write_to_disk(d_t2,t2file,true,false,0,coll_io);
+      }
+    };
+
     std::cout.precision(15);
 
     const TiledIndexSpace &O = MO("occ");
@@ -642,27 +654,18 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
         Tensor<T> d_r1_residual{}, d_r2_residual{};
         Tensor<T>::allocate(&ec,d_r1_residual, d_r2_residual);
 
-        for(int titer = 0; titer < maxiter; titer += ndiis) {
-          for(int iter = titer; iter < std::min(titer + ndiis, maxiter); iter++) {
-
-            const auto timer_start = std::chrono::high_resolution_clock::now();
-
-            niter   = iter;
-            int off = iter - titer;
-            
-            sch
-               ((d_t1s[off])()  = d_t1())
-               ((d_t2s[off])()  = d_t2())
-               .execute();
+        DIIS<T> diis_engine{ec, {d_r1s, d_r2s}, {d_t1s, d_t2s}};
 
-            //TODO:UPDATE FOR DIIS
+        // the ops from the spin blocks of d_t1/d_t2 to d_r1/d_r2 are the same every
+        // iteration, so they are captured once into a plan; profiling needs the
+        // per-op timers of execute()
+        auto ccsd_iteration_ops = [&]() {
             sch
                (t1_vo("aa")(p1_va,h3_oa)                 = d_t1(p1_va,h3_oa))
                (t1_vo("bb")(p1_vb,h3_ob)                 = d_t1(p1_vb,h3_ob))
                (t2_vvoo("aaaa")(p1_va,p2_va,h3_oa,h4_oa) = d_t2(p1_va,p2_va,h3_oa,h4_oa))
                (t2_vvoo("abab")(p1_va,p2_vb,h3_oa,h4_ob) = d_t2(p1_va,p2_vb,h3_oa,h4_ob))
-               (t2_vvoo("bbbb")(p1_vb,p2_vb,h3_ob,h4_ob) = d_t2(p1_vb,p2_vb,h3_ob,h4_ob))
-               .execute();
+               (t2_vvoo("bbbb")(p1_vb,p2_vb,h3_ob,h4_ob) = d_t2(p1_vb,p2_vb,h3_ob,h4_ob));
 
             ccsd_e_os (sch, MO, CI, d_e, t1_vo, t2_vvoo, f1_se, chol3d_se);
             ccsd_t1_os(sch, MO, CI, /*d_r1,*/ r1_vo, t1_vo, t2_vvoo, f1_se, chol3d_se);
@@ -675,8 +678,32 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
               (d_r2(p3_vb, p4_vb, h2_ob, h1_ob)  = r2_vvoo("bbbb")(p3_vb, p4_vb, h2_ob, h1_ob))
               (d_r2(p3_va, p4_vb, h2_oa, h1_ob)  = r2_vvoo("abab")(p3_va, p4_vb, h2_oa, h1_ob))
               ;
+        };
+        ExecutionPlan ccsd_plan;
+        if(!profile) {
+            ccsd_iteration_ops();
+            ccsd_plan = sch.compile();
+        }
 
-            sch.execute(exhw, profile);
+        for(int titer = 0; titer < maxiter; titer += ndiis) {
+          for(int iter = titer; iter < std::min(titer + ndiis, maxiter); iter++) {
+
+            const auto timer_start = std::chrono::high_resolution_clock::now();
+
+            niter   = iter;
+            int off = iter - titer;
+            
+            sch
+               ((d_t1s[off])()  = d_t1())
+               ((d_t2s[off])()  = d_t2())
+               .execute();
+
+            //TODO:UPDATE FOR DIIS
+            if(profile) {
+                ccsd_iteration_ops();
+                sch.execute(exhw, profile);
+            }
+            else ccsd_plan.execute(exhw);
 
             std::tie(residual, energy) = rest(ec, MO, d_r1, d_r2, d_t1, d_t2,
                                               d_e, d_r1_residual, d_r2_residual, 
@@ -688,6 +715,7 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
                ((d_r1s[off])() = d_r1())
                ((d_r2s[off])() = d_r2())
                 .execute();
+            diis_engine.update(off);
 
             const auto timer_end = std::chrono::high_resolution_clock::now();
             auto iter_time = std::chrono::duration_cast<std::chrono::duration<double>>((timer_end - timer_start)).count();
@@ -695,8 +723,7 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
             iteration_print(sys_data, ec.pg(), iter, residual, energy, iter_time);
 
             if(writet && ( ((iter+1)%writet_iter == 0) /*|| (residual < thresh)*/ ) ) {
-                write_to_disk(d_t1,t1file);
-                write_to_disk(d_t2,t2file);
+                write_amplitudes();
             }
 
             if(residual < thresh) { 
@@ -710,8 +737,8 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
                    .deallocate(t2_copy)
                    .execute();
                 if(writet) {
-                  write_to_disk(d_t1,t1file);
-                  write_to_disk(d_t2,t2file);
+                  write_amplitudes();
+                  checkpoint.wait();
                   if(computeTData && sys_data.options_map.ccsd_options.writev) {
                     fs::copy_file(t1file, out_fp+".fullT1amp", fs::copy_options::update_existing);
                     fs::copy_file(t2file, out_fp+".fullT2amp", fs::copy_options::update_existing);
@@ -731,11 +758,9 @@ std::tuple<double,double> cd_ccsd_os_driver(SystemData& sys_data, ExecutionConte
             std::cout << std::right << "5" << std::endl;
           }
 
-            std::vector<std::vector<Tensor<T>>> rs{d_r1s, d_r2s};
-            std::vector<std::vector<Tensor<T>>> ts{d_t1s, d_t2s};
-            std::vector<Tensor<T>> next_t{d_t1, d_t2};
-            diis<T>(ec, rs, ts, next_t);
+            diis_engine.extrapolate({d_t1, d_t2});
         }
+        checkpoint.wait();
 
         if(profile) {
           std::string profile_csv = out_fp + "_profile.csv";
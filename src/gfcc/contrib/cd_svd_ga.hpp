@@ -341,7 +341,12 @@ Tensor<TensorType> cd_svd_ga(SystemData& sys_data, ExecutionContext& ec, TiledIn
   
   //TODO: Check k_map;
   int g_d = NGA_Create_irreg64(ga_eltype,2,dims2,const_cast<char*>("ERI Diag"), nblock2, &k_map[0]);
-  int g_r = NGA_Create_irreg64(ga_eltype,2,dims2,const_cast<char*>("ERI Res"), nblock2, &k_map[0]);
+
+  // Residual columns of one batch of pivots, distributed like g_chol
+  const int64_t nbatch  = std::max(1, sys_data.options_map.cd_options.batch_size);
+  int64_t dims3[3]   = {nbf,nbf,nbatch};
+  int64_t nblock3[3] = {nblock[0],nblock[1],1};
+  int g_r = NGA_Create_irreg64(ga_eltype,3,dims3,const_cast<char*>("ERI Res"), nblock3, &k_map[0]);
 
   int64_t lo_b[GA_MAX_DIM]; // The lower limits of blocks of B
   int64_t lo_r[GA_MAX_DIM]; // The lower limits of blocks of R
@@ -406,134 +411,266 @@ Tensor<TensorType> cd_svd_ga(SystemData& sys_data, ExecutionContext& ec, TiledIn
     } //#if s1
   } //s1
 
-  // Step C. Find the coordinates of the maximum element of the diagonal.
-  int64_t indx_d0[GA_MAX_DIM];
-  TensorType val_d0;
-  NGA_Select_elem64(g_d,const_cast<char*>("max"),&val_d0,indx_d0);
+  NGA_Sync();
+
+  // Schwarz bounds per shell pair from the diagonal: |(34|12)| <= K(3,4)*K(1,2)
+  const double schwarz_tol = sys_data.options_map.cd_options.schwarz_tol;
+  const auto   nshells     = shells.size();
+  std::vector<TensorType> SchwarzK(nshells*nshells, 0);
+  if(schwarz_tol > 0) {
+    TensorType *indx_d;
+    NGA_Access64(g_d,lo_d,hi_d,&indx_d,ld_d);
+    for(auto i = 0; i <= hi_d[0] - lo_d[0]; i++) {
+      for(auto j = 0; j <= hi_d[1] - lo_d[1]; j++) {
+        auto& k12 = SchwarzK[bf2shell[lo_d[0]+i]*nshells + bf2shell[lo_d[1]+j]];
+        k12 = std::max(k12, std::abs(indx_d[i*ld_d[0]+j]));
+      }
+    }
+    NGA_Release64(g_d,lo_d,hi_d);
+    GA_Pgroup_dgop(ga_pg,&SchwarzK[0],SchwarzK.size(),const_cast<char*>("max"));
+    for(auto& k12: SchwarzK) k12 = std::sqrt(k12);
+  }
+
+  const int64_t ga_pg_rank   = GA_Pgroup_nodeid(ga_pg);
+  const int64_t ga_pg_nranks = GA_Pgroup_nnodes(ga_pg);
+
+  // Candidates are taken within this fraction of the largest diagonal
+  // element, so that a batch does not pick up pivots the one-at-a-time
+  // algorithm would never have chosen.
+  constexpr double span_factor = 1e-2;
+
+  TensorType val_d0  = 0;
+  TensorType piv_tol = diagtol;
+  std::vector<int64_t> pivots;
+
+  // Step C. Find the largest elements of the diagonal. Each rank offers its
+  // local top nbatch, and all ranks pick the same batch from the union.
+  auto select_pivots = [&]() {
+    std::vector<std::pair<TensorType,int64_t>> local;
+    TensorType *indx_d;
+    NGA_Access64(g_d,lo_d,hi_d,&indx_d,ld_d);
+    for(auto i = 0; i <= hi_d[0] - lo_d[0]; i++)
+      for(auto j = 0; j <= hi_d[1] - lo_d[1]; j++)
+        local.push_back({indx_d[i*ld_d[0]+j], (lo_d[0]+i)*nbf + lo_d[1]+j});
+    NGA_Release64(g_d,lo_d,hi_d);
+
+    auto by_value = [](const auto& a, const auto& b) {
+      return a.first > b.first || (a.first == b.first && a.second < b.second);
+    };
+    const auto nlocal = std::min<int64_t>(nbatch, local.size());
+    std::partial_sort(local.begin(), local.begin()+nlocal, local.end(), by_value);
+
+    std::vector<TensorType> k_cand(2*nbatch*ga_pg_nranks, 0);
+    std::fill_n(k_cand.begin()+2*nbatch*ga_pg_rank, nbatch, -1);
+    for(int64_t c = 0; c < nlocal; c++) {
+      k_cand[2*nbatch*ga_pg_rank + c]          = local[c].first;
+      k_cand[2*nbatch*ga_pg_rank + nbatch + c] = local[c].second;
+    }
+    GA_Pgroup_dgop(ga_pg,&k_cand[0],k_cand.size(),const_cast<char*>("+"));
+
+    std::vector<std::pair<TensorType,int64_t>> cand;
+    for(int64_t r = 0; r < ga_pg_nranks; r++)
+      for(int64_t c = 0; c < nbatch; c++)
+        if(k_cand[2*nbatch*r + c] >= 0)
+          cand.push_back({k_cand[2*nbatch*r + c], static_cast<int64_t>(k_cand[2*nbatch*r + nbatch + c])});
+    std::sort(cand.begin(), cand.end(), by_value);
+
+    pivots.clear();
+    val_d0  = cand.empty() ? 0 : cand[0].first;
+    piv_tol = std::max(diagtol, span_factor*val_d0);
+    const int64_t max_piv = std::min(nbatch, max_cvecs - count);
+    for(auto& [val, bfuv]: cand) {
+      if(val <= piv_tol || static_cast<int64_t>(pivots.size()) == max_piv) break;
+      // (uv|..) and (vu|..) are the same column
+      const int64_t bfvu = (bfuv%nbf)*nbf + bfuv/nbf;
+      if(std::find(pivots.begin(), pivots.end(), bfvu) == pivots.end())
+        pivots.push_back(bfuv);
+    }
+    // group pivots by shell pair so each quartet is computed once per batch
+    std::stable_sort(pivots.begin(), pivots.end(), [&](int64_t a, int64_t b) {
+      return std::make_pair(bf2shell[a/nbf],bf2shell[a%nbf]) < std::make_pair(bf2shell[b/nbf],bf2shell[b%nbf]);
+    });
+  };
+
+  select_pivots();
 
   int64_t lo_x[GA_MAX_DIM]; // The lower limits of blocks
   int64_t hi_x[GA_MAX_DIM]; // The upper limits of blocks
   int64_t ld_x[GA_MAX_DIM]; // The leading dims of blocks
 
-  // Step D. Start the while loop
-  while(val_d0 > diagtol && count < max_cvecs){
+  std::vector<TensorType> k_eri;
+  std::vector<TensorType> k_lpiv;
+  std::vector<TensorType> k_q;
+  std::vector<TensorType> k_lsmall;
+  std::vector<TensorType> k_tri;
+
+  // Step D. Start the while loop, adding up to nbatch vectors per pass
+  while(val_d0 > diagtol && count < max_cvecs && !pivots.empty()){
+
+    const int64_t npiv = pivots.size();
 
+    // Step E. Compute the ERI columns (34|12) of all pivots in the batch
     NGA_Zero(g_r);
-    auto bfu = indx_d0[0];
-    auto bfv = indx_d0[1];
-    auto s1 = bf2shell[bfu];
-    auto n1 = shells[s1].size();
-    auto s2 = bf2shell[bfv];
-    auto n2 = shells[s2].size();
-    auto n12 = n1*n2;
-    auto f1 = bfu - shell2bf[s1];
-    auto f2 = bfv - shell2bf[s2];
-    auto ind12 = f1*n2 + f2;
-
-    for (size_t s3 = 0; s3 != shells.size(); ++s3) {
-      auto bf3_first = shell2bf[s3]; // first basis function in this shell
-      auto n3 = shells[s3].size();
-
-      decltype(bf3_first) lo_r0 = lo_r[0];
-      decltype(bf3_first) hi_r0 = hi_r[0];
-      if(lo_r0 <= bf3_first && bf3_first <= hi_r0){
-
-        for (decltype(s3) s4 = 0; s4 != shells.size(); ++s4) {
-          auto bf4_first = shell2bf[s4];
-          auto n4 = shells[s4].size();
-
-          decltype(bf4_first) lo_r1 = lo_r[1];
-          decltype(bf4_first) hi_r1 = hi_r[1];
-          if(lo_r1 <= bf4_first && bf4_first <= hi_r1){
-
-            engine.compute(shells[s3], shells[s4], shells[s1], shells[s2]);
-            const auto *buf_3412 = buf[0];
-            if (buf_3412 == nullptr)
-              continue; // if all integrals screened out, skip to next quartet
-
-            std::vector<TensorType> k_eri(n3*n4);
-            for (decltype(n3) f3 = 0; f3 != n3; ++f3) {
-              for (decltype(n4) f4 = 0; f4 != n4; ++f4) {
-                auto f3412 = f3*n4*n12 + f4*n12 + ind12;
-                k_eri[f3*n4+f4] = buf_3412[f3412];
+    for(int64_t p0 = 0; p0 < npiv;) {
+      const auto s1 = bf2shell[pivots[p0]/nbf];
+      const auto s2 = bf2shell[pivots[p0]%nbf];
+      int64_t p1 = p0;
+      while(p1 < npiv && bf2shell[pivots[p1]/nbf] == s1 && bf2shell[pivots[p1]%nbf] == s2) p1++;
+      const int64_t np12 = p1 - p0;
+      const auto n2  = shells[s2].size();
+      const auto n12 = shells[s1].size()*n2;
+      const TensorType k12 = SchwarzK[s1*nshells+s2];
+
+      for (size_t s3 = 0; s3 != shells.size(); ++s3) {
+        auto bf3_first = shell2bf[s3]; // first basis function in this shell
+        auto n3 = shells[s3].size();
+
+        decltype(bf3_first) lo_r0 = lo_r[0];
+        decltype(bf3_first) hi_r0 = hi_r[0];
+        if(lo_r0 <= bf3_first && bf3_first <= hi_r0){
+
+          for (decltype(s3) s4 = 0; s4 != shells.size(); ++s4) {
+            auto bf4_first = shell2bf[s4];
+            auto n4 = shells[s4].size();
+
+            decltype(bf4_first) lo_r1 = lo_r[1];
+            decltype(bf4_first) hi_r1 = hi_r[1];
+            if(lo_r1 <= bf4_first && bf4_first <= hi_r1){
+
+              if(schwarz_tol > 0 && SchwarzK[s3*nshells+s4]*k12 < schwarz_tol) continue;
+
+              engine.compute(shells[s3], shells[s4], shells[s1], shells[s2]);
+              const auto *buf_3412 = buf[0];
+              if (buf_3412 == nullptr)
+                continue; // if all integrals screened out, skip to next quartet
+
+              k_eri.resize(n3*n4*np12);
+              for(int64_t p = 0; p < np12; p++) {
+                const auto bfu   = pivots[p0+p]/nbf;
+                const auto bfv   = pivots[p0+p]%nbf;
+                const auto ind12 = (bfu - shell2bf[s1])*n2 + bfv - shell2bf[s2];
+                for (decltype(n3) f3 = 0; f3 != n3; ++f3) {
+                  for (decltype(n4) f4 = 0; f4 != n4; ++f4) {
+                    auto f3412 = f3*n4*n12 + f4*n12 + ind12;
+                    k_eri[(f3*n4+f4)*np12 + p] = buf_3412[f3412];
+                  }
+                }
               }
-            }
-                
-            const void *fbuf = &k_eri[0];
-            //TODO
-            int64_t ibflo[2] = {cd_ncast<size_t>(bf3_first),cd_ncast<size_t>(bf4_first)};
-            int64_t ibfhi[2] = {cd_ncast<size_t>(bf3_first+n3-1),cd_ncast<size_t>(bf4_first+n4-1)};
-            int64_t ld[1] = {cd_ncast<size_t>(n4)}; //n3                  
-            NGA_Put64(g_r,ibflo,ibfhi,const_cast<void*>(fbuf),ld);
+
+              int64_t ibflo[3] = {cd_ncast<size_t>(bf3_first),cd_ncast<size_t>(bf4_first),p0};
+              int64_t ibfhi[3] = {cd_ncast<size_t>(bf3_first+n3-1),cd_ncast<size_t>(bf4_first+n4-1),p1-1};
+              int64_t ld[2] = {cd_ncast<size_t>(n4),np12};
+              NGA_Put64(g_r,ibflo,ibfhi,&k_eri[0],ld);
             } //if s4
           } //s4
-      } //if s3
-    } //s3
+        } //if s3
+      } //s3
+      p0 = p1;
+    }
     NGA_Sync();
 
-    // Step F. Update the residual
-    lo_x[0] = indx_d0[0];
-    lo_x[1] = indx_d0[1];
-    lo_x[2] = 0;
-    hi_x[0] = indx_d0[0];
-    hi_x[1] = indx_d0[1];
-    hi_x[2] = count; //count>0? count : 0;
-    ld_x[0] = 1;
-    ld_x[1] = hi_x[2]+1;
-
+    // Step F. Update the residual with the existing vectors as one GEMM:
+    // R(uv,p) -= sum_k L(uv,k) L(piv_p,k)
     TensorType *indx_b, *indx_d, *indx_r;
-    std::vector<TensorType> k_elems(max_cvecs);
-    TensorType* k_row = &k_elems[0];
-    NGA_Get64(g_chol, lo_x, hi_x, k_row, ld_x);
-    NGA_Access64(g_r, lo_r, hi_r, &indx_r, ld_r);
-    NGA_Access64(g_chol, lo_b, hi_b, &indx_b, ld_b);
-
-    for(decltype(count) icount = 0;icount < count; icount++){
-      for(int64_t i = 0; i<= hi_r[0] - lo_r[0]; i++) {
-        for(int64_t j = 0; j <= hi_r[1] - lo_r[1]; j++) {
-          indx_r[i*ld_r[0] + j] -= indx_b[icount+j*ld_b[1] 
-                                   + i * ld_b[1]*ld_b[0]] * k_row[icount];
-        }
+    const int64_t nloc_r = (hi_r[0]-lo_r[0]+1)*(hi_r[1]-lo_r[1]+1);
+    if(count > 0) {
+      k_lpiv.resize(npiv*count);
+      for(int64_t p = 0; p < npiv; p++) {
+        lo_x[0] = pivots[p]/nbf; lo_x[1] = pivots[p]%nbf; lo_x[2] = 0;
+        hi_x[0] = lo_x[0];       hi_x[1] = lo_x[1];       hi_x[2] = count-1;
+        ld_x[0] = 1;
+        ld_x[1] = count;
+        NGA_Get64(g_chol, lo_x, hi_x, &k_lpiv[p*count], ld_x);
+      }
+      NGA_Access64(g_r, lo_r, hi_r, &indx_r, ld_r);
+      NGA_Access64(g_chol, lo_b, hi_b, &indx_b, ld_b);
+
+      blas::gemm(blas::Layout::RowMajor, blas::Op::NoTrans, blas::Op::Trans,
+                 nloc_r, npiv, count, -1.0, indx_b, ld_b[1], &k_lpiv[0], count,
+                 1.0, indx_r, ld_r[1]);
+
+      NGA_Release64(g_chol,lo_b,hi_b);
+      NGA_Release_update64(g_r,lo_r,hi_r);
+      NGA_Sync();
+    }
+
+    // Step G. Pivoted Cholesky of the residual between the pivots themselves,
+    // replicated on every rank. k_lsmall(p,c) is vector c at pivot p.
+    k_q.resize(npiv*npiv);
+    for(int64_t p = 0; p < npiv; p++) {
+      lo_x[0] = pivots[p]/nbf; lo_x[1] = pivots[p]%nbf; lo_x[2] = 0;
+      hi_x[0] = lo_x[0];       hi_x[1] = lo_x[1];       hi_x[2] = npiv-1;
+      ld_x[0] = 1;
+      ld_x[1] = npiv;
+      NGA_Get64(g_r, lo_x, hi_x, &k_q[p*npiv], ld_x);
+    }
+
+    std::vector<int64_t> sel;
+    std::vector<TensorType> qdiag(npiv);
+    std::vector<bool> used(npiv, false);
+    for(int64_t p = 0; p < npiv; p++) qdiag[p] = k_q[p*npiv+p];
+    k_lsmall.assign(npiv*npiv, 0);
+    while(static_cast<int64_t>(sel.size()) < npiv) {
+      int64_t pmax = -1;
+      for(int64_t p = 0; p < npiv; p++)
+        if(!used[p] && (pmax < 0 || qdiag[p] > qdiag[pmax])) pmax = p;
+      if(qdiag[pmax] <= piv_tol) break;
+
+      const int64_t c = sel.size();
+      const TensorType lpp = std::sqrt(qdiag[pmax]);
+      for(int64_t p = 0; p < npiv; p++) {
+        TensorType tmp = k_q[p*npiv+pmax];
+        for(int64_t c1 = 0; c1 < c; c1++) tmp -= k_lsmall[p*npiv+c1]*k_lsmall[pmax*npiv+c1];
+        k_lsmall[p*npiv+c] = used[p] ? 0 : tmp/lpp;
       }
+      k_lsmall[pmax*npiv+c] = lpp;
+      for(int64_t p = 0; p < npiv; p++)
+        if(!used[p]) qdiag[p] -= k_lsmall[p*npiv+c]*k_lsmall[p*npiv+c];
+      used[pmax] = true;
+      sel.push_back(pmax);
     }
+    const int64_t nsel = sel.size();
+    if(nsel == 0) break;
 
-    NGA_Release64(g_chol,lo_b,hi_b);
-    NGA_Release_update64(g_r,lo_r,hi_r);
+    // Step H. The new vectors solve L_new T^T = R(:,sel), with T the
+    // triangular factor at the selected pivots
+    k_tri.assign(nsel*nsel, 0);
+    for(int64_t c = 0; c < nsel; c++)
+      for(int64_t c1 = 0; c1 <= c; c1++)
+        k_tri[c*nsel+c1] = k_lsmall[sel[c]*npiv+c1];
 
-    // Step G. Compute the new Cholesky vector
     NGA_Access64(g_r,lo_r,hi_r,&indx_r,ld_r);
     NGA_Access64(g_chol,lo_b,hi_b,&indx_b,ld_b);
 
-    for(auto i = 0; i <= hi_r[0] - lo_r[0]; i++) {
-      for(auto j = 0; j <= hi_r[1] - lo_r[1]; j++) {
-        auto tmp = indx_r[i*ld_r[0]+j]/sqrt(val_d0);
-        indx_b[count+j*ld_b[1]+i*ld_b[1]*ld_b[0]] = tmp;
-      }
-    }
+    for(int64_t ij = 0; ij < nloc_r; ij++)
+      for(int64_t c = 0; c < nsel; c++)
+        indx_b[ij*ld_b[1] + count + c] = indx_r[ij*ld_r[1] + sel[c]];
 
-    NGA_Release_update64(g_chol,lo_b,hi_b);
-    NGA_Release64(g_r,lo_r,hi_r);
+    blas::trsm(blas::Layout::RowMajor, blas::Side::Right, blas::Uplo::Lower,
+               blas::Op::Trans, blas::Diag::NonUnit, nloc_r, nsel, 1.0,
+               &k_tri[0], nsel, indx_b + count, ld_b[1]);
 
-    //Step H. Increment count
-    count++;
+    NGA_Release64(g_r,lo_r,hi_r);
 
-    //Step I. Update the diagonal
+    // Step I. Update the diagonal
     NGA_Access64(g_d,lo_d,hi_d,&indx_d,ld_d);
-    NGA_Access64(g_chol,lo_b,hi_b,&indx_b,ld_b);
 
     for(auto i = 0;i<= hi_d[0] - lo_d[0];i++) {
       for(auto j = 0; j<= hi_d[1] - lo_d[1];j++) {
-        auto tmp = indx_b[count-1 + j*ld_b[1] + i*ld_b[1]*ld_b[0]];
-        indx_d[i*ld_d[0]+j] -= tmp*tmp;
+        const auto* lij = indx_b + (i*ld_b[0] + j)*ld_b[1] + count;
+        for(int64_t c = 0; c < nsel; c++)
+          indx_d[i*ld_d[0]+j] -= lij[c]*lij[c];
       }
     }
 
-    NGA_Release64(g_chol,lo_b,hi_b);
+    NGA_Release_update64(g_chol,lo_b,hi_b);
     NGA_Release_update64(g_d,lo_d,hi_d);
 
+    //Step J. Increment count
+    count += nsel;
 
-    // Step J. Find the coordinates of the maximum element of the diagonal.
-    NGA_Select_elem64(g_d,const_cast<char*>("max"),&val_d0,indx_d0);
+    // Step K. Pick the next batch of pivots
+    select_pivots();
 
   }
 
@@ -563,17 +700,6 @@ Tensor<TensorType> cd_svd_ga(SystemData& sys_data, ExecutionContext& ec, TiledIn
   g_chol_mo = NGA_Create_irreg64(ga_eltype,3,dimsmo,const_cast<char*>("CholXMO"),nblockmo,&k_map[0]);
   GA_Zero(g_chol_mo);
 
-  std::vector<TensorType> k_pj(N*nbf);
-  std::vector<TensorType> k_pq(N*N);
-
-  std::vector<TensorType> k_ij(nbf*nbf);
-  std::vector<TensorType> k_eval_r(nbf);
-  
-  #define DO_SVD 0
-  #if DO_SVD
-    auto svdtol = 1e-8; //TODO same as diagtol ?
-  #endif 
-
   hf_t1 = std::chrono::high_resolution_clock::now();
   double cvpr_time = 0;
 
@@ -595,93 +721,119 @@ Tensor<TensorType> cd_svd_ga(SystemData& sys_data, ExecutionContext& ec, TiledIn
   }
   GA_Pgroup_sync(ga_pg);
 
+  // Only the alpha-alpha and beta-beta blocks of CholVpr are non-zero, so each
+  // spin is transformed with its own spatial coefficients C_s (nbf x ns):
+  // P_s = C_s^T X C_s. The source columns of lcao follow reshape_mo_matrix.
+  const int64_t noa  = sys_data.n_occ_alpha;
+  const int64_t nob  = sys_data.n_occ_beta;
+  const int64_t nva  = sys_data.n_vir_alpha;
+  const int64_t nvb  = sys_data.n_vir_beta;
+  const int64_t nocc = sys_data.nocc;
+  const int64_t nfc  = sys_data.n_frozen_core;
+  const int64_t nfv  = sys_data.n_frozen_virtual;
+
+  struct SpinBlock {
+    int64_t no, nv;       // active occupied and virtual orbitals
+    int64_t src_o, src_v; // first column in lcao
+    int64_t tgt_o, tgt_v; // first index in CholVpr
+    std::vector<TensorType> coeff;
+  };
+  SpinBlock spin_a{noa, nva, nfc,         2*nfc+nocc+nfv,         0,   nocc,     {}};
+  SpinBlock spin_b{nob, nvb, 2*nfc+noa,   2*nfc+nocc+2*nfv+nva,   noa, nocc+nva, {}};
+
+  for(auto* sb: {&spin_a, &spin_b}) {
+    const int64_t ns = sb->no + sb->nv;
+    sb->coeff.resize(nbf*ns);
+    for(int64_t mu = 0; mu < nbf; mu++) {
+      std::copy_n(k_movecs_sorted + mu*N + sb->src_o, sb->no, &sb->coeff[mu*ns]);
+      std::copy_n(k_movecs_sorted + mu*N + sb->src_v, sb->nv, &sb->coeff[mu*ns + sb->no]);
+    }
+  }
+  // restricted references share one spatial transform
+  const bool same_spatial = spin_a.no + spin_a.nv == spin_b.no + spin_b.nv && spin_a.coeff == spin_b.coeff;
+
+  // Vectors are transformed in contiguous batches, bounded by memory and
+  // small enough to keep every rank busy.
+  const int64_t ns_max   = std::max(spin_a.no+spin_a.nv, spin_b.no+spin_b.nv);
+  const int64_t vec_size = nbf*nbf + nbf*ns_max + ns_max*ns_max;
+  const int64_t nvec_mem = std::max<int64_t>(1, (int64_t{1} << 26)/vec_size);
+  const int64_t nvec     = std::max<int64_t>(1, std::min(nvec_mem, count/GA_Pgroup_nnodes(ga_pg)));
+
+  std::vector<TensorType> k_ij;
+  std::vector<TensorType> k_qj;
+  std::vector<TensorType> k_pq;
+
+  // P_s[p][q][k] for the batch of vectors in X[mu][nu][k]
+  auto transform_spin = [&](const SpinBlock& sb, const int64_t nk) {
+    const int64_t ns = sb.no + sb.nv;
+    if(ns == 0) return;
+    const TensorType* C = sb.coeff.data();
+    k_qj.resize(nbf*ns*nk);
+    k_pq.resize(ns*ns*nk);
+
+    // X is symmetric in (mu,nu), so the first half transform is one GEMM:
+    // Y[q][mu][k] = sum_nu C[nu][q] X[nu][mu][k]
+    blas::gemm(blas::Layout::RowMajor,blas::Op::Trans,blas::Op::NoTrans,ns,nbf*nk,nbf,
+               1,C,ns,&k_ij[0],nbf*nk,0,&k_qj[0],nbf*nk);
+
+    // P[p][q][k] = sum_mu C[mu][p] Y[q][mu][k], only for p <= q since P is
+    // symmetric as well; the lower triangle is filled by copy
+    for(int64_t q = 0; q < ns; q++)
+      blas::gemm(blas::Layout::RowMajor,blas::Op::Trans,blas::Op::NoTrans,q+1,nk,nbf,
+                 1,C,ns,&k_qj[q*nbf*nk],nk,0,&k_pq[q*nk],ns*nk);
+    for(int64_t q = 0; q < ns; q++)
+      for(int64_t p = 0; p < q; p++)
+        std::copy_n(&k_pq[(p*ns+q)*nk], nk, &k_pq[(q*ns+p)*nk]);
+  };
+
+  // write the oo, ov, vo and vv blocks of P_s into CholVpr
+  auto put_spin = [&](const SpinBlock& sb, const int64_t k0, const int64_t nk) {
+    const int64_t ns = sb.no + sb.nv;
+    const int64_t off[2] = {0, sb.no};
+    const int64_t len[2] = {sb.no, sb.nv};
+    const int64_t tgt[2] = {sb.tgt_o, sb.tgt_v};
+    for(int a = 0; a < 2; a++) {
+      for(int b = 0; b < 2; b++) {
+        if(len[a] == 0 || len[b] == 0) continue;
+        int64_t lo_mo[3] = {tgt[a],tgt[b],k0};
+        int64_t hi_mo[3] = {tgt[a]+len[a]-1,tgt[b]+len[b]-1,k0+nk-1};
+        int64_t ld_mo[2] = {ns,nk};
+        NGA_Put64(g_chol_mo,lo_mo,hi_mo,&k_pq[(off[a]*ns+off[b])*nk],ld_mo);
+      }
+    }
+  };
+
   int64_t taskcount = 0;
   int64_t next = ac_fetch_add(ga_ac, 0, 1);
 
-  const bool do_freeze = (sys_data.n_frozen_core > 0 || sys_data.n_frozen_virtual > 0);
-
-  for(decltype(count) kk=0;kk<count;kk++) {
+  for(int64_t k0 = 0; k0 < count; k0 += nvec) {
     if(next == taskcount) {
+      const int64_t nk = std::min(nvec, count-k0);
 
-      int64_t lo_ao[3] = {0,0,kk};
-      int64_t hi_ao[3] = {nbf-1,nbf-1,kk};
-      int64_t ld_ao[2] = {nbf,1};
+      int64_t lo_ao[3] = {0,0,k0};
+      int64_t hi_ao[3] = {nbf-1,nbf-1,k0+nk-1};
+      int64_t ld_ao[2] = {nbf,nk};
 
+      k_ij.resize(nbf*nbf*nk);
       NGA_Get64(g_chol, lo_ao, hi_ao, &k_ij[0], ld_ao);
 
-      #if DO_SVD
-        //uplotri
-        for(auto i=0;i<nbf;i++)
-          for(auto j=i+1;j<nbf;j++)
-            k_ij[i*nbf+j] = 0;
-
-        //TODO
-        LAPACKE_dsyevd(LAPACK_ROW_MAJOR,'V','L',(BLA_LAPACK_INT)nbf,
-          &k_ij[0],(BLA_LAPACK_INT)nbf, &k_eval_r[0]);
-
-        auto m = 0;
-        for(auto i=0;i<nbf;i++){
-          if(fabs(k_eval_r[i]) <= svdtol) continue;
-          k_eval_r[m] = k_eval_r[i];
-          for(auto x=0;x<nbf;x++)
-            k_ij[m*nbf+x] = k_ij[i*nbf+x]; 
-          m++;
-        }
-
-        std::vector<TensorType> k_ij_tmp(nbf*m);
-          for(auto i=0;i<nbf;i++)
-            for(auto j=0;j<m;j++)
-              k_ij_tmp[i*m+j] = k_ij[j*nbf+i];
-
-        g_num += m;
-        std::vector<TensorType> k_pi(N*m);
-        std::vector<TensorType> k_qj(N*m);
-         
-        blas::gemm(blas::Layout::RowMajor,blas::Op::Trans,blas::Op::NoTrans,N,m,nbf,
-                    1.0,k_movecs_sorted,N,&k_ij[0],nbf,0,&k_pi[0],N);
-
-        for(auto x=0;x<N*m;x++) k_qj[x] = k_pi[x]; 
-
-        for(auto i=0;i<N;i++){
-          auto sf = k_eval_r[i];
-          for (auto j=0;j<m;j++)
-            k_pi[i*m+j] *= sf;
-        }
-
-        blas::gemm(blas::Layout::RowMajor,blas::Op::NoTrans,blas::Op::Trans,N,N,m,
-                1,&k_pi[0],N,&k_qj[0],N,0,&k_pq[0],N);
-
-      #else
-
-        //---------Two-Step-Contraction----
-        auto cvpr_t1 = std::chrono::high_resolution_clock::now();
-        blas::gemm(blas::Layout::RowMajor,blas::Op::Trans,blas::Op::NoTrans,N,nbf,nbf,
-                    1,k_movecs_sorted,N,&k_ij[0],nbf,0,&k_pj[0],nbf);
-        
-        blas::gemm(blas::Layout::RowMajor,blas::Op::NoTrans,blas::Op::NoTrans,N,N,nbf,
-                    1,&k_pj[0],nbf,k_movecs_sorted,N,0,&k_pq[0],N);
-      
-        auto cvpr_t2 = std::chrono::high_resolution_clock::now();
-        cvpr_time   += std::chrono::duration_cast<std::chrono::duration<double>>((cvpr_t2 - cvpr_t1)).count();
-
-      #endif
-
-      int64_t lo_mo[3] = {0,0,kk};
-      int64_t hi_mo[3] = {N_eff-1,N_eff-1,kk};
-      int64_t ld_mo[2] = {N_eff,1};
-
-      if(do_freeze) {
-        Matrix emat = Eigen::Map<Matrix>(k_pq.data(),N,N);
-        k_pq.clear();
-
-        Matrix cvec = reshape_mo_matrix(sys_data,emat);
-
-        k_pq.resize(N_eff*N_eff); 
-        Eigen::Map<Matrix>(k_pq.data(), N_eff, N_eff) = cvec;
-        cvec.resize(0,0);
+      //---------Two-Step-Contraction----
+      auto cvpr_t1 = std::chrono::high_resolution_clock::now();
+
+      transform_spin(spin_a, nk);
+      if(same_spatial) {
+        put_spin(spin_a, k0, nk);
+        put_spin(spin_b, k0, nk);
+      }
+      else {
+        put_spin(spin_a, k0, nk);
+        transform_spin(spin_b, nk);
+        put_spin(spin_b, k0, nk);
       }
 
-      NGA_Put64(g_chol_mo,lo_mo,hi_mo,&k_pq[0],ld_mo);
+      auto cvpr_t2 = std::chrono::high_resolution_clock::now();
+      cvpr_time   += std::chrono::duration_cast<std::chrono::duration<double>>((cvpr_t2 - cvpr_t1)).count();
+
       next = ac_fetch_add(ga_ac, 0, 1);
     } 
     taskcount++;
@@ -691,10 +843,9 @@ Tensor<TensorType> cd_svd_ga(SystemData& sys_data, ExecutionContext& ec, TiledIn
 
   NGA_Destroy(ga_ac);
   NGA_Destroy(g_chol);
-  k_pj.clear();
-  k_pq.clear();
-  k_ij.clear();
-  k_eval_r.clear(); k_eval_r.shrink_to_fit();
+  k_pq.clear(); k_pq.shrink_to_fit();
+  k_qj.clear(); k_qj.shrink_to_fit();
+  k_ij.clear(); k_ij.shrink_to_fit();
 
   hf_t2   = std::chrono::high_resolution_clock::now();
   hf_time = std::chrono::duration_cast<std::chrono::duration<double>>((hf_t2 - hf_t1)).count();
@@ -6,205 +6,137 @@
 
 namespace tamm {
 
-template<typename T>
-inline void jacobi(ExecutionContext& ec, Tensor<T>& d_r, Tensor<T>& d_t,
-                   T shift, bool transpose, std::vector<double>& evl_sorted, 
-                   const TAMM_SIZE& n_occ_alpha, const TAMM_SIZE& n_occ_beta) {
-    // EXPECTS(transpose == false);
-    block_for(ec, d_r(), [&](IndexVector blockid) {
-        const TAMM_SIZE rsize = d_r.block_size(blockid);
-        std::vector<T> rbuf(rsize);
-        d_r.get(blockid, rbuf);
-
-        const TAMM_SIZE tsize = d_t.block_size(blockid);
-
-        std::vector<T> tbuf(tsize);
-
-        auto& rtiss      = d_r.tiled_index_spaces();
-        auto rblock_dims = d_r.block_dims(blockid);
+namespace detail {
 
-        TAMM_SIZE noab = n_occ_alpha+n_occ_beta;
-        std::vector<double> p_evl_sorted_occ(noab);
-        std::vector<double> p_evl_sorted_virt(evl_sorted.size()-noab);
-        std::copy(evl_sorted.begin(), evl_sorted.begin() + noab,
-                  p_evl_sorted_occ.begin());
-        std::copy(evl_sorted.begin() + noab, evl_sorted.end(),
-                  p_evl_sorted_virt.begin());
-
-        if(d_r.num_modes() == 2) {
-            auto ioff  = rtiss[0].tile_offset(blockid[0]);
-            auto joff  = rtiss[1].tile_offset(blockid[1]);
-            auto isize = rblock_dims[0];
-            auto jsize = rblock_dims[1];
-
-            if(!transpose) {
-                for(auto i = 0U, c = 0U; i < isize; i++) {
-                    for(auto j = 0U; j < jsize; j++, c++) {
-                        tbuf[c] =
-                          rbuf[c] / (-p_evl_sorted_virt[ioff + i] +
-                                     p_evl_sorted_occ[joff + j] + shift);
-                    }
-                }
-            } else {
-                for(auto i = 0U, c = 0U; i < isize; i++) {
-                    for(auto j = 0U; j < jsize; j++, c++) {
-                        tbuf[c] =
-                          rbuf[c] / (p_evl_sorted_occ[ioff + i] -
-                                     p_evl_sorted_virt[joff + j] + shift);
-                    }
+/**
+ * @brief Jacobi update of one 2- or 4-index block: t = r / D (or t += r / D
+ * when @p accumulate) with D the orbital energy denominator plus shift.
+ *
+ * @param denom denom[m] holds the signed orbital energies of mode m over the
+ *        block, so that D = shift + sum_m denom[m][i_m]
+ * @return sum of squares of r over the block
+ */
+template<typename T>
+inline T jacobi_block(const T* r, T* t, bool accumulate, T shift,
+                      const std::vector<size_t>& dims,
+                      const std::vector<std::vector<double>>& denom) {
+    T rsq = 0;
+    if(dims.size() == 2) {
+        const double* d0 = denom[0].data();
+        const double* d1 = denom[1].data();
+        for(size_t i = 0, c = 0; i < dims[0]; i++, c += dims[1]) {
+            const double base = d0[i] + shift;
+            #pragma omp simd reduction(+:rsq)
+            for(size_t j = 0; j < dims[1]; j++) {
+                const T v = r[c + j] / (base + d1[j]);
+                t[c + j]  = accumulate ? t[c + j] + v : v;
+                rsq += r[c + j] * r[c + j];
+            }
+        }
+    } else {
+        const double* d0 = denom[0].data();
+        const double* d1 = denom[1].data();
+        const double* d2 = denom[2].data();
+        const double* d3 = denom[3].data();
+        size_t c = 0;
+        for(size_t i0 = 0; i0 < dims[0]; i0++)
+        for(size_t i1 = 0; i1 < dims[1]; i1++) {
+            const double b01 = d0[i0] + d1[i1] + shift;
+            for(size_t i2 = 0; i2 < dims[2]; i2++, c += dims[3]) {
+                const double base = b01 + d2[i2];
+                #pragma omp simd reduction(+:rsq)
+                for(size_t i3 = 0; i3 < dims[3]; i3++) {
+                    const T v = r[c + i3] / (base + d3[i3]);
+                    t[c + i3] = accumulate ? t[c + i3] + v : v;
+                    rsq += r[c + i3] * r[c + i3];
                 }
             }
-            d_t.add(blockid, tbuf);
-        } else if(d_r.num_modes() == 4) {
-            
-            auto rblock_offset = d_r.block_offsets(blockid);
+        }
+    }
+    return rsq;
+}
 
-            std::vector<size_t> ioff;
-            for(auto x : rblock_offset) { ioff.push_back(x); }
-            std::vector<size_t> isize;
-            for(auto x : rblock_dims) { isize.push_back(x); }
+/**
+ * @brief Jacobi update d_t += d_r / D over the blocks of d_r owned by this
+ * rank (visited with internal::local_block_for), reading d_r from its local
+ * buffer. When d_t has the same layout the
+ * update is written to its local buffer too, otherwise through d_t.add().
+ *
+ * The first half of the modes of d_r are virtual and the second half
+ * occupied (swapped when @p transpose).
+ * @return local sum of squares of d_r
+ */
+template<typename T>
+inline T jacobi_local(ExecutionContext& ec, Tensor<T>& d_r, Tensor<T>& d_t,
+                      T shift, bool transpose,
+                      const std::vector<double>& evl_occ,
+                      const std::vector<double>& evl_virt) {
+    const size_t nmodes = d_r.num_modes();
+    EXPECTS(nmodes == 2 || nmodes == 4);
+
+    const bool same_layout = internal::same_local_layout(ec, d_r, d_t);
+
+    EXPECTS(internal::has_local_blocks(ec, d_r));
+    const T* rbase = d_r.access_local_buf();
+    T* tbase       = same_layout ? d_t.access_local_buf() : nullptr;
+
+    std::vector<std::vector<double>> denom(nmodes);
+    std::vector<T> tbuf;
+    T rsq = 0;
+    internal::local_block_for(ec, d_r(), [&](const IndexVector& blockid, T* r, size_t size) {
+        const auto dims = d_r.block_dims(blockid);
+        const auto offs = d_r.block_offsets(blockid);
+        for(size_t m = 0; m < nmodes; m++) {
+            const bool virt = (m < nmodes / 2) != transpose;
+            const auto& evl = virt ? evl_virt : evl_occ;
+            denom[m].resize(dims[m]);
+            for(size_t i = 0; i < dims[m]; i++)
+                denom[m][i] = virt ? -evl[offs[m] + i] : evl[offs[m] + i];
+        }
 
-            if(!transpose) {
-                for(auto i0 = 0U, c = 0U; i0 < isize[0]; i0++) {
-                    for(auto i1 = 0U; i1 < isize[1]; i1++) {
-                        for(auto i2 = 0U; i2 < isize[2]; i2++) {
-                            for(auto i3 = 0U; i3 < isize[3]; i3++, c++) {
-                                tbuf[c] =
-                                  rbuf[c] /
-                                  (-p_evl_sorted_virt[ioff[0] + i0] -
-                                   p_evl_sorted_virt[ioff[1] + i1] +
-                                   p_evl_sorted_occ[ioff[2] + i2] +
-                                   p_evl_sorted_occ[ioff[3] + i3] + shift);
-                            }
-                        }
-                    }
-                }
-            } else {
-                for(auto i0 = 0U, c = 0U; i0 < isize[0]; i0++) {
-                    for(auto i1 = 0U; i1 < isize[1]; i1++) {
-                        for(auto i2 = 0U; i2 < isize[2]; i2++) {
-                            for(auto i3 = 0U; i3 < isize[3]; i3++, c++) {
-                                tbuf[c] =
-                                  rbuf[c] /
-                                  (p_evl_sorted_occ[ioff[0] + i0] +
-                                   p_evl_sorted_occ[ioff[1] + i1] -
-                                   p_evl_sorted_virt[ioff[2] + i2] -
-                                   p_evl_sorted_virt[ioff[3] + i3] + shift);
-                            }
-                        }
-                    }
-                }
-            }
-            d_t.add(blockid, tbuf);
+        if(same_layout) {
+            rsq += jacobi_block(r, tbase + (r - rbase), true, shift, dims, denom);
         } else {
-            assert(0); // @todo implement
+            tbuf.resize(size);
+            rsq += jacobi_block(r, tbuf.data(), false, shift, dims, denom);
+            d_t.add(blockid, tbuf);
         }
     });
-    // GA_Sync();
+    ec.pg().barrier();
+    return rsq;
 }
 
+} // namespace detail
+
+/**
+ * @brief Jacobi update d_t += d_r / D for spin-orbital 2- and 4-index tensors.
+ * @return local (this rank's) sum of squares of d_r
+ */
 template<typename T>
-inline void jacobi_cs(ExecutionContext& ec, Tensor<T>& d_r, Tensor<T>& d_t,
+inline T jacobi(ExecutionContext& ec, Tensor<T>& d_r, Tensor<T>& d_t,
+                T shift, bool transpose, std::vector<double>& evl_sorted, 
+                const TAMM_SIZE& n_occ_alpha, const TAMM_SIZE& n_occ_beta) {
+    const TAMM_SIZE noab = n_occ_alpha + n_occ_beta;
+    const std::vector<double> evl_occ(evl_sorted.begin(), evl_sorted.begin() + noab);
+    const std::vector<double> evl_virt(evl_sorted.begin() + noab, evl_sorted.end());
+    return detail::jacobi_local(ec, d_r, d_t, shift, transpose, evl_occ, evl_virt);
+}
+
+/**
+ * @brief Jacobi update d_t += d_r / D for closed-shell 2- and 4-index tensors.
+ * @return local (this rank's) sum of squares of d_r
+ */
+template<typename T>
+inline T jacobi_cs(ExecutionContext& ec, Tensor<T>& d_r, Tensor<T>& d_t,
                    T shift, bool transpose, std::vector<double>& evl_sorted, 
                    const TAMM_SIZE& n_occ_alpha, const TAMM_SIZE& n_vir_alpha,
                    const bool not_spin_orbital=false) {
-    // EXPECTS(transpose == false);
-    block_for(ec, d_r(), [&](IndexVector blockid) {
-        const TAMM_SIZE rsize = d_r.block_size(blockid);
-        std::vector<T> rbuf(rsize);
-        d_r.get(blockid, rbuf);
-
-        const TAMM_SIZE tsize = d_t.block_size(blockid);
-
-        std::vector<T> tbuf(tsize);
-
-        auto& rtiss      = d_r.tiled_index_spaces();
-        auto rblock_dims = d_r.block_dims(blockid);
-
-        TAMM_SIZE noa  = n_occ_alpha;
-        TAMM_SIZE noab = n_occ_alpha + n_occ_alpha;
-        TAMM_SIZE nva  = n_vir_alpha;
-        std::vector<double> p_evl_sorted_occ(noa);
-        std::vector<double> p_evl_sorted_virt(nva);
-        std::copy(evl_sorted.begin(), evl_sorted.begin() + noa,
-                  p_evl_sorted_occ.begin());
-        if(not_spin_orbital)
-            std::copy(evl_sorted.begin() + noa, evl_sorted.begin() + noa + nva,
-                        p_evl_sorted_virt.begin());
-        else
-            std::copy(evl_sorted.begin() + noab, evl_sorted.begin() + noab + nva,
-                  p_evl_sorted_virt.begin());
-
-        if(d_r.num_modes() == 2) {
-            auto ioff  = rtiss[0].tile_offset(blockid[0]);
-            auto joff  = rtiss[1].tile_offset(blockid[1]);
-            auto isize = rblock_dims[0];
-            auto jsize = rblock_dims[1];
-
-            if(!transpose) {
-                for(auto i = 0U, c = 0U; i < isize; i++) {
-                    for(auto j = 0U; j < jsize; j++, c++) {
-                        tbuf[c] =
-                          rbuf[c] / (-p_evl_sorted_virt[ioff + i] +
-                                     p_evl_sorted_occ[joff + j] + shift);
-                    }
-                }
-            } else {
-                for(auto i = 0U, c = 0U; i < isize; i++) {
-                    for(auto j = 0U; j < jsize; j++, c++) {
-                        tbuf[c] =
-                          rbuf[c] / (p_evl_sorted_occ[ioff + i] -
-                                     p_evl_sorted_virt[joff + j] + shift);
-                    }
-                }
-            }
-            d_t.add(blockid, tbuf);
-        } else if(d_r.num_modes() == 4) {
-            
-            auto rblock_offset = d_r.block_offsets(blockid);
-
-            std::vector<size_t> ioff;
-            for(auto x : rblock_offset) { ioff.push_back(x); }
-            std::vector<size_t> isize;
-            for(auto x : rblock_dims) { isize.push_back(x); }
-
-            if(!transpose) {
-                for(auto i0 = 0U, c = 0U; i0 < isize[0]; i0++) {
-                    for(auto i1 = 0U; i1 < isize[1]; i1++) {
-                        for(auto i2 = 0U; i2 < isize[2]; i2++) {
-                            for(auto i3 = 0U; i3 < isize[3]; i3++, c++) {
-                                tbuf[c] =
-                                  rbuf[c] /
-                                  (-p_evl_sorted_virt[ioff[0] + i0] -
-                                   p_evl_sorted_virt[ioff[1] + i1] +
-                                   p_evl_sorted_occ[ioff[2] + i2] +
-                                   p_evl_sorted_occ[ioff[3] + i3] + shift);
-                            }
-                        }
-                    }
-                }
-            } else {
-                for(auto i0 = 0U, c = 0U; i0 < isize[0]; i0++) {
-                    for(auto i1 = 0U; i1 < isize[1]; i1++) {
-                        for(auto i2 = 0U; i2 < isize[2]; i2++) {
-                            for(auto i3 = 0U; i3 < isize[3]; i3++, c++) {
-                                tbuf[c] =
-                                  rbuf[c] /
-                                  (p_evl_sorted_occ[ioff[0] + i0] +
-                                   p_evl_sorted_occ[ioff[1] + i1] -
-                                   p_evl_sorted_virt[ioff[2] + i2] -
-                                   p_evl_sorted_virt[ioff[3] + i3] + shift);
-                            }
-                        }
-                    }
-                }
-            }
-            d_t.add(blockid, tbuf);
-        } else {
-            assert(0); // @todo implement
-        }
-    });
-    // GA_Sync();
+    const TAMM_SIZE noa  = n_occ_alpha;
+    const TAMM_SIZE voff = not_spin_orbital ? noa : noa + noa;
+    const std::vector<double> evl_occ(evl_sorted.begin(), evl_sorted.begin() + noa);
+    const std::vector<double> evl_virt(evl_sorted.begin() + voff,
+                                       evl_sorted.begin() + voff + n_vir_alpha);
+    return detail::jacobi_local(ec, d_r, d_t, shift, transpose, evl_occ, evl_virt);
 }
 
 template<typename T>
@@ -344,6 +276,136 @@ inline T ddot(ExecutionContext& ec, LabeledTensor<T> lta,
     return ret;
 }
 
+/**
+ * @brief DIIS extrapolation over a fixed set of history slots.
+ *
+ * The residual overlap matrix B is kept between calls: update() computes
+ * only the rows of the slots whose residuals were just stored, with all dot
+ * products of a call batched into one tamm::dots reduction. The
+ * extrapolation works directly on the local buffers of the tensors, which
+ * must all have the same tiled index spaces and distribution as the
+ * extrapolated tensors.
+ *
+ * @tparam T Type of element in each tensor
+ */
+template<typename T>
+class DIIS {
+ public:
+  /**
+   * @param ec Execution context in which the tensors are allocated
+   * @param d_rs d_rs[k][i] is the residual of tensor k in slot i
+   * @param d_ts d_ts[k][i] is the amplitude of tensor k in slot i
+   */
+  DIIS(ExecutionContext& ec, std::vector<std::vector<Tensor<T>>> d_rs,
+       std::vector<std::vector<Tensor<T>>> d_ts)
+    : ec_{ec}, d_rs_{std::move(d_rs)}, d_ts_{std::move(d_ts)} {
+    EXPECTS(!d_rs_.empty() && d_rs_.size() == d_ts_.size());
+    ndiis_ = d_rs_[0].size();
+    EXPECTS(ndiis_ > 0);
+    for(size_t k = 0; k < d_rs_.size(); k++) {
+      EXPECTS(d_rs_[k].size() == ndiis_ && d_ts_[k].size() == ndiis_);
+      for(size_t i = 0; i < ndiis_; i++) {
+        check_layout(d_rs_[k][0], d_rs_[k][i]);
+        check_layout(d_rs_[k][0], d_ts_[k][i]);
+      }
+    }
+    B_     = Matrix::Zero(ndiis_, ndiis_);
+    valid_ = std::vector<bool>(ndiis_, false);
+  }
+
+  /**
+   * @brief Compute the rows of B for slots whose residuals have changed.
+   *
+   * Collective on the process group of @p ec.
+   * @param slots History slots just (re)written
+   */
+  void update(const std::vector<size_t>& slots) {
+    for(auto i: slots) valid_.at(i) = true;
+    std::vector<size_t> cols;
+    for(size_t j = 0; j < ndiis_; j++)
+      if(valid_[j]) cols.push_back(j);
+
+    const size_t ncols = cols.size();
+    std::vector<Tensor<T>> xs, ys;
+    for(size_t k = 0; k < d_rs_.size(); k++)
+      for(size_t a = 0; a < slots.size(); a++)
+        for(size_t c = 0; c < ncols; c++) {
+          xs.push_back(d_rs_[k][slots[a]]);
+          ys.push_back(d_rs_[k][cols[c]]);
+        }
+    const std::vector<T> kdots = tamm::dots(ec_, xs, ys);
+    std::vector<T> g_dots(slots.size() * ncols, 0);
+    for(size_t i = 0; i < kdots.size(); i++) g_dots[i % g_dots.size()] += kdots[i];
+
+    for(size_t a = 0; a < slots.size(); a++)
+      for(size_t c = 0; c < ncols; c++) {
+        B_(slots[a], cols[c]) = g_dots[a * ncols + c];
+        B_(cols[c], slots[a]) = g_dots[a * ncols + c];
+      }
+  }
+
+  void update(size_t slot) { update(std::vector<size_t>{slot}); }
+
+  /**
+   * @brief Mark all slots as stale, e.g. after the history was refilled.
+   */
+  void reset() { valid_.assign(ndiis_, false); }
+
+  /**
+   * @brief d_t[k] = sum_j x_j d_ts[k][j] over the updated slots, with x the
+   * DIIS coefficients. Collective on the process group of @p ec.
+   */
+  void extrapolate(std::vector<Tensor<T>> d_t) {
+    EXPECTS(d_t.size() == d_rs_.size());
+    std::vector<size_t> slots;
+    for(size_t j = 0; j < ndiis_; j++)
+      if(valid_[j]) slots.push_back(j);
+    const size_t nv = slots.size();
+    EXPECTS(nv > 0);
+
+    Matrix A = Matrix::Zero(nv + 1, nv + 1);
+    Matrix b = Matrix::Zero(nv + 1, 1);
+    for(size_t i = 0; i < nv; i++) {
+      for(size_t j = 0; j < nv; j++) A(i, j) = B_(slots[i], slots[j]);
+      A(i, nv) = -1.0;
+      A(nv, i) = -1.0;
+    }
+    b(nv, 0) = -1;
+    Matrix x = A.lu().solve(b);
+
+    for(size_t k = 0; k < d_t.size(); k++) {
+      check_layout(d_rs_[k][0], d_t[k]);
+      T* dt          = d_t[k].access_local_buf();
+      const size_t n = d_t[k].local_buf_size();
+      std::vector<const T*> tb(nv);
+      for(size_t j = 0; j < nv; j++) tb[j] = d_ts_[k][slots[j]].access_local_buf();
+      for(size_t e = 0; e < n; e++) {
+        T v = 0;
+        for(size_t j = 0; j < nv; j++) v += x(j, 0) * tb[j][e];
+        dt[e] = v;
+      }
+    }
+    ec_.pg().barrier();
+  }
+
+ private:
+  using Matrix =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  static void check_layout(const Tensor<T>& a, const Tensor<T>& b) {
+    EXPECTS(a.tiled_index_spaces() == b.tiled_index_spaces());
+    EXPECTS(a.distribution().kind() == b.distribution().kind());
+    EXPECTS(a.local_buf_size() == b.local_buf_size());
+  }
+
+  ExecutionContext& ec_;
+  std::vector<std::vector<Tensor<T>>> d_rs_;
+  std::vector<std::vector<Tensor<T>>> d_ts_;
+  size_t ndiis_;
+  Matrix B_;
+  std::vector<bool> valid_;
+};
+
 /**
  * @brief DIIS routine
  * @tparam T Type of element in each tensor
@@ -360,63 +422,13 @@ inline void diis(ExecutionContext& ec,
                  std::vector<std::vector<Tensor<T>>>& d_rs,
                  std::vector<std::vector<Tensor<T>>>& d_ts,
                  std::vector<Tensor<T>> d_t) {
-
     EXPECTS(d_t.size() == d_rs.size());
-    size_t ntensors = d_t.size();
-    EXPECTS(ntensors > 0);
-    size_t ndiis = d_rs[0].size();
-    EXPECTS(ndiis > 0);
-    for(auto i = 0U; i < ntensors; i++) { EXPECTS(d_rs[i].size() == ndiis); }
-
-    using Matrix =
-      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
-    using Vector =
-      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
-    Matrix A = Matrix::Zero(ndiis + 1, ndiis + 1);
-    Vector b = Vector::Zero(ndiis + 1, 1);
-    for(auto k = 0U; k < ntensors; k++) {
-        for(auto i = 0U; i < ndiis; i++) {
-            for(auto j = i; j < ndiis; j++) {
-                Tensor<T> d_r1{};
-                Tensor<T>::allocate(&ec,d_r1);
-                Tensor<T>& t1 = d_rs[k].at(i);
-                Tensor<T>& t2 = d_rs[k].at(j);
-                //A(i, j) += ddot(ec, (*d_rs[k]->at(i))(), (*d_rs[k]->at(j))());                
-                Scheduler{ec}(d_r1() = t1() * t2()).execute();
-
-                A(i,j) += get_scalar(d_r1);
-                Tensor<T>::deallocate(d_r1);
-            }
-        }
-    }
-
-    for(auto i = 0U; i < ndiis; i++) {
-        for(auto j = i; j < ndiis; j++) { A(j, i) = A(i, j); }
-    }
-    for(auto i = 0U; i < ndiis; i++) {
-        A(i, ndiis) = -1.0;
-        A(ndiis, i) = -1.0;
-    }
-
-    b(ndiis, 0) = -1;
-
-    // Solve AX = B
-    // call dgesv(diis+1,1,a,maxdiis+1,iwork,b,maxdiis+1,info)
-    // Vector x = A.colPivHouseholderQr().solve(b);
-    Vector x = A.lu().solve(b);
-
-    auto sch = Scheduler{ec};
-    for(auto k = 0U; k < ntensors; k++) {
-        Tensor<T>& dt = d_t[k];
-        sch(dt() = 0);
-        for(auto j = 0U; j < ndiis; j++) {
-            auto& tb = d_ts[k].at(j);
-            sch(dt() += x(j, 0) * tb());
-        }
-    }
-    // GA_Sync();
-    sch.execute();
-    // GA_Sync();
+    EXPECTS(!d_rs.empty());
+    DIIS<T> engine{ec, d_rs, d_ts};
+    std::vector<size_t> slots(d_rs[0].size());
+    std::iota(slots.begin(), slots.end(), 0);
+    engine.update(slots);
+    engine.extrapolate(d_t);
 }
 
 } // namespace tamm
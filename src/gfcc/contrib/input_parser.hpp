@@ -113,6 +113,9 @@ class SCFOptions: public Options {
       scf_type       = "restricted";
       xc_type        = ""; //pbe0
       alpha          = 0.7;
+      incfock        = false;
+      incfock_rebuild = 8;
+      taskmap_imbalance = 0;
       nnodes         = 1;
       writem         = diis_hist;
       scalapack_nb   = 64;
@@ -148,6 +151,9 @@ class SCFOptions: public Options {
   int n_lindep;
   int writem; 
   double alpha; //density mixing parameter
+  bool   incfock; //build the Fock matrix from the density change between iterations
+  int    incfock_rebuild; //incremental Fock builds between two full builds
+  double taskmap_imbalance; //rebalance the Fock task map when max/avg rank load exceeds this (e.g. 1.1), 0 (default) to disable
   std::string scf_type;
   std::string xc_type;
 
@@ -167,6 +173,12 @@ class SCFOptions: public Options {
       cout << " writem       = " << writem       << endl;
       if(alpha != 0.7) 
         cout << " alpha        = " << alpha << endl;
+      if(incfock) {
+        print_bool(" incfock     ", incfock);
+        cout << " incfock_rebuild = " << incfock_rebuild << endl;
+      }
+      if(taskmap_imbalance > 0)
+        cout << " taskmap_imbalance = " << taskmap_imbalance << endl;
       if(!moldenfile.empty()) {
         cout << " moldenfile   = " << moldenfile << endl;    
         //cout << " n_lindep = " << n_lindep << endl;
@@ -204,10 +216,16 @@ class CDOptions: public Options {
       // At most 8*ao CholVec's. For vast majority cases, this is way
       // more than enough. For very large basis, it can be increased.
       max_cvecs_factor = 12; 
+      batch_size       = 1;
+      schwarz_tol      = 0;
     }
 
   double diagtol;
   int    max_cvecs_factor;
+  //Max. number of pivots (Cholesky vectors) added per pass, 1 is the one-pivot algorithm
+  int    batch_size;
+  //Shell quartets with a Schwarz bound below this are skipped, 0 disables the screening
+  double schwarz_tol;
 
   void print() {
     std::cout << std::defaultfloat;
@@ -215,6 +233,8 @@ class CDOptions: public Options {
     cout << "{" << endl;
     cout << " diagtol          = " << diagtol          << endl;
     cout << " max_cvecs_factor = " << max_cvecs_factor << endl;
+    cout << " batch_size       = " << batch_size       << endl;
+    cout << " schwarz_tol      = " << schwarz_tol      << endl;
     print_bool(" debug           ", debug);   
     cout << "}" << endl; 
   }
@@ -304,6 +324,8 @@ class CCSDOptions: public Options {
     writet_iter    = ndiis;
     readt          = false;
     computeTData   = false;
+    collective_io  = false;
+    writet_async   = false;
 
     localize       = false;
     skip_dlpno     = false;
@@ -320,6 +342,7 @@ class CCSDOptions: public Options {
 
     ngpu           = 0;
     ccsdt_tilesize = 28;
+    ccsdt_cache_mem= 1;
 
     eom_nroots     = 1;
     eom_threshold  = 1e-6;
@@ -347,6 +370,10 @@ class CCSDOptions: public Options {
     gf_eta               = 0.01;
     gf_lshift            = 1.0;
     gf_preconditioning   = true;
+    gf_shifted_krylov    = false;
+    gf_async_scheduler   = false;
+    gf_shifted_maxdim    = 20;
+    gf_block_size        = 1;
     gf_damping_factor    = 1.0;
     gf_nprocs_poi        = 0;
     // gf_omega          = -0.4; //a.u (range min to max)     
@@ -374,6 +401,10 @@ class CCSDOptions: public Options {
   bool   readt, writet, writev, gf_restart, gf_ip, gf_ea, gf_os, gf_cs, 
          gf_itriples, gf_profile, balance_tiles, computeTData;
   bool   profile_ccsd;
+  //Write and read the checkpointed tensors with collective MPI-IO
+  bool   collective_io;
+  //Write the amplitudes from a helper thread while the iterations continue
+  bool   writet_async;
   double lshift;
   double printtol;
   double threshold;
@@ -393,6 +424,8 @@ class CCSDOptions: public Options {
   //CCSD(T)
   int    ngpu;
   int    ccsdt_tilesize;
+  //GiB per rank for the (T) block caches, 0 to disable them
+  double ccsdt_cache_mem;
 
   //DLPNO
   bool   localize;
@@ -423,6 +456,14 @@ class CCSDOptions: public Options {
   double gf_eta;
   double gf_lshift;
   bool   gf_preconditioning;
+  //Solve all frequencies of a level from one Krylov space per orbital
+  bool   gf_shifted_krylov;
+  //Krylov vectors kept per orbital by the shifted solver, each the size of an IP vector
+  int    gf_shifted_maxdim;
+  //Number of orbitals solved together as one batched GMRES
+  size_t gf_block_size;
+  //Run the per-orbital schedulers without barriers between dependency levels
+  bool   gf_async_scheduler;
   int    gf_nprocs_poi;
   double gf_damping_factor;
   // double gf_omega;       
@@ -452,6 +493,7 @@ class CCSDOptions: public Options {
       cout << " ngpu                 = " << ngpu          << endl;
       cout << " ccsdt_tilesize       = " << ccsdt_tilesize << endl;
     }
+    cout << " ccsdt_cache_mem      = " << ccsdt_cache_mem  << endl;
     cout << " ndiis                = " << ndiis            << endl;
     cout << " printtol             = " << printtol         << endl;
     cout << " threshold            = " << threshold        << endl;
@@ -473,6 +515,8 @@ class CCSDOptions: public Options {
     print_bool(" writev              ", writev);
     // print_bool(" computeTData        ", computeTData);    
     cout << " writet_iter          = " << writet_iter      << endl;
+    print_bool(" collective_io       ", collective_io);
+    print_bool(" writet_async        ", writet_async);
     print_bool(" profile_ccsd        ", profile_ccsd);
     print_bool(" balance_tiles       ", balance_tiles);
     
@@ -508,6 +552,14 @@ class CCSDOptions: public Options {
       cout << " gf_eta               = " << gf_eta            << endl;
       cout << " gf_lshift            = " << gf_lshift         << endl;
       cout << " gf_preconditioning   = " << gf_preconditioning<< endl;
+      if(gf_async_scheduler)
+        print_bool(" gf_async_scheduler  ", gf_async_scheduler);
+      if(gf_block_size > 1)
+        cout << " gf_block_size        = " << gf_block_size << endl;
+      if(gf_shifted_krylov) {
+        print_bool(" gf_shifted_krylov   ", gf_shifted_krylov);
+        cout << " gf_shifted_maxdim    = " << gf_shifted_maxdim << endl;
+      }
       cout << " gf_damping_factor    = " << gf_damping_factor << endl;
       
       // cout << " gf_omega       = " << gf_omega << endl;
@@ -604,6 +656,9 @@ std::tuple<Options, SCFOptions, CDOptions, GWOptions, CCSDOptions> parse_json(js
     parse_option<uint32_t>(scf_options.dfAO_tilesize , jscf, "df_tilesize");
     parse_option<double>(scf_options.alpha           , jscf, "alpha");
     parse_option<int>   (scf_options.writem          , jscf, "writem");    
+    parse_option<bool>  (scf_options.incfock         , jscf, "incfock");
+    parse_option<int>   (scf_options.incfock_rebuild , jscf, "incfock_rebuild");
+    parse_option<double>(scf_options.taskmap_imbalance, jscf, "taskmap_imbalance");
     parse_option<int>   (scf_options.nnodes          , jscf, "nnodes");                                     
     parse_option<bool>  (scf_options.restart         , jscf, "restart"); 
     parse_option<bool>  (scf_options.noscf           , jscf, "noscf");     
@@ -631,6 +686,8 @@ std::tuple<Options, SCFOptions, CDOptions, GWOptions, CCSDOptions> parse_json(js
     parse_option<bool>  (cd_options.debug           , jcd, "debug");    
     parse_option<double>(cd_options.diagtol         , jcd, "diagtol");
     parse_option<int>   (cd_options.max_cvecs_factor, jcd, "max_cvecs");    
+    parse_option<int>   (cd_options.batch_size      , jcd, "batch_size");
+    parse_option<double>(cd_options.schwarz_tol     , jcd, "schwarz_tol");
     parse_option<string>(cd_options.ext_data_path   , jcd, "ext_data_path");  
 
     //GW
@@ -673,6 +730,8 @@ std::tuple<Options, SCFOptions, CDOptions, GWOptions, CCSDOptions> parse_json(js
     parse_option<bool>  (ccsd_options.writet        , jcc, "writet");
     parse_option<bool>  (ccsd_options.writev        , jcc, "writev");
     parse_option<int>   (ccsd_options.writet_iter   , jcc, "writet_iter");           
+    parse_option<bool>  (ccsd_options.collective_io , jcc, "collective_io");
+    parse_option<bool>  (ccsd_options.writet_async  , jcc, "writet_async");
     parse_option<bool>  (ccsd_options.balance_tiles , jcc, "balance_tiles");
     parse_option<bool>  (ccsd_options.profile_ccsd  , jcc, "profile_ccsd");                
     parse_option<bool>  (ccsd_options.force_tilesize, jcc, "force_tilesize");     
@@ -704,6 +763,7 @@ std::tuple<Options, SCFOptions, CDOptions, GWOptions, CCSDOptions> parse_json(js
     json jccsd_t = jcc["CCSD(T)"];
     parse_option<int>(ccsd_options.ngpu          , jccsd_t, "ngpu"); 
     parse_option<int>(ccsd_options.ccsdt_tilesize, jccsd_t, "ccsdt_tilesize");    
+    parse_option<double>(ccsd_options.ccsdt_cache_mem, jccsd_t, "ccsdt_cache_mem");
 
     json jeomccsd = jcc["EOMCCSD"];
     parse_option<int>   (ccsd_options.eom_nroots   , jeomccsd, "eom_nroots");   
@@ -731,6 +791,10 @@ std::tuple<Options, SCFOptions, CDOptions, GWOptions, CCSDOptions> parse_json(js
     parse_option<double>(ccsd_options.gf_eta              , jgfcc, "gf_eta");
     parse_option<double>(ccsd_options.gf_lshift           , jgfcc, "gf_lshift");
     parse_option<bool>  (ccsd_options.gf_preconditioning  , jgfcc, "gf_preconditioning");
+    parse_option<bool>  (ccsd_options.gf_shifted_krylov   , jgfcc, "gf_shifted_krylov");
+    parse_option<int>   (ccsd_options.gf_shifted_maxdim   , jgfcc, "gf_shifted_maxdim");
+    parse_option<size_t>(ccsd_options.gf_block_size       , jgfcc, "gf_block_size");
+    parse_option<bool>  (ccsd_options.gf_async_scheduler  , jgfcc, "gf_async_scheduler");
     parse_option<double>(ccsd_options.gf_threshold        , jgfcc, "gf_threshold");
     parse_option<double>(ccsd_options.gf_omega_min_ip     , jgfcc, "gf_omega_min_ip"); 
     parse_option<double>(ccsd_options.gf_omega_max_ip     , jgfcc, "gf_omega_max_ip");  
@@ -152,6 +152,7 @@ void write_json_data(SystemData& sys_data, const std::string module){
   results["input"]["SCF"]["diis_hist"] = scf.diis_hist;
   results["input"]["SCF"]["AO_tilesize"] = scf.AO_tilesize;
   results["input"]["SCF"]["force_tilesize"] = str_bool(scf.force_tilesize);
+  results["input"]["SCF"]["incfock"] = str_bool(scf.incfock);
   results["input"]["SCF"]["scf_type"] = scf.scf_type;
   results["input"]["SCF"]["multiplicity"] = scf.multiplicity;
 
@@ -159,6 +160,8 @@ void write_json_data(SystemData& sys_data, const std::string module){
     //CD options
     results["input"]["CD"]["diagtol"] = cd.diagtol;
     results["input"]["CD"]["max_cvecs_factor"] = cd.max_cvecs_factor;
+    results["input"]["CD"]["batch_size"] = cd.batch_size;
+    results["input"]["CD"]["schwarz_tol"] = cd.schwarz_tol;
   }
 
   if(module == "CCSD") {
@@ -170,6 +173,8 @@ void write_json_data(SystemData& sys_data, const std::string module){
     results["input"]["CCSD"]["ndiis"] = ccsd.ndiis;
     results["input"]["CCSD"]["readt"] = str_bool(ccsd.readt);
     results["input"]["CCSD"]["writet"] = str_bool(ccsd.writet);
+    results["input"]["CCSD"]["collective_io"] = str_bool(ccsd.collective_io);
+    results["input"]["CCSD"]["writet_async"] = str_bool(ccsd.writet_async);
     results["input"]["CCSD"]["ccsd_maxiter"] = ccsd.ccsd_maxiter;
     results["input"]["CCSD"]["balance_tiles"] = str_bool(ccsd.balance_tiles);
   }
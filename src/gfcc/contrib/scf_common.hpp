@@ -2,6 +2,7 @@
 #pragma once
 
 #include <cctype>
+#include <mutex>
 
 #include "misc.hpp"
 #include "molden.hpp"
@@ -19,6 +20,10 @@
 #include <gauxc/xc_integrator/impl.hpp>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace tamm;
 using std::cerr;
 using std::cout;
@@ -32,6 +37,23 @@ using shellpair_data_t = std::vector<std::vector<std::shared_ptr<libint2::ShellP
 
 const auto max_engine_precision = std::numeric_limits<double>::epsilon() / 1e10;
 
+// threads available to the integral loops of each rank, and the calling thread
+inline int scf_nthreads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+inline int scf_thread_id() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
 Tensor<TensorType> vxc_tamm; //TODO: cleanup
 
 struct SCFVars {
@@ -92,7 +114,10 @@ struct EigenTensors {
   Matrix C,C_beta,C_occ; // only rank 0 allocates C_occ, C{a,b}
   Matrix G,D,VXC;
   Matrix G_beta,D_beta;
+  Matrix D_fock,D_beta_fock; // densities of the last Fock build, for incremental builds
+  int    nfock_inc = 0;      // incremental Fock builds since the last full build
   Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> taskmap;
+  Matrix taskcost; // time (s) this rank spent on each of its taskmap entries in the last Fock build
 };
 
 struct TAMMTensors {
@@ -381,17 +381,29 @@ template<typename TensorType>
 void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars& scf_vars,
       const libint2::BasisSet& obs, const bool do_schwarz_screen, const std::vector<size_t>& shell2bf,
       const Matrix& SchwarzK, const size_t& max_nprim4, libint2::BasisSet& shells,
-      TAMMTensors& ttensors, EigenTensors& etensors, bool& is_3c_init, const bool do_density_fitting=false, double xHF = 1.) {
+      TAMMTensors& ttensors, EigenTensors& etensors, bool& is_3c_init, const bool do_density_fitting=false, double xHF = 1.,
+      const bool incfock = false) {
 
       using libint2::Operator;
 
       const bool is_uhf = sys_data.is_unrestricted;
       const bool is_rhf = sys_data.is_restricted;
 
+      // incremental build (not for density fitting): G[D] = G[D_fock] + G[D - D_fock],
+      // where G still holds this rank's part of G[D_fock] from the previous build
+      const auto& scf_options = sys_data.options_map.scf_options;
+      const bool incremental = incfock && !do_density_fitting && etensors.D_fock.size() != 0 &&
+                               etensors.nfock_inc < scf_options.incfock_rebuild;
+      Matrix dD, dD_beta;
+      if(incremental) {
+        dD = etensors.D - etensors.D_fock;
+        if(is_uhf) dD_beta = etensors.D_beta - etensors.D_beta_fock;
+      }
+
       Matrix& G      = etensors.G;
-      Matrix& D      = etensors.D; 
+      const Matrix& D      = incremental ? dD : etensors.D; 
       Matrix& G_beta = etensors.G_beta;
-      Matrix& D_beta = etensors.D_beta;
+      const Matrix& D_beta = incremental ? dD_beta : etensors.D_beta;
 
       // Tensor<TensorType>& F_dummy  = ttensors.F_dummy;
       Tensor<TensorType>& F_alpha_tmp = ttensors.F_alpha_tmp;
@@ -409,6 +421,11 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
 
       auto do_t1 = std::chrono::high_resolution_clock::now();
       Matrix D_shblk_norm =  compute_shellblock_norm(obs, D);  // matrix of infty-norms of shell blocks
+
+      // screening of the difference density starts looser and tightens to the
+      // precision of a full build as the density converges
+      if(incremental)
+        fock_precision = std::clamp(1e-4 * D_shblk_norm.maxCoeff(), fock_precision, 1e2 * fock_precision);
       
       //TODO: Revisit
       double engine_precision = fock_precision;
@@ -418,142 +435,148 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
           "using precomputed shell pair data limits the max engine precision"
           " ... make max_engine_precision smaller and recompile");
 
-      // construct the 2-electron repulsion integrals engine pool
+      // construct the 2-electron repulsion integrals engine pool, one engine per thread
       using libint2::Engine;
+      const int nthreads = scf_nthreads();
       Engine engine(Operator::coulomb, obs.max_nprim(), obs.max_l(), 0);
 
       engine.set_precision(engine_precision);
-      const auto& buf = engine.results();
+      std::vector<Engine> engines(nthreads, engine);
 
       #if 1
-        auto comp_2bf_lambda = [&](IndexVector blockid) {
+        // contributions of the quartets (s1 s2|s3 s4) with s4 <= s3, for a single s3.
+        // Every contribution lands in a row of shell s1, s2 or s3, so they are
+        // accumulated into the panel Gp (and Gp_beta) holding the rows of s1, then
+        // of s2, then of s3, over the columns up to the end of s1 (s4 <= s3 <= s1
+        // and s2 <= s1). Returns false if all quartets were screened out.
+        auto comp_2bf_lambda = [&](size_t s1, size_t s2, const libint2::ShellPair* sp12, size_t s3,
+                                   Engine& engine, Matrix& Gp, Matrix& Gp_beta) {
+
+          const auto& buf = engine.results();
+          bool touched = false;
 
-          auto s1 = blockid[0];
           auto bf1_first = shell2bf[s1]; 
           auto n1 = obs[s1].size();
-          auto sp12_iter = scf_vars.obs_shellpair_data.at(s1).begin();
-
-          auto s2 = blockid[1];
-          auto s2spl = scf_vars.obs_shellpair_list.at(s1);
-          auto s2_itr = std::find(s2spl.begin(),s2spl.end(),s2);
-          if(s2_itr == s2spl.end()) return;
-          auto s2_pos = std::distance(s2spl.begin(),s2_itr);
           auto bf2_first = shell2bf[s2];
           auto n2 = obs[s2].size();
-
-          std::advance(sp12_iter,s2_pos);
-          const auto* sp12 = sp12_iter->get();
         
           const auto Dnorm12 = do_schwarz_screen ? D_shblk_norm(s1, s2) : 0.;
 
-          for (decltype(s1) s3 = 0; s3 <= s1; ++s3) {
-            auto bf3_first = shell2bf[s3];
-            auto n3 = obs[s3].size();
+          auto bf3_first = shell2bf[s3];
+          auto n3 = obs[s3].size();
 
-            const auto Dnorm123 =
-                do_schwarz_screen
-                    ? std::max(D_shblk_norm(s1, s3),
-                      std::max(D_shblk_norm(s2, s3), Dnorm12))
-                    : 0.;
+          Gp.setZero(n1 + n2 + n3, bf1_first + n1);
+          if(is_uhf) Gp_beta.setZero(n1 + n2 + n3, bf1_first + n1);
 
-            auto sp34_iter = scf_vars.obs_shellpair_data.at(s3).begin();
+          const auto Dnorm123 =
+              do_schwarz_screen
+                  ? std::max(D_shblk_norm(s1, s3),
+                    std::max(D_shblk_norm(s2, s3), Dnorm12))
+                  : 0.;
 
-            const auto s4_max = (s1 == s3) ? s2 : s3;
-            for (const auto& s4 : scf_vars.obs_shellpair_list.at(s3)) {
-              if (s4 > s4_max)
-                break;  // for each s3, s4 are stored in monotonically increasing
-                        // order
+          auto sp34_iter = scf_vars.obs_shellpair_data.at(s3).begin();
 
-              // must update the iter even if going to skip s4
-              const auto* sp34 = sp34_iter->get();
-              ++sp34_iter;
+          const auto s4_max = (s1 == s3) ? s2 : s3;
+          for (const auto& s4 : scf_vars.obs_shellpair_list.at(s3)) {
+            if (s4 > s4_max)
+              break;  // for each s3, s4 are stored in monotonically increasing
+                      // order
 
-              const auto Dnorm1234 =
-                  do_schwarz_screen
-                      ? std::max(D_shblk_norm(s1, s4),
-                        std::max(D_shblk_norm(s2, s4),
-                        std::max(D_shblk_norm(s3, s4), Dnorm123)))
-                      : 0.;
+            // must update the iter even if going to skip s4
+            const auto* sp34 = sp34_iter->get();
+            ++sp34_iter;
 
-              if (do_schwarz_screen &&
-                  Dnorm1234 * SchwarzK(s1, s2) * SchwarzK(s3, s4) < fock_precision)
-                continue;
+            const auto Dnorm1234 =
+                do_schwarz_screen
+                    ? std::max(D_shblk_norm(s1, s4),
+                      std::max(D_shblk_norm(s2, s4),
+                      std::max(D_shblk_norm(s3, s4), Dnorm123)))
+                    : 0.;
 
-              auto bf4_first = shell2bf[s4];
-              auto n4 = obs[s4].size();
-
-              // compute the permutational degeneracy (i.e. # of equivalents) of
-              // the given shell set
-              auto s12_deg = (s1 == s2) ? 1 : 2;
-              auto s34_deg = (s3 == s4) ? 1 : 2;
-              auto s12_34_deg = (s1 == s3) ? (s2 == s4 ? 1 : 2) : 2;
-              auto s1234_deg = s12_deg * s34_deg * s12_34_deg;
-
-              engine.compute2<Operator::coulomb, libint2::BraKet::xx_xx, 0>(
-                obs[s1], obs[s2], obs[s3], obs[s4], sp12, sp34); 
-                
-              const auto* buf_1234 = buf[0];
-              if (buf_1234 == nullptr)
-                continue; // if all integrals screened out, skip to next quartet
-
-              // 1) each shell set of integrals contributes up to 6 shell sets of
-              // the Fock matrix:
-              //    F(a,b) += 1/2 * (ab|cd) * D(c,d)
-              //    F(c,d) += 1/2 * (ab|cd) * D(a,b)
-              //    F(b,d) -= 1/8 * (ab|cd) * D(a,c)
-              //    F(b,c) -= 1/8 * (ab|cd) * D(a,d)
-              //    F(a,c) -= 1/8 * (ab|cd) * D(b,d)
-              //    F(a,d) -= 1/8 * (ab|cd) * D(b,c)
-              // 2) each permutationally-unique integral (shell set) must be
-              // scaled by its degeneracy,
-              //    i.e. the number of the integrals/sets equivalent to it
-              // 3) the end result must be symmetrized
-              for (decltype(n1) f1 = 0, f1234 = 0; f1 != n1; ++f1) {
-                const auto bf1 = f1 + bf1_first;
-                for (decltype(n2) f2 = 0; f2 != n2; ++f2) {
-                  const auto bf2 = f2 + bf2_first;
-                  for (decltype(n3) f3 = 0; f3 != n3; ++f3) {
-                    const auto bf3 = f3 + bf3_first;
-                    for (decltype(n4) f4 = 0; f4 != n4; ++f4, ++f1234) {
-                      const auto bf4 = f4 + bf4_first;
-  
-                      const auto value = buf_1234[f1234];
-                      const auto value_scal_by_deg = value * s1234_deg;
-
-                      if(is_uhf) {
-                        //alpha_part
-                        G(bf1, bf2)      += 0.5   * D(bf3, bf4) * value_scal_by_deg;
-                        G(bf3, bf4)      += 0.5   * D(bf1, bf2) * value_scal_by_deg;
-                        G(bf1, bf2)      += 0.5   * D_beta(bf3, bf4) * value_scal_by_deg;
-                        G(bf3, bf4)      += 0.5   * D_beta(bf1, bf2) * value_scal_by_deg;
-                        G(bf1, bf3)      -= xHF*0.25  * D(bf2, bf4) * value_scal_by_deg;
-                        G(bf2, bf4)      -= xHF*0.25  * D(bf1, bf3) * value_scal_by_deg;
-                        G(bf1, bf4)      -= xHF*0.25  * D(bf2, bf3) * value_scal_by_deg;
-                        G(bf2, bf3)      -= xHF*0.25  * D(bf1, bf4) * value_scal_by_deg;
-                        //beta_part
-                        G_beta(bf1, bf2) += 0.5   * D_beta(bf3, bf4) * value_scal_by_deg;
-                        G_beta(bf3, bf4) += 0.5   * D_beta(bf1, bf2) * value_scal_by_deg;
-                        G_beta(bf1, bf2) += 0.5   * D(bf3, bf4) * value_scal_by_deg;
-                        G_beta(bf3, bf4) += 0.5   * D(bf1, bf2) * value_scal_by_deg;
-                        G_beta(bf1, bf3) -= xHF*0.25  * D_beta(bf2, bf4) * value_scal_by_deg;
-                        G_beta(bf2, bf4) -= xHF*0.25  * D_beta(bf1, bf3) * value_scal_by_deg;
-                        G_beta(bf1, bf4) -= xHF*0.25  * D_beta(bf2, bf3) * value_scal_by_deg;
-                        G_beta(bf2, bf3) -= xHF*0.25  * D_beta(bf1, bf4) * value_scal_by_deg;
-                      }
-                      if(is_rhf) {
-                        G(bf1, bf2)      += 0.5   * D(bf3, bf4) * value_scal_by_deg;
-                        G(bf3, bf4)      += 0.5   * D(bf1, bf2) * value_scal_by_deg;
-                        G(bf1, bf3)      -= xHF*0.125 * D(bf2, bf4) * value_scal_by_deg;
-                        G(bf2, bf4)      -= xHF*0.125 * D(bf1, bf3) * value_scal_by_deg;
-                        G(bf1, bf4)      -= xHF*0.125 * D(bf2, bf3) * value_scal_by_deg;
-                        G(bf2, bf3)      -= xHF*0.125 * D(bf1, bf4) * value_scal_by_deg;
-                      }
+            if (do_schwarz_screen &&
+                Dnorm1234 * SchwarzK(s1, s2) * SchwarzK(s3, s4) < fock_precision)
+              continue;
+
+            auto bf4_first = shell2bf[s4];
+            auto n4 = obs[s4].size();
+
+            // compute the permutational degeneracy (i.e. # of equivalents) of
+            // the given shell set
+            auto s12_deg = (s1 == s2) ? 1 : 2;
+            auto s34_deg = (s3 == s4) ? 1 : 2;
+            auto s12_34_deg = (s1 == s3) ? (s2 == s4 ? 1 : 2) : 2;
+            auto s1234_deg = s12_deg * s34_deg * s12_34_deg;
+
+            engine.compute2<Operator::coulomb, libint2::BraKet::xx_xx, 0>(
+              obs[s1], obs[s2], obs[s3], obs[s4], sp12, sp34); 
+              
+            const auto* buf_1234 = buf[0];
+            if (buf_1234 == nullptr)
+              continue; // if all integrals screened out, skip to next quartet
+            touched = true;
+
+            // 1) each shell set of integrals contributes up to 6 shell sets of
+            // the Fock matrix:
+            //    F(a,b) += 1/2 * (ab|cd) * D(c,d)
+            //    F(c,d) += 1/2 * (ab|cd) * D(a,b)
+            //    F(b,d) -= 1/8 * (ab|cd) * D(a,c)
+            //    F(b,c) -= 1/8 * (ab|cd) * D(a,d)
+            //    F(a,c) -= 1/8 * (ab|cd) * D(b,d)
+            //    F(a,d) -= 1/8 * (ab|cd) * D(b,c)
+            // 2) each permutationally-unique integral (shell set) must be
+            // scaled by its degeneracy,
+            //    i.e. the number of the integrals/sets equivalent to it
+            // 3) the end result must be symmetrized
+            // p1, p2, p3: panel rows of bf1, bf2, bf3
+            for (decltype(n1) f1 = 0, f1234 = 0; f1 != n1; ++f1) {
+              const auto bf1 = f1 + bf1_first;
+              const auto p1 = f1;
+              for (decltype(n2) f2 = 0; f2 != n2; ++f2) {
+                const auto bf2 = f2 + bf2_first;
+                const auto p2 = n1 + f2;
+                for (decltype(n3) f3 = 0; f3 != n3; ++f3) {
+                  const auto bf3 = f3 + bf3_first;
+                  const auto p3 = n1 + n2 + f3;
+                  for (decltype(n4) f4 = 0; f4 != n4; ++f4, ++f1234) {
+                    const auto bf4 = f4 + bf4_first;
+
+                    const auto value = buf_1234[f1234];
+                    const auto value_scal_by_deg = value * s1234_deg;
+
+                    if(is_uhf) {
+                      //alpha_part
+                      Gp(p1, bf2)      += 0.5   * D(bf3, bf4) * value_scal_by_deg;
+                      Gp(p3, bf4)      += 0.5   * D(bf1, bf2) * value_scal_by_deg;
+                      Gp(p1, bf2)      += 0.5   * D_beta(bf3, bf4) * value_scal_by_deg;
+                      Gp(p3, bf4)      += 0.5   * D_beta(bf1, bf2) * value_scal_by_deg;
+                      Gp(p1, bf3)      -= xHF*0.25  * D(bf2, bf4) * value_scal_by_deg;
+                      Gp(p2, bf4)      -= xHF*0.25  * D(bf1, bf3) * value_scal_by_deg;
+                      Gp(p1, bf4)      -= xHF*0.25  * D(bf2, bf3) * value_scal_by_deg;
+                      Gp(p2, bf3)      -= xHF*0.25  * D(bf1, bf4) * value_scal_by_deg;
+                      //beta_part
+                      Gp_beta(p1, bf2) += 0.5   * D_beta(bf3, bf4) * value_scal_by_deg;
+                      Gp_beta(p3, bf4) += 0.5   * D_beta(bf1, bf2) * value_scal_by_deg;
+                      Gp_beta(p1, bf2) += 0.5   * D(bf3, bf4) * value_scal_by_deg;
+                      Gp_beta(p3, bf4) += 0.5   * D(bf1, bf2) * value_scal_by_deg;
+                      Gp_beta(p1, bf3) -= xHF*0.25  * D_beta(bf2, bf4) * value_scal_by_deg;
+                      Gp_beta(p2, bf4) -= xHF*0.25  * D_beta(bf1, bf3) * value_scal_by_deg;
+                      Gp_beta(p1, bf4) -= xHF*0.25  * D_beta(bf2, bf3) * value_scal_by_deg;
+                      Gp_beta(p2, bf3) -= xHF*0.25  * D_beta(bf1, bf4) * value_scal_by_deg;
+                    }
+                    if(is_rhf) {
+                      Gp(p1, bf2)      += 0.5   * D(bf3, bf4) * value_scal_by_deg;
+                      Gp(p3, bf4)      += 0.5   * D(bf1, bf2) * value_scal_by_deg;
+                      Gp(p1, bf3)      -= xHF*0.125 * D(bf2, bf4) * value_scal_by_deg;
+                      Gp(p2, bf4)      -= xHF*0.125 * D(bf1, bf3) * value_scal_by_deg;
+                      Gp(p1, bf4)      -= xHF*0.125 * D(bf2, bf3) * value_scal_by_deg;
+                      Gp(p2, bf3)      -= xHF*0.125 * D(bf1, bf4) * value_scal_by_deg;
                     }
                   }
                 }
               }
             }
           }
+          return touched;
         };
       #endif
 
@@ -561,15 +584,70 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
     double do_time;
 
       if(!do_density_fitting){
-        G.setZero(N,N);
-        if(is_uhf) G_beta.setZero(N,N);
-        //block_for(ec, F_dummy(), comp_2bf_lambda);
+        if(!incremental) {
+          G.setZero(N,N);
+          if(is_uhf) G_beta.setZero(N,N);
+        }
+
+        // the (s1,s2) blocks owned by this rank are split further over s3, and the
+        // resulting (s1,s2,s3) work items are handed out to threads dynamically
+        struct QuartetRow {
+          size_t s1, s2, s3;
+          const libint2::ShellPair* sp12;
+        };
+        std::vector<QuartetRow> qrows;
         for (Eigen::Index i1=0;i1<etensors.taskmap.rows();i1++)
         for (Eigen::Index j1=0;j1<etensors.taskmap.cols();j1++) {
           if(etensors.taskmap(i1,j1)==-1 || etensors.taskmap(i1,j1) != rank) continue;
-          IndexVector blockid{(tamm::Index)i1,(tamm::Index)j1};
-          comp_2bf_lambda(blockid);
+          const size_t s1 = i1, s2 = j1;
+          const auto& s2spl = scf_vars.obs_shellpair_list.at(s1);
+          auto s2_itr = std::find(s2spl.begin(),s2spl.end(),s2);
+          if(s2_itr == s2spl.end()) continue;
+          auto s2_pos = std::distance(s2spl.begin(),s2_itr);
+          const auto* sp12 = scf_vars.obs_shellpair_data.at(s1)[s2_pos].get();
+          for(size_t s3 = 0; s3 <= s1; ++s3) qrows.push_back({s1, s2, s3, sp12});
+        }
+
+        // measured time of each work item, for balancing the task map
+        const int64_t nqrows = qrows.size();
+        std::vector<double> qcost(nqrows);
+        // the panel of a work item is added to the rows of G of its three shells,
+        // each shell's rows under their own lock
+        std::vector<std::mutex> shell_locks(obs.size());
+        #pragma omp parallel num_threads(nthreads)
+        {
+          const int tid = scf_thread_id();
+          Matrix Gp, Gp_beta;
+
+          auto flush_rows = [&](Matrix& Gx, const Matrix& Gpx, size_t s, Eigen::Index prow) {
+            const auto n = static_cast<Eigen::Index>(obs[s].size());
+            std::lock_guard<std::mutex> lock(shell_locks[s]);
+            Gx.block(shell2bf[s], 0, n, Gpx.cols()) += Gpx.middleRows(prow, n);
+          };
+
+          #pragma omp for schedule(dynamic)
+          for(int64_t q = 0; q < nqrows; q++) {
+            const auto& qr = qrows[q];
+            const auto q_t1 = std::chrono::high_resolution_clock::now();
+            if(comp_2bf_lambda(qr.s1, qr.s2, qr.sp12, qr.s3, engines[tid], Gp, Gp_beta)) {
+              const Eigen::Index n1 = obs[qr.s1].size(), n2 = obs[qr.s2].size();
+              flush_rows(G, Gp, qr.s1, 0);
+              flush_rows(G, Gp, qr.s2, n1);
+              flush_rows(G, Gp, qr.s3, n1 + n2);
+              if(is_uhf) {
+                flush_rows(G_beta, Gp_beta, qr.s1, 0);
+                flush_rows(G_beta, Gp_beta, qr.s2, n1);
+                flush_rows(G_beta, Gp_beta, qr.s3, n1 + n2);
+              }
+            }
+            qcost[q] = std::chrono::duration_cast<std::chrono::duration<double>>(
+                         std::chrono::high_resolution_clock::now() - q_t1).count();
+          }
         }
+
+        etensors.taskcost.setZero(etensors.taskmap.rows(), etensors.taskmap.cols());
+        for(int64_t q = 0; q < nqrows; q++) etensors.taskcost(qrows[q].s1, qrows[q].s2) += qcost[q];
+
         ec.pg().barrier();        
         //symmetrize G
         Matrix Gt = 0.5*(G + G.transpose());
@@ -584,7 +662,18 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
         do_time =
         std::chrono::duration_cast<std::chrono::duration<double>>((do_t2 - do_t1)).count();
 
-        if(rank == 0 && debug) std::cout << std::fixed << std::setprecision(2) << "Fock build: " << do_time << "s, ";
+        if(rank == 0 && debug) {
+          std::cout << std::fixed << std::setprecision(2) << "Fock build: " << do_time << "s";
+          if(incremental) std::cout << std::scientific << " (incremental, precision " << fock_precision << ")";
+          std::cout << std::fixed << ", ";
+        }
+
+        if(incfock) {
+          etensors.nfock_inc = incremental ? etensors.nfock_inc + 1 : 0;
+          etensors.D_fock    = etensors.D;
+          if(is_uhf) etensors.D_beta_fock = etensors.D_beta;
+        }
+        else etensors.D_fock.resize(0,0); // G no longer belongs to D_fock
         
         eigen_to_tamm_tensor_acc(F_alpha_tmp, G);
         if(is_uhf) eigen_to_tamm_tensor_acc(F_beta_tmp, G_beta);
@@ -620,10 +709,10 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
                                         std::max(obs.max_nprim(), dfbs.max_nprim()),
                                         std::max(obs.max_l(), dfbs.max_l()), 0);
             engine.set(libint2::BraKet::xs_xx);
+            engines.assign(nthreads, engine);
 
             auto shell2bf = obs.shell2bf();
             auto shell2bf_df = dfbs.shell2bf();
-            const auto& results = engine.results();
 
             // Tensor<TensorType>::allocate(&ec, Zxy_tamm);
 
@@ -646,8 +735,11 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
                 decltype(s0range_end) s0range_start = 0l;
 
                 if (bi0>0) s0range_start = df_shell_tile_map[bi0-1]+1;
-              
+
+                // the shells of the DF tile fill disjoint slices of dbuf
+                #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
                 for (auto s0 = s0range_start; s0 <= s0range_end; ++s0) {
+                const auto& results = engines[scf_thread_id()].results();
                 // auto n0 = dfbs[s0].size();
                 auto s1range_end = shell_tile_map[bi1];
                 decltype(s1range_end) s1range_start = 0l;
@@ -665,7 +757,7 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
                   // auto n2 = shells[s2].size();
                   // auto n123 = n0*n1*n2;
                   // std::vector<TensorType> tbuf(n123);
-                  engine.compute2<Operator::coulomb, BraKet::xs_xx, 0>(
+                  engines[scf_thread_id()].compute2<Operator::coulomb, BraKet::xs_xx, 0>(
                       dfbs[s0], unitshell, obs[s1], obs[s2]);
                   const auto* buf = results[0];
                   if (buf == nullptr) continue;     
@@ -712,8 +804,7 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
             engine =
                 Engine(libint2::Operator::coulomb, dfbs.max_nprim(), dfbs.max_l(), 0);
             engine.set(BraKet::xs_xs);
-        
-            const auto& buf2 = engine.results();
+            engines.assign(nthreads, engine);
 
             auto compute_2body_2index_ints_lambda = [&](const IndexVector& blockid) {
 
@@ -729,8 +820,12 @@ void compute_2bf(ExecutionContext& ec, const SystemData& sys_data, const SCFVars
               decltype(s1range_end) s1range_start = 0l;
 
               if (bi0>0) s1range_start = df_shell_tile_map[bi0-1]+1;
-              
+
+              // the shells of the first DF tile fill disjoint rows of dbuf
+              #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
               for (auto s1 = s1range_start; s1 <= s1range_end; ++s1) {
+                auto& engine = engines[scf_thread_id()];
+                const auto& buf2 = engine.results();
                 auto n1 = dfbs[s1].size();
 
                 auto s2range_end = df_shell_tile_map[bi1];
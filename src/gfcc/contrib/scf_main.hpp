@@ -830,7 +830,21 @@ hartree_fock(ExecutionContext& exc, const string filename, OptionsMap options_ma
 
         // build a new Fock matrix
         compute_2bf<TensorType>(ec, sys_data, scf_vars, obs, do_schwarz_screen, shell2bf, SchwarzK,
-                                max_nprim4, shells, ttensors, etensors, is_3c_init, do_density_fitting, xHF);
+                                max_nprim4, shells, ttensors, etensors, is_3c_init, do_density_fitting, xHF,
+                                scf_options.incfock);
+
+        // measured load imbalance of the Fock build; rebalances the task map above the threshold
+        // (opt-in, only measured in debug mode otherwise)
+        double fock_imbalance = 1.0;
+        if(!do_density_fitting && (scf_options.taskmap_imbalance > 0 || debug)) {
+          fock_imbalance = rebalanceTaskMap(ec, etensors, scf_options.taskmap_imbalance);
+          if(rank == 0 && debug) {
+            std::cout << "Fock imbalance: " << std::setprecision(2) << fock_imbalance;
+            if(scf_options.taskmap_imbalance > 0 && fock_imbalance > scf_options.taskmap_imbalance)
+              std::cout << " (rebalanced)";
+            std::cout << ", ";
+          }
+        }
 
         //E_Diis
         if(ediis) {
@@ -890,7 +904,7 @@ hartree_fock(ExecutionContext& exc, const string filename, OptionsMap options_ma
           std::cout << ' ' << std::setw(10) << std::fixed << std::setprecision(1) << loop_time << ' ' << endl;
 
           sys_data.results["output"]["SCF"]["iter"][std::to_string(iter)]["data"] = { {"energy", ehf}, {"e_diff", ediff}, {"rmsd", rmsd} };
-          sys_data.results["output"]["SCF"]["iter"][std::to_string(iter)]["profile"] = { {"total_time", loop_time} };
+          sys_data.results["output"]["SCF"]["iter"][std::to_string(iter)]["profile"] = { {"total_time", loop_time}, {"fock_imbalance", fock_imbalance} };
 
         }
 
@@ -156,3 +156,70 @@ void createTaskMap(Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::Row
    }
 
 }
+
+//place each load, heaviest first, on the machine with the least total load so far
+void costLoadBal(Loads &L, NODE_T nMachine)
+{
+    sort(L.loadList.begin(),L.loadList.end(),[](Load a, Load b)
+            {
+                return a.nTasks > b.nTasks;
+            }
+    );
+
+    auto cmp = [](const std::pair<int64_t,NODE_T> &T1,const std::pair<int64_t,NODE_T> &T2)
+    {
+        return T1.first > T2.first;
+    };
+    std::vector< std::pair<int64_t,NODE_T> > pq;
+    for(NODE_T i=0;i<nMachine;i++) pq.push_back(std::make_pair(0,i));
+    std::make_heap(pq.begin(),pq.end(),cmp);
+
+    for(EDGE_T i=0;i<L.nLoads;i++)
+    {
+        std::pop_heap(pq.begin(),pq.end(),cmp);
+        auto& top = pq.back();
+        L.loadList[i].rank = top.second;
+        top.first += L.loadList[i].nTasks;
+        std::push_heap(pq.begin(),pq.end(),cmp);
+    }
+}
+
+/* Load imbalance (max/avg over ranks) of the last Fock build, from the task
+   times measured in compute_2bf. When it exceeds the threshold, the task map
+   is rebuilt with the measured times as task weights. */
+double rebalanceTaskMap(ExecutionContext& ec, EigenTensors& etensors, double threshold)
+{
+    const int rank   = ec.pg().rank().value();
+    const int nranks = ec.pg().size().value();
+
+    double load     = etensors.taskcost.sum();
+    double max_load = ec.pg().allreduce(&load, ReduceOp::max);
+    double sum_load = ec.pg().allreduce(&load, ReduceOp::sum);
+    if(sum_load <= 0) return 1.0;
+
+    double imbalance = max_load * nranks / sum_load;
+    if(threshold <= 0 || imbalance <= threshold) return imbalance;
+
+    // every task is timed by the one rank that owns it
+    Matrix cost = Matrix::Zero(etensors.taskcost.rows(), etensors.taskcost.cols());
+    ec.pg().reduce(etensors.taskcost.data(), cost.data(), (int)cost.size(), ReduceOp::sum, 0);
+
+    if(rank == 0)
+    {
+        Loads L(0);
+        for(Eigen::Index i=0;i<etensors.taskmap.rows();i++)
+        for(Eigen::Index j=0;j<etensors.taskmap.cols();j++)
+        {
+            if(etensors.taskmap(i,j) == -1) continue;
+            // weights in microseconds, at least 1 so that fully screened tasks are still placed
+            VAL_T nTasks = (VAL_T)std::min(std::max(1.0, cost(i,j)*1e6), (double)std::numeric_limits<VAL_T>::max());
+            L.loadList.push_back({L.nLoads,0,(NODE_T)i,(NODE_T)j,nTasks});
+            L.nLoads++;
+        }
+        costLoadBal(L,nranks);
+        createTaskMap(etensors.taskmap,L);
+    }
+    ec.pg().broadcast(etensors.taskmap.data(),etensors.taskmap.size(),0);
+
+    return imbalance;
+}
@@ -24,6 +24,10 @@ double  gf_eta;
 double  gf_lshift;
 double  gf_threshold;
 bool    gf_preconditioning;
+bool    gf_shifted_krylov;
+bool    gf_async_scheduler;
+size_t  gf_shifted_maxdim;
+size_t  gf_block_size;
 double  omega_min_ip;
 double  omega_max_ip;
 double  lomega_min_ip;
@@ -189,75 +193,76 @@ void write_string_to_disk(ExecutionContext& ec, const std::string& tstring, cons
 
 
 
+// Norm of the IP vector (v1_a, v2_aaa, v2_bab) in the GMRES metric, with the
+// three tensor norms taken from a single reduction.
 template<typename T>
-void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Comm &subcomm,
-                   const TiledIndexSpace& MO, Tensor<T>& t1_a,   Tensor<T>& t1_b, 
-                   Tensor<T>& t2_aaaa, Tensor<T>& t2_bbbb, Tensor<T>& t2_abab,
-                   Tensor<T>& f1, Tensor<T>& t2v2_o,
-                   Tensor<T>& lt12_o_a, Tensor<T>& lt12_o_b,
-                   Tensor<T>& ix1_1_1_a, Tensor<T>& ix1_1_1_b,
-                   Tensor<T>& ix2_1_aaaa, Tensor<T>& ix2_1_abab, Tensor<T>& ix2_1_bbbb, Tensor<T>& ix2_1_baba,
-                   Tensor<T>& ix2_2_a, Tensor<T>& ix2_2_b, 
-                   Tensor<T>& ix2_3_a, Tensor<T>& ix2_3_b, 
-                   Tensor<T>& ix2_4_aaaa, Tensor<T>& ix2_4_abab, Tensor<T>& ix2_4_bbbb, 
-                   Tensor<T>& ix2_5_aaaa, Tensor<T>& ix2_5_abba, Tensor<T>& ix2_5_abab, 
-                   Tensor<T>& ix2_5_bbbb, Tensor<T>& ix2_5_baab, Tensor<T>& ix2_5_baba,
-                   Tensor<T>& ix2_6_2_a, Tensor<T>& ix2_6_2_b, 
-                   Tensor<T>& ix2_6_3_aaaa, Tensor<T>& ix2_6_3_abba, Tensor<T>& ix2_6_3_abab,
-                   Tensor<T>& ix2_6_3_bbbb, Tensor<T>& ix2_6_3_baab, Tensor<T>& ix2_6_3_baba,
-                   Tensor<T>& v2ijab_aaaa, Tensor<T>& v2ijab_abab, Tensor<T>& v2ijab_bbbb,
-                   std::vector<T>& p_evl_sorted_occ, std::vector<T>& p_evl_sorted_virt,
-                   long int total_orbitals, const TAMM_SIZE nocc,const TAMM_SIZE nvir,
-                   size_t& nptsi, const TiledIndexSpace& unit_tis,string files_prefix,
-                   string levelstr, int noa) {
+std::complex<T> gf_ip_norm(ExecutionContext& ec, Tensor<std::complex<T>>& v1_a,
+                           Tensor<std::complex<T>>& v2_aaa, Tensor<std::complex<T>>& v2_bab) {
+  auto vn = tamm::norms(ec, std::vector<Tensor<std::complex<T>>>{v1_a, v2_aaa, v2_bab});
+  return std::sqrt(vn[0]*vn[0] + 0.5*vn[1]*vn[1] + vn[2]*vn[2]);
+}
+
+// Orthogonalize the IP vector q against the Krylov vectors Q[0..k] by classical
+// Gram-Schmidt with one re-orthogonalization pass. The k+1 overlaps of a pass
+// come from one batched reduction. Returns the projection coefficients.
+template<typename T>
+std::vector<std::complex<T>> gf_ip_orthogonalize(ExecutionContext& ec, Scheduler& sch, size_t k,
+                   std::vector<Tensor<std::complex<T>>>& Q1_a,
+                   std::vector<Tensor<std::complex<T>>>& Q2_aaa,
+                   std::vector<Tensor<std::complex<T>>>& Q2_bab,
+                   Tensor<std::complex<T>>& q1_a, Tensor<std::complex<T>>& q2_aaa,
+                   Tensor<std::complex<T>>& q2_bab) {
+  std::vector<std::complex<T>> h(k+1, 0);
+  for(int igs=0; igs<2; igs++) {
+    std::vector<Tensor<std::complex<T>>> xs, ys;
+    for(size_t j=0; j<=k; j++) {
+      xs.insert(xs.end(), {Q1_a[j], Q2_aaa[j], Q2_bab[j]});
+      ys.insert(ys.end(), {q1_a, q2_aaa, q2_bab});
+    }
+    auto ovl = tamm::dots(ec, xs, ys);
+
+    for(size_t j=0; j<=k; j++) {
+      const std::complex<T> hj = ovl[3*j] + 0.5*ovl[3*j+1] + ovl[3*j+2];
+      sch
+        (q1_a()   -= hj * Q1_a[j]())
+        (q2_aaa() -= hj * Q2_aaa[j]())
+        (q2_bab() -= hj * Q2_bab[j]());
+      h[j] += hj;
+    }
+
+    #if defined(USE_TALSH) || defined(USE_DPCPP)
+      sch.execute(ExecutionHW::GPU);
+    #else
+      sch.execute();
+    #endif
+  }
+  return h;
+}
 
+// Diagonal preconditioner 1/(w - D - i*eta) for the current gf_omega, read from
+// disk if it was already computed for this level.
+template<typename T>
+void gfccsd_ip_a_precond(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Comm &subcomm,
+                   const TiledIndexSpace& MO, Tensor<std::complex<T>>& dtmp_a,
+                   Tensor<std::complex<T>>& dtmp_aaa, Tensor<std::complex<T>>& dtmp_bab,
+                   std::vector<T>& p_evl_sorted_occ, std::vector<T>& p_evl_sorted_virt,
+                   string files_prefix, string levelstr) {
 
   using ComplexTensor = Tensor<std::complex<T>>;
-  using VComplexTensor = std::vector<Tensor<std::complex<T>>>;
-  using CMatrix = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
   const TiledIndexSpace& O = MO("occ");
   const TiledIndexSpace& V = MO("virt");
-  const TiledIndexSpace& N = MO("all");
-  // auto [u1] = unit_tis.labels<1>("all");
-
-  const int otiles = O.num_tiles();
-  const int vtiles = V.num_tiles();
-  const int oatiles = MO("occ_alpha").num_tiles();
-  const int obtiles = MO("occ_beta").num_tiles();
-  const int vatiles = MO("virt_alpha").num_tiles();
-  const int vbtiles = MO("virt_beta").num_tiles();
-
-  o_alpha = {MO("occ"), range(oatiles)};
-  v_alpha = {MO("virt"), range(vatiles)};
-  o_beta = {MO("occ"), range(obtiles,otiles)};
-  v_beta = {MO("virt"), range(vbtiles,vtiles)};
 
   auto [p1_va] = v_alpha.labels<1>("all");
   auto [p1_vb] = v_beta.labels<1>("all");
   auto [h1_oa,h2_oa] = o_alpha.labels<2>("all");
-  auto [h1_ob,h2_ob] = o_beta.labels<2>("all");
-
-  std::cout.precision(15);
+  auto [h2_ob] = o_beta.labels<1>("all");
 
   Scheduler gsch{gec};
-  auto rank = gec.pg().rank();
 
   std::stringstream gfo;
   gfo << std::fixed << std::setprecision(2) << gf_omega;
 
-  // PRINT THE HEADER FOR GF-CCSD ITERATIONS
-  if(rank == 0) {
-    std::stringstream gfp;
-    gfp << std::endl << "GF-CCSD (w = " << gfo.str() << ") " << std::endl;
-    std::cout << gfp.str() << std::flush;
-  }
-
-  ComplexTensor dtmp_a{o_alpha};  
-  ComplexTensor dtmp_aaa{v_alpha,o_alpha,o_alpha};
-  ComplexTensor dtmp_bab{v_beta, o_alpha,o_beta};  
-  ComplexTensor::allocate(&gec,dtmp_a,dtmp_aaa,dtmp_bab);
-  
   // double au2ev = 27.2113961;
 
   std::string dtmp_a_file   = files_prefix+".W"+gfo.str()+".r_dtmp_a.l"+levelstr;
@@ -344,6 +349,79 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
     write_to_disk(dtmp_aaa,dtmp_aaa_file);
     write_to_disk(dtmp_bab,dtmp_bab_file);
   }
+}
+
+template<typename T>
+void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Comm &subcomm,
+                   const TiledIndexSpace& MO, Tensor<T>& t1_a,   Tensor<T>& t1_b, 
+                   Tensor<T>& t2_aaaa, Tensor<T>& t2_bbbb, Tensor<T>& t2_abab,
+                   Tensor<T>& f1, Tensor<T>& t2v2_o,
+                   Tensor<T>& lt12_o_a, Tensor<T>& lt12_o_b,
+                   Tensor<T>& ix1_1_1_a, Tensor<T>& ix1_1_1_b,
+                   Tensor<T>& ix2_1_aaaa, Tensor<T>& ix2_1_abab, Tensor<T>& ix2_1_bbbb, Tensor<T>& ix2_1_baba,
+                   Tensor<T>& ix2_2_a, Tensor<T>& ix2_2_b, 
+                   Tensor<T>& ix2_3_a, Tensor<T>& ix2_3_b, 
+                   Tensor<T>& ix2_4_aaaa, Tensor<T>& ix2_4_abab, Tensor<T>& ix2_4_bbbb, 
+                   Tensor<T>& ix2_5_aaaa, Tensor<T>& ix2_5_abba, Tensor<T>& ix2_5_abab, 
+                   Tensor<T>& ix2_5_bbbb, Tensor<T>& ix2_5_baab, Tensor<T>& ix2_5_baba,
+                   Tensor<T>& ix2_6_2_a, Tensor<T>& ix2_6_2_b, 
+                   Tensor<T>& ix2_6_3_aaaa, Tensor<T>& ix2_6_3_abba, Tensor<T>& ix2_6_3_abab,
+                   Tensor<T>& ix2_6_3_bbbb, Tensor<T>& ix2_6_3_baab, Tensor<T>& ix2_6_3_baba,
+                   Tensor<T>& v2ijab_aaaa, Tensor<T>& v2ijab_abab, Tensor<T>& v2ijab_bbbb,
+                   std::vector<T>& p_evl_sorted_occ, std::vector<T>& p_evl_sorted_virt,
+                   long int total_orbitals, const TAMM_SIZE nocc,const TAMM_SIZE nvir,
+                   size_t& nptsi, const TiledIndexSpace& unit_tis,string files_prefix,
+                   string levelstr, int noa) {
+
+
+  using ComplexTensor = Tensor<std::complex<T>>;
+  using VComplexTensor = std::vector<Tensor<std::complex<T>>>;
+  using CMatrix = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  const TiledIndexSpace& O = MO("occ");
+  const TiledIndexSpace& V = MO("virt");
+  const TiledIndexSpace& N = MO("all");
+  // auto [u1] = unit_tis.labels<1>("all");
+
+  const int otiles = O.num_tiles();
+  const int vtiles = V.num_tiles();
+  const int oatiles = MO("occ_alpha").num_tiles();
+  const int obtiles = MO("occ_beta").num_tiles();
+  const int vatiles = MO("virt_alpha").num_tiles();
+  const int vbtiles = MO("virt_beta").num_tiles();
+
+  o_alpha = {MO("occ"), range(oatiles)};
+  v_alpha = {MO("virt"), range(vatiles)};
+  o_beta = {MO("occ"), range(obtiles,otiles)};
+  v_beta = {MO("virt"), range(vbtiles,vtiles)};
+
+  auto [p1_va] = v_alpha.labels<1>("all");
+  auto [p1_vb] = v_beta.labels<1>("all");
+  auto [h1_oa,h2_oa] = o_alpha.labels<2>("all");
+  auto [h1_ob,h2_ob] = o_beta.labels<2>("all");
+
+  std::cout.precision(15);
+
+  Scheduler gsch{gec};
+  auto rank = gec.pg().rank();
+
+  std::stringstream gfo;
+  gfo << std::fixed << std::setprecision(2) << gf_omega;
+
+  // PRINT THE HEADER FOR GF-CCSD ITERATIONS
+  if(rank == 0) {
+    std::stringstream gfp;
+    gfp << std::endl << "GF-CCSD (w = " << gfo.str() << ") " << std::endl;
+    std::cout << gfp.str() << std::flush;
+  }
+
+  ComplexTensor dtmp_a{o_alpha};  
+  ComplexTensor dtmp_aaa{v_alpha,o_alpha,o_alpha};
+  ComplexTensor dtmp_bab{v_beta, o_alpha,o_beta};  
+  ComplexTensor::allocate(&gec,dtmp_a,dtmp_aaa,dtmp_bab);
+  
+  gfccsd_ip_a_precond<T>(gec, sub_ec, subcomm, MO, dtmp_a, dtmp_aaa, dtmp_bab,
+                        p_evl_sorted_occ, p_evl_sorted_virt, files_prefix, levelstr);
 
   //------------------------
   auto nranks = gec.pg().size().value();
@@ -415,13 +493,17 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
     ProcGroup pg = ProcGroup::create_coll(gf_comm);
     ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
     Scheduler sch{ec};
+    sch.async(gf_async_scheduler);
   #else
     Scheduler& sch = gsch;
     ExecutionContext& ec = gec;    
   #endif
 
-  AtomicCounter* ac = new AtomicCounterGA(gec.pg(), 1);
+  // only the root of each process group fetches tasks
+  const int fetch_stride = (GF_PGROUPS && subranks > 1) ? subranks : nranks;
+  AtomicCounter* ac = new AtomicCounterChunked(gec.pg(), 1, rank.value() % fetch_stride == 0);
   ac->allocate(0);
+  ac->set_task_count(0, pi_tbp.size());
   int64_t taskcount = 0;
   int64_t next = -1; 
   int total_pi_pg = 0;
@@ -496,6 +578,32 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
                  dx1_a, dx2_aaa, dx2_bab,
                   x1_a,  x2_aaa,  x2_bab).execute();
 
+    // The sigma build is the same op list in every GMRES step: capture it once
+    // (its intermediates stay allocated) and rebind x to the Krylov vectors.
+    gfccsd_x1_a(sch, MO, Hx1_a, 
+                t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab, 
+                x1_a, x2_aaa, x2_bab, 
+                f1, ix2_2_a, ix1_1_1_a, ix1_1_1_b,
+                ix2_6_3_aaaa, ix2_6_3_abab,
+                unit_tis,false);
+
+    gfccsd_x2_a(sch, MO, Hx2_aaa, Hx2_bab, 
+                t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab, 
+                x1_a, x2_aaa, x2_bab, 
+                f1, ix2_1_aaaa, ix2_1_abab,
+                ix2_2_a, ix2_2_b,
+                ix2_3_a, ix2_3_b, 
+                ix2_4_aaaa, ix2_4_abab,
+                ix2_5_aaaa, ix2_5_abba, ix2_5_abab, 
+                ix2_5_bbbb, ix2_5_baab,
+                ix2_6_2_a, ix2_6_2_b, 
+                ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
+                ix2_6_3_bbbb, ix2_6_3_baab,
+                v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
+                unit_tis,false);
+    ExecutionPlan sigma_plan = sch.compile();
+    sigma_plan.async(gf_async_scheduler);
+
     double gf_t_guess     = 0.0;
     double gf_t_x1_tot    = 0.0;
     double gf_t_x2_tot    = 0.0;
@@ -532,9 +640,6 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
     }
     
     // GMRES
-    ComplexTensor tmp{};
-    sch.allocate(tmp).execute();
-
     do {
       int64_t gmres_hist = ngmres;
 
@@ -549,27 +654,11 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
       VComplexTensor Q2_aaa;
       VComplexTensor Q2_bab;
 
-      gfccsd_x1_a(sch, MO, Hx1_a, 
-                  t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab, 
-                  x1_a, x2_aaa, x2_bab, 
-                  f1, ix2_2_a, ix1_1_1_a, ix1_1_1_b,
-                  ix2_6_3_aaaa, ix2_6_3_abab,
-                  unit_tis,false);
-          
-      gfccsd_x2_a(sch, MO, Hx2_aaa, Hx2_bab, 
-                  t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab, 
-                  x1_a, x2_aaa, x2_bab, 
-                  f1, ix2_1_aaaa, ix2_1_abab,
-                  ix2_2_a, ix2_2_b,
-                  ix2_3_a, ix2_3_b, 
-                  ix2_4_aaaa, ix2_4_abab,
-                  ix2_5_aaaa, ix2_5_abba, ix2_5_abab, 
-                  ix2_5_bbbb, ix2_5_baab,
-                  ix2_6_2_a, ix2_6_2_b, 
-                  ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
-                  ix2_6_3_bbbb, ix2_6_3_baab,
-                  v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
-                  unit_tis,false);
+      #if defined(USE_TALSH) || defined(USE_DPCPP)
+        sigma_plan.execute(ExecutionHW::GPU);
+      #else
+        sigma_plan.execute();
+      #endif
 
       sch 
         .allocate(r1_a,  r2_aaa,  r2_bab)
@@ -600,12 +689,7 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
         sch.execute();
       #endif
 
-      auto r1_a_norm   = norm(r1_a);
-      auto r2_aaa_norm = norm(r2_aaa);
-      auto r2_bab_norm = norm(r2_bab);
-
-      auto gf_residual 
-             = sqrt(r1_a_norm*r1_a_norm + 0.5*r2_aaa_norm*r2_aaa_norm + r2_bab_norm*r2_bab_norm);
+      auto gf_residual = gf_ip_norm(ec, r1_a, r2_aaa, r2_bab);
         
       auto gf_gmres = std::chrono::high_resolution_clock::now();
       double gftime =
@@ -650,27 +734,12 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
 
         auto gf_gmres_1 = std::chrono::high_resolution_clock::now();
 
-        gfccsd_x1_a(sch, MO, Hx1_a, 
-                    t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab, 
-                    Q1_a[k], Q2_aaa[k], Q2_bab[k], 
-                    f1, ix2_2_a, ix1_1_1_a, ix1_1_1_b,
-                    ix2_6_3_aaaa, ix2_6_3_abab,
-                    unit_tis,false);
-          
-        gfccsd_x2_a(sch, MO, Hx2_aaa, Hx2_bab, 
-                    t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab, 
-                    Q1_a[k], Q2_aaa[k], Q2_bab[k],
-                    f1, ix2_1_aaaa, ix2_1_abab,
-                    ix2_2_a, ix2_2_b,
-                    ix2_3_a, ix2_3_b, 
-                    ix2_4_aaaa, ix2_4_abab,
-                    ix2_5_aaaa, ix2_5_abba, ix2_5_abab, 
-                    ix2_5_bbbb, ix2_5_baab,
-                    ix2_6_2_a, ix2_6_2_b, 
-                    ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
-                    ix2_6_3_bbbb, ix2_6_3_baab,
-                    v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
-                    unit_tis,false);
+        sigma_plan.bind(x1_a, Q1_a[k]).bind(x2_aaa, Q2_aaa[k]).bind(x2_bab, Q2_bab[k]);
+        #if defined(USE_TALSH) || defined(USE_DPCPP)
+          sigma_plan.execute(ExecutionHW::GPU);
+        #else
+          sigma_plan.execute();
+        #endif
 
         sch 
           .allocate(q1_a,q2_aaa,q2_bab)
@@ -704,54 +773,11 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
           std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_2 - gf_gmres_1)).count();
         if(root_ppi==0 && debug) cout << "    k: " << k << ", T(gfcc contraction): " << std::fixed << std::setprecision(6) << gftime << endl;
 
-        // Arnoldi iteration or G-S orthogonalization
-        for(auto j=0; j<=k; j++) {
-          auto conj_a   = tamm::conj(Q1_a[j]);
-          auto conj_aaa = tamm::conj(Q2_aaa[j]);
-          auto conj_bab = tamm::conj(Q2_bab[j]);
-          sch
-            (tmp()  = 1.0 * conj_a(h1_oa) * q1_a(h1_oa))
-            (tmp() += 0.5 * conj_aaa(p1_va,h1_oa,h2_oa) * q2_aaa(p1_va,h1_oa,h2_oa))
-            (tmp() += 1.0 * conj_bab(p1_vb,h1_oa,h2_ob) * q2_bab(p1_vb,h1_oa,h2_ob))
-            (q1_a()   -= tmp() * Q1_a[j]())
-            (q2_aaa() -= tmp() * Q2_aaa[j]())
-            (q2_bab() -= tmp() * Q2_bab[j]());
-            // .deallocate(conj_a,conj_aaa,conj_bab);
-            // .execute();
-
-          #if defined(USE_TALSH) || defined(USE_DPCPP)
-            sch.execute(ExecutionHW::GPU);
-          #else
-            sch.execute();
-          #endif
-            
-          H(j,k) = get_scalar(tmp);
+        // Arnoldi iteration with CGS2 orthogonalization
+        auto hk = gf_ip_orthogonalize(ec, sch, k, Q1_a, Q2_aaa, Q2_bab, q1_a, q2_aaa, q2_bab);
+        for(auto j=0; j<=k; j++) H(j,k) = hk[j];
 
-          //re-orthogonalization
-          sch
-            (tmp()  = 1.0 * conj_a(h1_oa) * q1_a(h1_oa))
-            (tmp() += 0.5 * conj_aaa(p1_va,h1_oa,h2_oa) * q2_aaa(p1_va,h1_oa,h2_oa))
-            (tmp() += 1.0 * conj_bab(p1_vb,h1_oa,h2_ob) * q2_bab(p1_vb,h1_oa,h2_ob))
-            (q1_a()   -= tmp() * Q1_a[j]())
-            (q2_aaa() -= tmp() * Q2_aaa[j]())
-            (q2_bab() -= tmp() * Q2_bab[j]())
-            .deallocate(conj_a,conj_aaa,conj_bab);
-            // .execute();
-
-          #if defined(USE_TALSH) || defined(USE_DPCPP)
-            sch.execute(ExecutionHW::GPU);
-          #else
-            sch.execute();
-          #endif
-
-          H(j,k) += get_scalar(tmp);
-        } // j loop
-
-        r1_a_norm   = norm(q1_a);
-        r2_aaa_norm = norm(q2_aaa);
-        r2_bab_norm = norm(q2_bab);
-
-        H(k+1,k) = sqrt(r1_a_norm*r1_a_norm + 0.5*r2_aaa_norm*r2_aaa_norm + r2_bab_norm*r2_bab_norm);
+        H(k+1,k) = gf_ip_norm(ec, q1_a, q2_aaa, q2_bab);
 
         // if(std::abs(H(k+1,k))<1e-16) {
         //   gmres_hist = k+1;
@@ -782,35 +808,975 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
         blas::rotg(&scr1,&scr2,&cnk0_r,&sn(k,0));
         cn(k,0) = std::complex<T>(cnk0_r,cn(k,0).imag());
 
-        // if(root_ppi==0 && debug) {
-        //   cout << "cn/sn from rotg: " << cn(k,0) << "," << sn(k,0) << endl;
-        //   auto t = sqrt(std::conj(H(k,k))*H(k,k)+std::conj(H(k+1,k))*H(k+1,k));
-        //   auto cn_t = std::abs(H(k,k))/t;
-        //   auto sn_t = H(k,k)*std::conj(H(k+1,k))/(std::abs(H(k,k))*t);
-        //   cout << "cn/sn from self-computing: " << cn_t << "," << sn_t << endl;
-        // }
+        // if(root_ppi==0 && debug) {
+        //   cout << "cn/sn from rotg: " << cn(k,0) << "," << sn(k,0) << endl;
+        //   auto t = sqrt(std::conj(H(k,k))*H(k,k)+std::conj(H(k+1,k))*H(k+1,k));
+        //   auto cn_t = std::abs(H(k,k))/t;
+        //   auto sn_t = H(k,k)*std::conj(H(k+1,k))/(std::abs(H(k,k))*t);
+        //   cout << "cn/sn from self-computing: " << cn_t << "," << sn_t << endl;
+        // }
+
+        if(root_ppi==0 && debug) {
+          // cout << "cn/sn from self-computing: " << cn(k,0) << "," << sn(k,0) << endl;
+          cout << "    k: " << k << ", Checking if H(k+1,k) is zero: " << std::fixed << std::setprecision(6) << 
+          -std::conj(sn(k,0))*H(k,k)+cn(k,0)*H(k+1,k) << endl; //"," << H(k,k) << "," << H(k+1,k) << endl;
+        }        
+
+        H(k,k)   = cn(k,0) * H(k,k) + sn(k,0) * H(k+1,k);
+        H(k+1,k) = std::complex<double>(0,0);
+
+        b(k+1,0) = -std::conj(sn(k,0)) * b(k,0);
+        b(k,0)   =  cn(k,0) * b(k,0);
+
+        auto gf_gmres_4 = std::chrono::high_resolution_clock::now();
+        gftime =
+          std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_4 - gf_gmres_3)).count();
+        if(root_ppi==0 && debug) {
+          cout << "    k: " << k << ", T(Givens rotation): " << gftime << ", error: " << std::abs(b(k+1,0)) << endl;
+          cout << "    ----------" << endl;
+        }// if(root_ppi==0&&debug) cout<< "k: " << k << ", error: " << std::abs(b(k+1,0)) << endl;
+
+        //normalization
+        tamm::scale_ip(q1_a,scaling);
+        tamm::scale_ip(q2_aaa,scaling);
+        tamm::scale_ip(q2_bab,scaling);
+        Q1_a.push_back(q1_a);
+        Q2_aaa.push_back(q2_aaa);
+        Q2_bab.push_back(q2_bab);
+
+        if(std::abs(b(k+1,0)) < gf_threshold) {
+          gmres_hist = k+1;
+          break;
+        }
+      } // k loop
+
+      auto gf_gmres_5 = std::chrono::high_resolution_clock::now();
+      gftime =
+        std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_5 - gf_gmres)).count();
+      if(root_ppi==0 && debug) cout << "  pi: " << pi << ", k: " << k << ", gmres_hist: " << gmres_hist << ", #iter: " << gf_iter << ", T(micro_tot): " << gftime << endl;
+
+      //solve a least square problem in the subspace
+      CMatrix Hsub = H.block(0,0,gmres_hist,gmres_hist);
+      CMatrix bsub = b.block(0,0,gmres_hist,1);
+      CMatrix y = Hsub.householderQr().solve(bsub);
+
+      // if(rank==0 && debug) cout << "residual: " << (bsub-Hsub*y).norm() << endl;
+
+      for(auto i = 0; i < gmres_hist; i++) { 
+        sch
+          (x1_a(h1_oa)               += y(i,0) * Q1_a[i](h1_oa))
+          (x2_aaa(p1_va,h1_oa,h2_oa) += y(i,0) * Q2_aaa[i](p1_va,h1_oa,h2_oa))
+          (x2_bab(p1_vb,h1_oa,h2_ob) += y(i,0) * Q2_bab[i](p1_vb,h1_oa,h2_ob));
+      }
+      sch.execute();
+
+      write_to_disk(x1_a,  x1_a_inter_wpi_file);
+      write_to_disk(x2_aaa,x2_aaa_inter_wpi_file);
+      write_to_disk(x2_bab,x2_bab_inter_wpi_file);       
+
+      free_vec_tensors(Q1_a,Q2_aaa,Q2_bab);
+      Q1_a.clear();
+      Q2_aaa.clear();
+      Q2_bab.clear();
+
+      // auto gf_gmres_6 = std::chrono::high_resolution_clock::now();
+      // gftime =
+      //   std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_6 - gf_gmres_5)).count();
+      // if(root_ppi==0 && debug) cout << "  #iter " << gf_iter << ", T(least_square+X_updat+misc.): " << gftime << endl;
+                
+    }while(true);
+
+    if(gf_conv) {
+      std::string x1_a_conv_wpi_file   = files_prefix+".x1_a.w"  +gfo.str()+".oi"+std::to_string(pi);
+      std::string x2_aaa_conv_wpi_file = files_prefix+".x2_aaa.w"+gfo.str()+".oi"+std::to_string(pi);
+      std::string x2_bab_conv_wpi_file = files_prefix+".x2_bab.w"+gfo.str()+".oi"+std::to_string(pi);
+      write_to_disk(x1_a,  x1_a_conv_wpi_file);
+      write_to_disk(x2_aaa,x2_aaa_conv_wpi_file);
+      write_to_disk(x2_bab,x2_bab_conv_wpi_file);
+      fs::remove(x1_a_inter_wpi_file);
+      fs::remove(x2_aaa_inter_wpi_file);
+      fs::remove(x2_bab_inter_wpi_file);
+    }
+    
+    if(!gf_conv && root_ppi==0) {
+      std::string error_string = gfo.str()+","+std::to_string(pi)+".";
+      tamm_terminate("ERROR: GF-CCSD does not converge for w,oi = "+error_string);
+    }      
+
+    auto gf_t2 = std::chrono::high_resolution_clock::now();
+    double gftime =
+      std::chrono::duration_cast<std::chrono::duration<double>>((gf_t2 - gf_t1)).count();
+    if(root_ppi == 0) {
+      std::string gf_stats;
+      gf_stats = gfacc_str("R-GF-CCSD Time for w,oi (", gfo.str(), ",", std::to_string(pi), ") = ", 
+                 std::to_string(gftime), " secs, #iter = ", std::to_string(gf_iter),
+                 ", using PG ", std::to_string(pg_id));
+      
+      if(debug){
+        gf_stats += gfacc_str("|----------initial guess  : ",std::to_string(gf_t_guess  ));
+        gf_stats += gfacc_str("|----------x1 contraction : ",std::to_string(gf_t_x1_tot ));
+        gf_stats += gfacc_str("|----------x2 contraction : ",std::to_string(gf_t_x2_tot ));
+        gf_stats += gfacc_str("|----------computing res. : ",std::to_string(gf_t_res_tot));
+        gf_stats += gfacc_str("           |----------misc. contr. : ",std::to_string(gf_t_res_tot_1));
+        gf_stats += gfacc_str("           |----------compt. norm  : ",std::to_string(gf_t_res_tot_2));
+        gf_stats += gfacc_str("|----------updating x1/x2 : ",std::to_string(gf_t_upd_tot));
+        gf_stats += gfacc_str("|----------diis update    : ",std::to_string(gf_t_dis_tot));
+      }
+      std::cout << std::fixed << std::setprecision(6) << gf_stats << std::flush;
+    }      
+
+    sch.deallocate(Hx1_a, Hx2_aaa, Hx2_bab,
+                   dx1_a, dx2_aaa, dx2_bab, Minv_a,
+                    x1_a,  x2_aaa,  x2_bab, B1_a).execute();
+
+    if(root_ppi == 0) next = ac->fetch_add(0, 1);
+    ec.pg().broadcast(&next,0);
+
+   }
+    // #if GF_PGROUPS
+    // }
+    // #endif
+   if(root_ppi == 0) taskcount++;
+   ec.pg().broadcast(&taskcount,0);
+   //ec.pg().barrier();
+  } //end all remaining pi 
+
+  auto cc_t2 = std::chrono::high_resolution_clock::now();
+  double time =
+    std::chrono::duration_cast<std::chrono::duration<double>>((cc_t2 - cc_t1)).count();
+
+  if(root_ppi==0) {
+    cout << "Total orbitals executed by process group " << pg_id << " = " << total_pi_pg << endl;
+    cout << "  --> Total R-GF-CCSD Time = " << time << " secs" << endl;
+  }
+
+  #if GF_PGROUPS
+    ec.flush_and_sync();
+    //MemoryManagerGA::destroy_coll(mgr);    
+    pg.destroy_coll();
+  #endif
+  ac->deallocate();
+  delete ac;
+  gec.pg().barrier();
+
+  cc_t2 = std::chrono::high_resolution_clock::now();
+  time =
+    std::chrono::duration_cast<std::chrono::duration<double>>((cc_t2 - cc_t1)).count();
+  if(rank == 0) {
+    std::cout << "Total R-GF-CCSD Time (w = " << gfo.str() << ") = " << time << " secs" << std::endl;
+    std::cout << std::string(55, '-') << std::endl;
+  }
+
+  gsch.deallocate(dtmp_a,dtmp_aaa,dtmp_bab).execute();
+  MPI_Comm_free(&gf_comm);
+}
+
+// Batched GMRES at gf_omega: up to gf_block_size orbitals are solved together and
+// carried as the trailing (has_tis) index of gfccsd_x1_a/gfccsd_x2_a, so each sigma
+// contraction is GEMM-shaped over the batch and reads the ix2_*/v2ijab_* intermediates
+// once per batch. Every column keeps its own Arnoldi recurrence; the per-column
+// coefficients are Hadamard products over the batch index, and the Krylov basis is
+// stacked so that the coefficients of all columns and Krylov vectors are exchanged
+// as one small matrix per Gram-Schmidt pass. Columns that do not converge are
+// written as intermediate guesses for gfccsd_driver_ip_a; columns that have an
+// intermediate guess from an earlier run start from it.
+template<typename T>
+void gfccsd_driver_ip_a_block(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Comm &subcomm,
+                   const TiledIndexSpace& MO, Tensor<T>& t1_a,   Tensor<T>& t1_b,
+                   Tensor<T>& t2_aaaa, Tensor<T>& t2_bbbb, Tensor<T>& t2_abab,
+                   Tensor<T>& f1, Tensor<T>& t2v2_o,
+                   Tensor<T>& ix1_1_1_a, Tensor<T>& ix1_1_1_b,
+                   Tensor<T>& ix2_1_aaaa, Tensor<T>& ix2_1_abab,
+                   Tensor<T>& ix2_2_a, Tensor<T>& ix2_2_b,
+                   Tensor<T>& ix2_3_a, Tensor<T>& ix2_3_b,
+                   Tensor<T>& ix2_4_aaaa, Tensor<T>& ix2_4_abab,
+                   Tensor<T>& ix2_5_aaaa, Tensor<T>& ix2_5_abba, Tensor<T>& ix2_5_abab,
+                   Tensor<T>& ix2_5_bbbb, Tensor<T>& ix2_5_baab,
+                   Tensor<T>& ix2_6_2_a, Tensor<T>& ix2_6_2_b,
+                   Tensor<T>& ix2_6_3_aaaa, Tensor<T>& ix2_6_3_abba, Tensor<T>& ix2_6_3_abab,
+                   Tensor<T>& ix2_6_3_bbbb, Tensor<T>& ix2_6_3_baab,
+                   Tensor<T>& v2ijab_aaaa, Tensor<T>& v2ijab_abab, Tensor<T>& v2ijab_bbbb,
+                   std::vector<T>& p_evl_sorted_occ, std::vector<T>& p_evl_sorted_virt,
+                   const TAMM_SIZE nocc, string files_prefix, string levelstr, int noa) {
+
+  using ComplexTensor = Tensor<std::complex<T>>;
+  using VComplexTensor = std::vector<Tensor<std::complex<T>>>;
+  using CMatrix = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using RMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using CRowVec = Eigen::Matrix<std::complex<T>, 1, Eigen::Dynamic>;
+
+  const int otiles = MO("occ").num_tiles();
+  const int vtiles = MO("virt").num_tiles();
+  const int oatiles = MO("occ_alpha").num_tiles();
+  const int obtiles = MO("occ_beta").num_tiles();
+  const int vatiles = MO("virt_alpha").num_tiles();
+  const int vbtiles = MO("virt_beta").num_tiles();
+
+  o_alpha = {MO("occ"), range(oatiles)};
+  v_alpha = {MO("virt"), range(vatiles)};
+  o_beta = {MO("occ"), range(obtiles,otiles)};
+  v_beta = {MO("virt"), range(vbtiles,vtiles)};
+
+  // plain labels (not structured bindings) so they can be captured by the lambdas below
+  TiledIndexLabel p1_va, p1_vb, h1_oa, h2_oa, h1_ob;
+  std::tie(p1_va)       = v_alpha.labels<1>("all");
+  std::tie(p1_vb)       = v_beta.labels<1>("all");
+  std::tie(h1_oa,h2_oa) = o_alpha.labels<2>("all");
+  std::tie(h1_ob)       = o_beta.labels<1>("all");
+
+  auto rank = gec.pg().rank();
+  const std::complex<T> zw = std::complex<T>(gf_omega,-1.0*gf_eta);
+
+  std::stringstream gfo;
+  gfo << std::fixed << std::setprecision(2) << gf_omega;
+
+  auto x_file = [&](const std::string& xname, size_t pi, bool conv) {
+    const std::string inter = conv ? "" : ".inter";
+    return files_prefix+"."+xname+inter+".w"+gfo.str()+".oi"+std::to_string(pi);
+  };
+
+  std::vector<size_t> pi_tbp;
+  for (size_t pi=0; pi < (size_t)noa; pi++) {
+    if(fs::exists(x_file("x1_a",pi,true)) && fs::exists(x_file("x2_aaa",pi,true))
+       && fs::exists(x_file("x2_bab",pi,true))) continue;
+    pi_tbp.push_back(pi);
+  }
+  if(pi_tbp.empty()) return;
+
+  const size_t nb       = std::min(pi_tbp.size(), gf_block_size);
+  const size_t nbatches = (pi_tbp.size() + nb - 1) / nb;
+
+  ComplexTensor dtmp_a{o_alpha};
+  ComplexTensor dtmp_aaa{v_alpha,o_alpha,o_alpha};
+  ComplexTensor dtmp_bab{v_beta, o_alpha,o_beta};
+  ComplexTensor::allocate(&gec,dtmp_a,dtmp_aaa,dtmp_bab);
+  gfccsd_ip_a_precond<T>(gec, sub_ec, subcomm, MO, dtmp_a, dtmp_aaa, dtmp_bab,
+                         p_evl_sorted_occ, p_evl_sorted_virt, files_prefix, levelstr);
+
+  // The initial guess (Minv column) only depends on omega
+  CMatrix guessMI = gf_guess_ip_minv(gec, MO, nocc, gf_omega, gf_eta, p_evl_sorted_occ, t2v2_o);
+
+  const auto nranks = gec.pg().size().value();
+  int subranks = std::floor(nranks/nbatches);
+  if(subranks == 0 || subranks == 1) subranks = nranks;
+  if(gf_nprocs_poi > 0) subranks = gf_nprocs_poi;
+
+  if(rank==0) {
+    cout << endl << "GF-CCSD (w = " << gfo.str() << "), batched GMRES: " << pi_tbp.size()
+         << " orbitals in " << nbatches << " batches of up to " << nb << endl;
+    cout << "No of processes used to compute each batch = " << subranks << endl;
+  }
+
+  const int color = gec.pg().rank().value()/subranks;
+  MPI_Comm gf_comm;
+  MPI_Comm_split(gec.pg().comm(), color, gec.pg().rank().value(), &gf_comm);
+
+  ProcGroup pg = ProcGroup::create_coll(gf_comm);
+  ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+  Scheduler sch{ec};
+  sch.async(gf_async_scheduler);
+
+  // only the root of each process group fetches tasks
+  AtomicCounter* ac = new AtomicCounterChunked(gec.pg(), 1, gec.pg().rank().value() % subranks == 0);
+  ac->allocate(0);
+  ac->set_task_count(0, nbatches);
+  int64_t taskcount = 0;
+  int64_t next = -1;
+
+  int root_ppi = -1;
+  MPI_Comm_rank( ec.pg().comm(), &root_ppi );
+  if(root_ppi == 0) next = ac->fetch_add(0, 1);
+  ec.pg().broadcast(&next,0);
+
+  for (size_t ib=0; ib < nbatches; ib++) {
+    if (next == taskcount) {
+      auto gf_t1 = std::chrono::high_resolution_clock::now();
+
+      const std::vector<size_t> cols(pi_tbp.begin()+ib*nb,
+                                     pi_tbp.begin()+std::min((ib+1)*nb,pi_tbp.size()));
+      const size_t ncols = cols.size();
+
+      TiledIndexSpace btis{IndexSpace{range(ncols)}, static_cast<tamm::Tile>(ncols)};
+      TiledIndexLabel u1;
+      std::tie(u1) = btis.labels<1>("all");
+
+      Tensor<T>     B1_a{o_alpha,btis};
+      ComplexTensor x1_a{o_alpha,btis};
+      ComplexTensor x2_aaa{v_alpha,o_alpha,o_alpha,btis};
+      ComplexTensor x2_bab{v_beta, o_alpha,o_beta, btis};
+      ComplexTensor Hx1_a{o_alpha,btis};
+      ComplexTensor Hx2_aaa{v_alpha,o_alpha,o_alpha,btis};
+      ComplexTensor Hx2_bab{v_beta, o_alpha,o_beta, btis};
+      ComplexTensor dx1_a{o_alpha,btis};
+      ComplexTensor dx2_aaa{v_alpha,o_alpha,o_alpha,btis};
+      ComplexTensor dx2_bab{v_beta, o_alpha,o_beta, btis};
+      ComplexTensor cvec{btis};
+
+      sch.allocate(B1_a, x1_a, x2_aaa, x2_bab, Hx1_a, Hx2_aaa, Hx2_bab,
+                   dx1_a, dx2_aaa, dx2_bab, cvec)
+        (x2_aaa() = 0)
+        (x2_bab() = 0)
+        .execute();
+
+      ComplexTensor xc1_a{o_alpha};
+      ComplexTensor xc2_aaa{v_alpha,o_alpha,o_alpha};
+      ComplexTensor xc2_bab{v_beta, o_alpha,o_beta};
+      sch.allocate(xc1_a, xc2_aaa, xc2_bab).execute();
+
+      // columns with an intermediate solution from an earlier run continue from it
+      std::vector<bool> col_inter(ncols,false);
+      for(size_t b=0; b < ncols; b++)
+        col_inter[b] = fs::exists(x_file("x1_a",cols[b],false)) && fs::exists(x_file("x2_aaa",cols[b],false))
+                       && fs::exists(x_file("x2_bab",cols[b],false));
+      {
+        RMatrix b1e = RMatrix::Zero(noa,ncols);
+        CMatrix x1e = CMatrix::Zero(noa,ncols);
+        for(size_t b=0; b < ncols; b++) {
+          b1e(cols[b],b) = 1.0;
+          if(col_inter[b]) continue;
+          for(int i=0; i < noa; i++) x1e(i,b) = guessMI(i,cols[b]);
+        }
+        eigen_to_tamm_tensor(B1_a,b1e);
+        eigen_to_tamm_tensor(x1_a,x1e);
+        ec.pg().barrier();
+      }
+
+      // <v|w> for every column of the batch, weighted as in the non-batched solver
+      auto col_dot = [&](ComplexTensor& v1, ComplexTensor& v2aaa, ComplexTensor& v2bab,
+                         ComplexTensor& w1, ComplexTensor& w2aaa, ComplexTensor& w2bab) {
+        auto conj_a   = tamm::conj(v1);
+        auto conj_aaa = tamm::conj(v2aaa);
+        auto conj_bab = tamm::conj(v2bab);
+        sch
+          (cvec(u1)  = 1.0 * conj_a(h1_oa,u1) * w1(h1_oa,u1))
+          (cvec(u1) += 0.5 * conj_aaa(p1_va,h1_oa,h2_oa,u1) * w2aaa(p1_va,h1_oa,h2_oa,u1))
+          (cvec(u1) += 1.0 * conj_bab(p1_vb,h1_oa,h1_ob,u1) * w2bab(p1_vb,h1_oa,h1_ob,u1))
+          .deallocate(conj_a,conj_aaa,conj_bab)
+          .execute();
+        CRowVec cv = CRowVec::Zero(ncols);
+        tamm_to_eigen_tensor(cvec,cv);
+        return cv;
+      };
+
+      auto set_cvec = [&](const CRowVec& cv) {
+        CRowVec cvc = cv;
+        eigen_to_tamm_tensor(cvec,cvc);
+        ec.pg().barrier();
+      };
+
+      for(size_t b=0; b < ncols; b++) {
+        if(!col_inter[b]) continue;
+        read_from_disk(xc1_a,   x_file("x1_a",  cols[b],false));
+        read_from_disk(xc2_aaa, x_file("x2_aaa",cols[b],false));
+        read_from_disk(xc2_bab, x_file("x2_bab",cols[b],false));
+        CRowVec eb = CRowVec::Zero(ncols);
+        eb(b) = 1.0;
+        set_cvec(eb);
+        sch
+          (x1_a(h1_oa,u1)               += cvec(u1) * xc1_a(h1_oa))
+          (x2_aaa(p1_va,h1_oa,h2_oa,u1) += cvec(u1) * xc2_aaa(p1_va,h1_oa,h2_oa))
+          (x2_bab(p1_vb,h1_oa,h1_ob,u1) += cvec(u1) * xc2_bab(p1_vb,h1_oa,h1_ob))
+          .execute();
+      }
+
+      // applies (H + z) to v, followed by the right preconditioner, into r
+      auto apply_op = [&](ComplexTensor& v1, ComplexTensor& v2aaa, ComplexTensor& v2bab,
+                          ComplexTensor& r1, ComplexTensor& r2aaa, ComplexTensor& r2bab) {
+        gfccsd_x1_a(sch, MO, Hx1_a,
+                    t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab,
+                    v1, v2aaa, v2bab,
+                    f1, ix2_2_a, ix1_1_1_a, ix1_1_1_b,
+                    ix2_6_3_aaaa, ix2_6_3_abab,
+                    btis,true);
+
+        gfccsd_x2_a(sch, MO, Hx2_aaa, Hx2_bab,
+                    t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab,
+                    v1, v2aaa, v2bab,
+                    f1, ix2_1_aaaa, ix2_1_abab,
+                    ix2_2_a, ix2_2_b,
+                    ix2_3_a, ix2_3_b,
+                    ix2_4_aaaa, ix2_4_abab,
+                    ix2_5_aaaa, ix2_5_abba, ix2_5_abab,
+                    ix2_5_bbbb, ix2_5_baab,
+                    ix2_6_2_a, ix2_6_2_b,
+                    ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
+                    ix2_6_3_bbbb, ix2_6_3_baab,
+                    v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
+                    btis,true);
+
+        sch
+          (dx1_a()   = 1.0 * Hx1_a())
+          (dx2_aaa() = 1.0 * Hx2_aaa())
+          (dx2_bab() = 1.0 * Hx2_bab())
+          (dx1_a()   += zw * v1())
+          (dx2_aaa() += zw * v2aaa())
+          (dx2_bab() += zw * v2bab());
+
+        if (gf_preconditioning) {
+          sch
+            (r1(h1_oa,u1) = dtmp_a(h1_oa) * dx1_a(h1_oa,u1))
+            (r2aaa(p1_va,h1_oa,h2_oa,u1) = dtmp_aaa(p1_va,h1_oa,h2_oa) * dx2_aaa(p1_va,h1_oa,h2_oa,u1))
+            (r2bab(p1_vb,h1_oa,h1_ob,u1) = dtmp_bab(p1_vb,h1_oa,h1_ob) * dx2_bab(p1_vb,h1_oa,h1_ob,u1));
+        } else {
+          sch
+            (r1()    = 1.0 * dx1_a())
+            (r2aaa() = 1.0 * dx2_aaa())
+            (r2bab() = 1.0 * dx2_bab());
+        }
+
+        #if defined(USE_TALSH) || defined(USE_DPCPP)
+          sch.execute(ExecutionHW::GPU);
+        #else
+          sch.execute();
+        #endif
+      };
+
+      // The Krylov basis of the batch is kept stacked, V(.., k, u1) being the k-th
+      // vector of column u1, so each Gram-Schmidt pass and the solution update are
+      // single contractions over k. Their per-column coefficients go through cmat,
+      // gathered or scattered once per pass instead of once per Krylov vector.
+      const size_t gmres_hist = ngmres;
+      TiledIndexSpace ktis{IndexSpace{range(gmres_hist+1)}};
+      TiledIndexLabel kk;
+      std::tie(kk) = ktis.labels<1>("all");
+
+      ComplexTensor V1_a{o_alpha,ktis,btis};
+      ComplexTensor V2_aaa{v_alpha,o_alpha,o_alpha,ktis,btis};
+      ComplexTensor V2_bab{v_beta, o_alpha,o_beta, ktis,btis};
+      ComplexTensor w1_a{o_alpha,btis};
+      ComplexTensor w2_aaa{v_alpha,o_alpha,o_alpha,btis};
+      ComplexTensor w2_bab{v_beta, o_alpha,o_beta, btis};
+      ComplexTensor cmat{ktis,btis};
+      sch.allocate(V1_a, V2_aaa, V2_bab, w1_a, w2_aaa, w2_bab, cmat).execute();
+
+      auto get_cmat = [&]() {
+        CMatrix cm = CMatrix::Zero(gmres_hist+1, ncols);
+        tamm_to_eigen_tensor(cmat,cm);
+        return cm;
+      };
+
+      auto set_cmat = [&](CMatrix& cm) {
+        eigen_to_tamm_tensor(cmat,cm);
+        ec.pg().barrier();
+      };
+
+      // w(u1) = s(u1) * r(u1) becomes Krylov vector k of the batch
+      auto push_scaled = [&](size_t k, ComplexTensor& r1, ComplexTensor& r2aaa, ComplexTensor& r2bab,
+                             const CRowVec& scal) {
+        set_cvec(scal);
+        CMatrix ek = CMatrix::Zero(gmres_hist+1, ncols);
+        ek.row(k).setOnes();
+        set_cmat(ek);
+        sch
+          (w1_a(h1_oa,u1)               = cvec(u1) * r1(h1_oa,u1))
+          (w2_aaa(p1_va,h1_oa,h2_oa,u1) = cvec(u1) * r2aaa(p1_va,h1_oa,h2_oa,u1))
+          (w2_bab(p1_vb,h1_oa,h1_ob,u1) = cvec(u1) * r2bab(p1_vb,h1_oa,h1_ob,u1))
+          (V1_a(h1_oa,kk,u1)               += cmat(kk,u1) * w1_a(h1_oa,u1))
+          (V2_aaa(p1_va,h1_oa,h2_oa,kk,u1) += cmat(kk,u1) * w2_aaa(p1_va,h1_oa,h2_oa,u1))
+          (V2_bab(p1_vb,h1_oa,h1_ob,kk,u1) += cmat(kk,u1) * w2_bab(p1_vb,h1_oa,h1_ob,u1))
+          .execute();
+      };
+
+      // q(u1) -= sum_j h_j(u1) V_j(u1) over the first k+1 Krylov vectors, returning h
+      auto orthogonalize = [&](size_t k, ComplexTensor& q1, ComplexTensor& q2aaa, ComplexTensor& q2bab) {
+        TiledIndexSpace kjtis{ktis, range(0,k+1)};
+        TiledIndexLabel kj;
+        std::tie(kj) = kjtis.labels<1>("all");
+
+        // conj(q) V_j is the conjugate of the overlap, so only q is conjugated
+        auto conj_a   = tamm::conj(q1);
+        auto conj_aaa = tamm::conj(q2aaa);
+        auto conj_bab = tamm::conj(q2bab);
+        sch
+          (cmat() = 0)
+          (cmat(kj,u1)  = 1.0 * conj_a(h1_oa,u1) * V1_a(h1_oa,kj,u1))
+          (cmat(kj,u1) += 0.5 * conj_aaa(p1_va,h1_oa,h2_oa,u1) * V2_aaa(p1_va,h1_oa,h2_oa,kj,u1))
+          (cmat(kj,u1) += 1.0 * conj_bab(p1_vb,h1_oa,h1_ob,u1) * V2_bab(p1_vb,h1_oa,h1_ob,kj,u1))
+          .deallocate(conj_a,conj_aaa,conj_bab)
+          .execute();
+        CMatrix hk = get_cmat().conjugate();
+        set_cmat(hk);
+        sch
+          (q1(h1_oa,u1)                -= V1_a(h1_oa,kj,u1) * cmat(kj,u1))
+          (q2aaa(p1_va,h1_oa,h2_oa,u1) -= V2_aaa(p1_va,h1_oa,h2_oa,kj,u1) * cmat(kj,u1))
+          (q2bab(p1_vb,h1_oa,h1_ob,u1) -= V2_bab(p1_vb,h1_oa,h1_ob,kj,u1) * cmat(kj,u1))
+          .execute();
+        return hk;
+      };
+
+      ComplexTensor r1_a{o_alpha,btis};
+      ComplexTensor r2_aaa{v_alpha,o_alpha,o_alpha,btis};
+      ComplexTensor r2_bab{v_beta, o_alpha,o_beta, btis};
+      ComplexTensor q1_a{o_alpha,btis};
+      ComplexTensor q2_aaa{v_alpha,o_alpha,o_alpha,btis};
+      ComplexTensor q2_bab{v_beta, o_alpha,o_beta, btis};
+      sch.allocate(r1_a, r2_aaa, r2_bab, q1_a, q2_aaa, q2_bab).execute();
+
+      std::vector<T> col_res(ncols,0);
+      size_t gf_iter = 0;
+
+      do {
+        gf_iter++;
+
+        // residual r = M (b - (H + z) x), computed as -M((H + z) x) + M b
+        apply_op(x1_a, x2_aaa, x2_bab, r1_a, r2_aaa, r2_bab);
+        if (gf_preconditioning)
+          sch(r1_a(h1_oa,u1) += -1.0 * dtmp_a(h1_oa) * B1_a(h1_oa,u1));
+        else
+          sch(r1_a() += -1.0 * B1_a());
+        sch
+          (r1_a()   = -1.0 * r1_a())
+          (r2_aaa() = -1.0 * r2_aaa())
+          (r2_bab() = -1.0 * r2_bab())
+          .execute();
+
+        CRowVec rnorm2 = col_dot(r1_a, r2_aaa, r2_bab, r1_a, r2_aaa, r2_bab);
+        for(size_t b=0; b < ncols; b++) col_res[b] = std::sqrt(std::real(rnorm2(b)));
+
+        const bool all_conv = std::all_of(col_res.begin(), col_res.end(),
+                                          [](T r) { return r < gf_threshold; });
+        if(root_ppi==0 && debug) {
+          cout << "  #iter " << gf_iter << ", w (" << gfo.str() << "), residuals:";
+          for(size_t b=0; b < ncols; b++) cout << " " << cols[b] << ":" << col_res[b];
+          cout << endl;
+        }
+        if(all_conv || gf_iter > gf_maxiter) break;
+
+        std::vector<CMatrix> Hb(ncols, CMatrix::Zero(gmres_hist+1, gmres_hist));
+        std::vector<CMatrix> cn(ncols, CMatrix::Zero(gmres_hist, 1));
+        std::vector<CMatrix> sn(ncols, CMatrix::Zero(gmres_hist, 1));
+        std::vector<CMatrix> bv(ncols, CMatrix::Zero(gmres_hist+1, 1));
+        // subspace size of each column, -1 while the column is still iterating
+        std::vector<int64_t> col_hist(ncols, -1);
+
+        CRowVec scal(ncols);
+        for(size_t b=0; b < ncols; b++) {
+          bv[b](0,0) = col_res[b];
+          if(col_res[b] < gf_threshold) col_hist[b] = 0;
+          scal(b) = (col_hist[b] < 0) ? 1.0/col_res[b] : 0.0;
+        }
+
+        sch
+          (V1_a()   = 0)
+          (V2_aaa() = 0)
+          (V2_bab() = 0)
+          .execute();
+        push_scaled(0, r1_a, r2_aaa, r2_bab, scal);
+
+        size_t k = 0;
+        for(k=0; k < gmres_hist; k++) {
+          apply_op(w1_a, w2_aaa, w2_bab, q1_a, q2_aaa, q2_bab);
+
+          // Arnoldi with one step of re-orthogonalization, for all columns at once
+          for(int igs=0; igs<2; igs++) {
+            CMatrix hk = orthogonalize(k, q1_a, q2_aaa, q2_bab);
+            for(size_t b=0; b < ncols; b++)
+              for(size_t j=0; j<=k; j++) Hb[b](j,k) += hk(j,b);
+          }
+
+          CRowVec qnorm2 = col_dot(q1_a, q2_aaa, q2_bab, q1_a, q2_aaa, q2_bab);
+
+          // complex Givens rotations, as in gfccsd_driver_ip_a
+          for(size_t b=0; b < ncols; b++) {
+            scal(b) = 0.0;
+            if(col_hist[b] >= 0) continue;
+            auto& H = Hb[b];
+            H(k+1,k) = std::sqrt(std::real(qnorm2(b)));
+            const T hk1 = std::real(H(k+1,k));
+
+            for(size_t i=0; i<k; i++){
+              auto temp = cn[b](i,0) * H(i,k) + sn[b](i,0) * H(i+1,k);
+              H(i+1,k) = -std::conj(sn[b](i,0)) * H(i,k) + cn[b](i,0) * H(i+1,k);
+              H(i,k) = temp;
+            }
+
+            std::complex<T> scr1 = H(k,k);
+            std::complex<T> scr2 = H(k+1,k);
+            T cnk0_r = cn[b](k,0).real();
+            blas::rotg(&scr1,&scr2,&cnk0_r,&sn[b](k,0));
+            cn[b](k,0) = std::complex<T>(cnk0_r,cn[b](k,0).imag());
+
+            H(k,k)   = cn[b](k,0) * H(k,k) + sn[b](k,0) * H(k+1,k);
+            H(k+1,k) = std::complex<T>(0,0);
+
+            bv[b](k+1,0) = -std::conj(sn[b](k,0)) * bv[b](k,0);
+            bv[b](k,0)   =  cn[b](k,0) * bv[b](k,0);
+
+            if(std::abs(bv[b](k+1,0)) < gf_threshold || hk1 < 1e-14) col_hist[b] = k+1;
+            else scal(b) = 1.0/hk1;
+          }
+
+          const bool all_done = std::all_of(col_hist.begin(), col_hist.end(),
+                                            [](int64_t h) { return h >= 0; });
+          if(all_done || k+1 == gmres_hist) break;
+
+          push_scaled(k+1, q1_a, q2_aaa, q2_bab, scal);
+        } // k loop
+
+        // least-squares solve per column, x(u1) += sum_i y_i(u1) V_i(u1)
+        CMatrix Y = CMatrix::Zero(gmres_hist+1, ncols);
+        for(size_t b=0; b < ncols; b++) {
+          if(col_hist[b] < 0) col_hist[b] = k+1;
+          const size_t hb = col_hist[b];
+          if(hb == 0) continue;
+          CMatrix Hsub = Hb[b].block(0,0,hb,hb);
+          CMatrix bsub = bv[b].block(0,0,hb,1);
+          CMatrix y = Hsub.householderQr().solve(bsub);
+          for(size_t i=0; i < hb; i++) Y(i,b) = y(i,0);
+        }
+
+        set_cmat(Y);
+        sch
+          (x1_a(h1_oa,u1)               += V1_a(h1_oa,kk,u1) * cmat(kk,u1))
+          (x2_aaa(p1_va,h1_oa,h2_oa,u1) += V2_aaa(p1_va,h1_oa,h2_oa,kk,u1) * cmat(kk,u1))
+          (x2_bab(p1_vb,h1_oa,h1_ob,u1) += V2_bab(p1_vb,h1_oa,h1_ob,kk,u1) * cmat(kk,u1))
+          .execute();
+      } while(true);
+
+      sch.deallocate(V1_a, V2_aaa, V2_bab, w1_a, w2_aaa, w2_bab, cmat,
+                     q1_a, q2_aaa, q2_bab).execute();
+
+      // split the batch into the per-orbital files read by the MOR step
+
+      size_t nconv = 0;
+      for(size_t b=0; b < ncols; b++) {
+        CRowVec eb = CRowVec::Zero(ncols);
+        eb(b) = 1.0;
+        set_cvec(eb);
+        sch
+          (xc1_a(h1_oa)               = x1_a(h1_oa,u1) * cvec(u1))
+          (xc2_aaa(p1_va,h1_oa,h2_oa) = x2_aaa(p1_va,h1_oa,h2_oa,u1) * cvec(u1))
+          (xc2_bab(p1_vb,h1_oa,h1_ob) = x2_bab(p1_vb,h1_oa,h1_ob,u1) * cvec(u1))
+          .execute();
+
+        const bool conv = col_res[b] < gf_threshold;
+        write_to_disk(xc1_a,   x_file("x1_a",  cols[b],conv));
+        write_to_disk(xc2_aaa, x_file("x2_aaa",cols[b],conv));
+        write_to_disk(xc2_bab, x_file("x2_bab",cols[b],conv));
+        if(conv && col_inter[b]) {
+          fs::remove(x_file("x1_a",  cols[b],false));
+          fs::remove(x_file("x2_aaa",cols[b],false));
+          fs::remove(x_file("x2_bab",cols[b],false));
+        }
+        if(conv) nconv++;
+      }
+
+      sch.deallocate(xc1_a, xc2_aaa, xc2_bab, r1_a, r2_aaa, r2_bab,
+                     B1_a, x1_a, x2_aaa, x2_bab, Hx1_a, Hx2_aaa, Hx2_bab,
+                     dx1_a, dx2_aaa, dx2_bab, cvec).execute();
+
+      auto gf_t2 = std::chrono::high_resolution_clock::now();
+      double gftime =
+        std::chrono::duration_cast<std::chrono::duration<double>>((gf_t2 - gf_t1)).count();
+      if(root_ppi == 0) {
+        std::string gf_stats;
+        gf_stats = gfacc_str("R-GF-CCSD (batched) Time for w (", gfo.str(), "), ", std::to_string(ncols),
+                   " orbitals starting at oi ", std::to_string(cols[0]), " = ", std::to_string(gftime),
+                   " secs, #iter = ", std::to_string(gf_iter), ", converged = ", std::to_string(nconv),
+                   ", using PG ", std::to_string(color));
+        std::cout << std::fixed << std::setprecision(6) << gf_stats << std::flush;
+      }
+
+      if(root_ppi == 0) next = ac->fetch_add(0, 1);
+      ec.pg().broadcast(&next,0);
+    }
+    if(root_ppi == 0) taskcount++;
+    ec.pg().broadcast(&taskcount,0);
+  }
+
+  ec.flush_and_sync();
+  pg.destroy_coll();
+  ac->deallocate();
+  delete ac;
+  gec.pg().barrier();
+
+  Scheduler{gec}.deallocate(dtmp_a,dtmp_aaa,dtmp_bab).execute();
+  MPI_Comm_free(&gf_comm);
+}
+
+// Shifted GMRES: solves (H + z) x = b for all z = omega - i*eta in omega_list
+// from one Krylov space of H per orbital, since H V_k = V_{k+1} Hbar_k implies
+// (H + z) V_k = V_{k+1} (Hbar_k + z Ibar_k). The sigma products are shared by all
+// frequencies. The points of omega_grid are solved from the same Krylov spaces
+// along the way; they do not extend the Krylov spaces.
+// The Krylov space is unpreconditioned, as the preconditioner depends on omega;
+// the small least-squares residual only decides when to stop. A solution is
+// accepted with the criterion of gfccsd_driver_ip_a, the (preconditioned) norm of
+// b - (H + z) x, computed from V_{k+1} without another sigma product.
+// Converged (w,oi) solutions are written to the converged x files. The other
+// frequencies of omega_list are written to the intermediate x files that
+// gfccsd_driver_ip_a reads as its initial guess; (w,oi) pairs that already have a
+// converged or an intermediate x file are left as they are.
+template<typename T>
+void gfccsd_driver_ip_a_shifted(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Comm &subcomm,
+                   const TiledIndexSpace& MO,
+                   Tensor<T>& t1_a,   Tensor<T>& t1_b,
+                   Tensor<T>& t2_aaaa, Tensor<T>& t2_bbbb, Tensor<T>& t2_abab,
+                   Tensor<T>& f1,
+                   Tensor<T>& ix1_1_1_a, Tensor<T>& ix1_1_1_b,
+                   Tensor<T>& ix2_1_aaaa, Tensor<T>& ix2_1_abab,
+                   Tensor<T>& ix2_2_a, Tensor<T>& ix2_2_b,
+                   Tensor<T>& ix2_3_a, Tensor<T>& ix2_3_b,
+                   Tensor<T>& ix2_4_aaaa, Tensor<T>& ix2_4_abab,
+                   Tensor<T>& ix2_5_aaaa, Tensor<T>& ix2_5_abba, Tensor<T>& ix2_5_abab,
+                   Tensor<T>& ix2_5_bbbb, Tensor<T>& ix2_5_baab,
+                   Tensor<T>& ix2_6_2_a, Tensor<T>& ix2_6_2_b,
+                   Tensor<T>& ix2_6_3_aaaa, Tensor<T>& ix2_6_3_abba, Tensor<T>& ix2_6_3_abab,
+                   Tensor<T>& ix2_6_3_bbbb, Tensor<T>& ix2_6_3_baab,
+                   Tensor<T>& v2ijab_aaaa, Tensor<T>& v2ijab_abab, Tensor<T>& v2ijab_bbbb,
+                   std::vector<T>& p_evl_sorted_occ, std::vector<T>& p_evl_sorted_virt,
+                   const std::vector<T>& omega_list, const std::vector<T>& omega_grid,
+                   const TiledIndexSpace& unit_tis, string files_prefix, string levelstr,
+                   int noa) {
+
+  using ComplexTensor = Tensor<std::complex<T>>;
+  using VComplexTensor = std::vector<Tensor<std::complex<T>>>;
+  using CMatrix = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  const TiledIndexSpace& O = MO("occ");
+
+  const int otiles = O.num_tiles();
+  const int vtiles = MO("virt").num_tiles();
+  const int oatiles = MO("occ_alpha").num_tiles();
+  const int obtiles = MO("occ_beta").num_tiles();
+  const int vatiles = MO("virt_alpha").num_tiles();
+  const int vbtiles = MO("virt_beta").num_tiles();
+
+  o_alpha = {MO("occ"), range(oatiles)};
+  v_alpha = {MO("virt"), range(vatiles)};
+  o_beta = {MO("occ"), range(obtiles,otiles)};
+  v_beta = {MO("virt"), range(vbtiles,vtiles)};
+
+  auto [p1_va] = v_alpha.labels<1>("all");
+  auto [p1_vb] = v_beta.labels<1>("all");
+  auto [h1_oa,h2_oa] = o_alpha.labels<2>("all");
+  auto [h1_ob] = o_beta.labels<1>("all");
+
+  auto rank = gec.pg().rank();
+  const size_t nreq = omega_list.size();
+  if(nreq == 0) return;
+
+  //The requested frequencies come first, followed by the grid points not among them
+  std::vector<T> omegas = omega_list;
+  std::vector<std::string> gfo_list;
+  auto gfo_str = [](T omega) {
+    std::stringstream gfo;
+    gfo << std::fixed << std::setprecision(2) << omega;
+    return gfo.str();
+  };
+  for(auto w: omega_list) gfo_list.push_back(gfo_str(w));
+  for(auto w: omega_grid) {
+    if(std::find(gfo_list.begin(), gfo_list.end(), gfo_str(w)) != gfo_list.end()) continue;
+    omegas.push_back(w);
+    gfo_list.push_back(gfo_str(w));
+  }
+  const size_t nshifts = omegas.size();
+
+  auto x_file = [&](const std::string& xname, size_t s, size_t pi, bool conv) {
+    const std::string inter = conv ? "" : ".inter";
+    return files_prefix+"."+xname+inter+".w"+gfo_list[s]+".oi"+std::to_string(pi);
+  };
+  auto x_exists = [&](size_t s, size_t pi, bool conv) {
+    return fs::exists(x_file("x1_a",s,pi,conv)) && fs::exists(x_file("x2_aaa",s,pi,conv))
+           && fs::exists(x_file("x2_bab",s,pi,conv));
+  };
+
+  //A (w,oi) pair is solved here unless it is converged, or a previous run of
+  //gfccsd_driver_ip_a left an intermediate solution to continue from. An orbital
+  //is processed if at least one requested frequency is open.
+  std::vector<size_t> pi_tbp;
+  std::vector<std::vector<bool>> shift_open(noa, std::vector<bool>(nshifts,false));
+  for (size_t pi=0; pi < (size_t)noa; pi++) {
+    bool req_open = false;
+    for(size_t s=0; s < nshifts; s++) {
+      shift_open[pi][s] = !x_exists(s,pi,true) && (s >= nreq || !x_exists(s,pi,false));
+      if(s < nreq && shift_open[pi][s]) req_open = true;
+    }
+    if(req_open) pi_tbp.push_back(pi);
+  }
+  if(pi_tbp.empty()) return;
+
+  //The preconditioners of all frequencies are computed (or read) once on all ranks,
+  //written to the files that gfccsd_driver_ip_a reads, and read back per orbital.
+  auto dtmp_file = [&](const std::string& dname, size_t s) {
+    return files_prefix+".W"+gfo_list[s]+".r_dtmp_"+dname+".l"+levelstr;
+  };
+  if(gf_preconditioning) {
+    const double gf_omega_save = gf_omega;
+    for(size_t s=0; s < nshifts; s++) {
+      gf_omega = omegas[s];
+      ComplexTensor dtmp_a{o_alpha};
+      ComplexTensor dtmp_aaa{v_alpha,o_alpha,o_alpha};
+      ComplexTensor dtmp_bab{v_beta, o_alpha,o_beta};
+      ComplexTensor::allocate(&gec,dtmp_a,dtmp_aaa,dtmp_bab);
+      gfccsd_ip_a_precond<T>(gec, sub_ec, subcomm, MO, dtmp_a, dtmp_aaa, dtmp_bab,
+                             p_evl_sorted_occ, p_evl_sorted_virt, files_prefix, levelstr);
+      ComplexTensor::deallocate(dtmp_a,dtmp_aaa,dtmp_bab);
+    }
+    gf_omega = gf_omega_save;
+  }
+
+  const auto nranks = gec.pg().size().value();
+  int subranks = std::floor(nranks/pi_tbp.size());
+  if(subranks == 0 || subranks == 1) subranks = nranks;
+  if(gf_nprocs_poi > 0) subranks = gf_nprocs_poi;
+
+  if(rank==0) {
+    cout << endl << "Shifted GMRES: " << nreq << " frequencies (" << nshifts-nreq
+         << " more on the grid), " << pi_tbp.size()
+         << " orbitals, max. Krylov dimension = " << gf_shifted_maxdim << endl;
+    cout << "No of processes used to compute each orbital = " << subranks << endl;
+  }
+
+  const int color = gec.pg().rank().value()/subranks;
+  MPI_Comm gf_comm;
+  MPI_Comm_split(gec.pg().comm(), color, gec.pg().rank().value(), &gf_comm);
+
+  auto cc_t1 = std::chrono::high_resolution_clock::now();
+
+  ProcGroup pg = ProcGroup::create_coll(gf_comm);
+  ExecutionContext ec{pg, DistributionKind::nw, MemoryManagerKind::ga};
+  Scheduler sch{ec};
+  sch.async(gf_async_scheduler);
+
+  // only the root of each process group fetches tasks
+  AtomicCounter* ac = new AtomicCounterChunked(gec.pg(), 1, gec.pg().rank().value() % subranks == 0);
+  ac->allocate(0);
+  ac->set_task_count(0, pi_tbp.size());
+  int64_t taskcount = 0;
+  int64_t next = -1;
+
+  int root_ppi = -1;
+  MPI_Comm_rank( ec.pg().comm(), &root_ppi );
+  if(root_ppi == 0) next = ac->fetch_add(0, 1);
+  ec.pg().broadcast(&next,0);
+
+  for (size_t piv=0; piv < pi_tbp.size(); piv++) {
+    if (next == taskcount) {
+      const size_t pi = pi_tbp[piv];
+      auto gf_t1 = std::chrono::high_resolution_clock::now();
+
+      Tensor<T> B1{O};
+      Tensor<T> B1_a{o_alpha};
+      ComplexTensor Hx1_a{o_alpha};
+      ComplexTensor Hx2_aaa{v_alpha,o_alpha,o_alpha};
+      ComplexTensor Hx2_bab{v_beta, o_alpha,o_beta};
+
+      sch.allocate(B1,B1_a).execute();
+      sch(B1() = 0).execute();
+      update_tensor_val(B1, {pi}, T{1.0});
+      sch
+        (B1_a(h1_oa) = B1(h1_oa))
+        .deallocate(B1)
+        .allocate(Hx1_a, Hx2_aaa, Hx2_bab)
+        .execute();
+
+      VComplexTensor Q1_a;
+      VComplexTensor Q2_aaa;
+      VComplexTensor Q2_bab;
+
+      {
+        ComplexTensor r1_a{o_alpha};
+        ComplexTensor r2_aaa{v_alpha,o_alpha,o_alpha};
+        ComplexTensor r2_bab{v_beta, o_alpha,o_beta};
+        sch
+          .allocate(r1_a, r2_aaa, r2_bab)
+          (r1_a()   = 0)
+          (r2_aaa() = 0)
+          (r2_bab() = 0)
+          (r1_a()  += B1_a())
+          .execute();
+        Q1_a.push_back(r1_a);
+        Q2_aaa.push_back(r2_aaa);
+        Q2_bab.push_back(r2_bab);
+      }
+
+      // b is a unit vector, so the initial residual norm (x0 = 0) is 1
+      const T beta = 1.0;
+      const size_t maxdim = std::max<size_t>(gf_shifted_maxdim, 1);
+      CMatrix H = CMatrix::Zero(maxdim+1, maxdim);
+      std::vector<bool>    shift_lsconv(nshifts,false);
+      std::vector<CMatrix> shift_y(nshifts);
+      std::vector<CMatrix> shift_c(nshifts);
+
+      size_t kdim = 0;
+      for(size_t k=0; k < maxdim; k++) {
+        gfccsd_x1_a(sch, MO, Hx1_a,
+                    t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab,
+                    Q1_a[k], Q2_aaa[k], Q2_bab[k],
+                    f1, ix2_2_a, ix1_1_1_a, ix1_1_1_b,
+                    ix2_6_3_aaaa, ix2_6_3_abab,
+                    unit_tis,false);
+
+        gfccsd_x2_a(sch, MO, Hx2_aaa, Hx2_bab,
+                    t1_a, t1_b, t2_aaaa, t2_bbbb, t2_abab,
+                    Q1_a[k], Q2_aaa[k], Q2_bab[k],
+                    f1, ix2_1_aaaa, ix2_1_abab,
+                    ix2_2_a, ix2_2_b,
+                    ix2_3_a, ix2_3_b,
+                    ix2_4_aaaa, ix2_4_abab,
+                    ix2_5_aaaa, ix2_5_abba, ix2_5_abab,
+                    ix2_5_bbbb, ix2_5_baab,
+                    ix2_6_2_a, ix2_6_2_b,
+                    ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
+                    ix2_6_3_bbbb, ix2_6_3_baab,
+                    v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
+                    unit_tis,false);
 
-        if(root_ppi==0 && debug) {
-          // cout << "cn/sn from self-computing: " << cn(k,0) << "," << sn(k,0) << endl;
-          cout << "    k: " << k << ", Checking if H(k+1,k) is zero: " << std::fixed << std::setprecision(6) << 
-          -std::conj(sn(k,0))*H(k,k)+cn(k,0)*H(k+1,k) << endl; //"," << H(k,k) << "," << H(k+1,k) << endl;
-        }        
+        ComplexTensor q1_a{o_alpha};
+        ComplexTensor q2_aaa{v_alpha,o_alpha,o_alpha};
+        ComplexTensor q2_bab{v_beta, o_alpha,o_beta};
 
-        H(k,k)   = cn(k,0) * H(k,k) + sn(k,0) * H(k+1,k);
-        H(k+1,k) = std::complex<double>(0,0);
+        sch
+          .allocate(q1_a,q2_aaa,q2_bab)
+          (q1_a()   = 1.0 * Hx1_a())
+          (q2_aaa() = 1.0 * Hx2_aaa())
+          (q2_bab() = 1.0 * Hx2_bab());
 
-        b(k+1,0) = -std::conj(sn(k,0)) * b(k,0);
-        b(k,0)   =  cn(k,0) * b(k,0);
+        #if defined(USE_TALSH) || defined(USE_DPCPP)
+          sch.execute(ExecutionHW::GPU);
+        #else
+          sch.execute();
+        #endif
 
-        auto gf_gmres_4 = std::chrono::high_resolution_clock::now();
-        gftime =
-          std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_4 - gf_gmres_3)).count();
-        if(root_ppi==0 && debug) {
-          cout << "    k: " << k << ", T(Givens rotation): " << gftime << ", error: " << std::abs(b(k+1,0)) << endl;
-          cout << "    ----------" << endl;
-        }// if(root_ppi==0&&debug) cout<< "k: " << k << ", error: " << std::abs(b(k+1,0)) << endl;
+        // Arnoldi with one step of re-orthogonalization
+        auto hk = gf_ip_orthogonalize(ec, sch, k, Q1_a, Q2_aaa, Q2_bab, q1_a, q2_aaa, q2_bab);
+        for(size_t j=0; j<=k; j++) H(j,k) += hk[j];
+
+        H(k+1,k) = gf_ip_norm(ec, q1_a, q2_aaa, q2_bab);
+        kdim = k+1;
+
+        // (Hbar + z Ibar) y = beta e1 in the least-squares sense for each open shift;
+        // c = beta e1 - (Hbar + z Ibar) y are the coefficients of the residual in V_{k+1}
+        CMatrix bsub = CMatrix::Zero(kdim+1, 1);
+        bsub(0,0) = beta;
+        for(size_t s=0; s < nshifts; s++) {
+          if(!shift_open[pi][s]) continue;
+          CMatrix Hs = H.block(0,0,kdim+1,kdim);
+          const std::complex<T> zs = std::complex<T>(omegas[s],-1.0*gf_eta);
+          for(size_t i=0; i < kdim; i++) Hs(i,i) += zs;
+          shift_y[s]      = Hs.householderQr().solve(bsub);
+          shift_c[s]      = bsub - Hs*shift_y[s];
+          shift_lsconv[s] = shift_c[s].norm() < gf_threshold;
+        }
 
-        //normalization
+        const bool happy_bd = std::abs(H(k+1,k)) < 1e-14;
+        size_t nlsconv = 0, nlsopen = 0;
+        for(size_t s=0; s < nreq; s++) {
+          if(!shift_open[pi][s]) continue;
+          nlsopen++;
+          if(shift_lsconv[s]) nlsconv++;
+        }
+        if(root_ppi==0 && debug)
+          cout << "  oi: " << pi << ", k: " << k << ", #converged freq's: " << nlsconv << "/" << nlsopen << endl;
+
+        if(happy_bd) {
+          sch.deallocate(q1_a,q2_aaa,q2_bab).execute();
+          break;
+        }
+
+        // V_{k+1} is kept for the residuals
+        const std::complex<T> scaling = 1.0/H(k+1,k);
         tamm::scale_ip(q1_a,scaling);
         tamm::scale_ip(q2_aaa,scaling);
         tamm::scale_ip(q2_bab,scaling);
@@ -818,136 +1784,311 @@ void gfccsd_driver_ip_a(ExecutionContext& gec, ExecutionContext& sub_ec, MPI_Com
         Q2_aaa.push_back(q2_aaa);
         Q2_bab.push_back(q2_bab);
 
-        if(std::abs(b(k+1,0)) < gf_threshold) {
-          gmres_hist = k+1;
-          break;
-        }
+        if(nlsconv == nlsopen || kdim == maxdim) break;
       } // k loop
 
-      auto gf_gmres_5 = std::chrono::high_resolution_clock::now();
-      gftime =
-        std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_5 - gf_gmres)).count();
-      if(root_ppi==0 && debug) cout << "  pi: " << pi << ", k: " << k << ", gmres_hist: " << gmres_hist << ", #iter: " << gf_iter << ", T(micro_tot): " << gftime << endl;
-
-      //solve a least square problem in the subspace
-      CMatrix Hsub = H.block(0,0,gmres_hist,gmres_hist);
-      CMatrix bsub = b.block(0,0,gmres_hist,1);
-      CMatrix y = Hsub.householderQr().solve(bsub);
-
-      // if(rank==0 && debug) cout << "residual: " << (bsub-Hsub*y).norm() << endl;
+      ComplexTensor x1_a{o_alpha};
+      ComplexTensor x2_aaa{v_alpha,o_alpha,o_alpha};
+      ComplexTensor x2_bab{v_beta, o_alpha,o_beta};
+      ComplexTensor r1_a{o_alpha};
+      ComplexTensor r2_aaa{v_alpha,o_alpha,o_alpha};
+      ComplexTensor r2_bab{v_beta, o_alpha,o_beta};
+      ComplexTensor dtmp_a{o_alpha};
+      ComplexTensor dtmp_aaa{v_alpha,o_alpha,o_alpha};
+      ComplexTensor dtmp_bab{v_beta, o_alpha,o_beta};
+      sch.allocate(x1_a, x2_aaa, x2_bab, r1_a, r2_aaa, r2_bab).execute();
+      if(gf_preconditioning) sch.allocate(dtmp_a, dtmp_aaa, dtmp_bab).execute();
+
+      size_t nconv = 0, nopen = 0, ngrid = 0;
+      for(size_t s=0; s < nshifts; s++) {
+        if(!shift_open[pi][s]) continue;
+        if(s < nreq) nopen++;
+        // grid points are only checked if the least-squares residual is small enough
+        else if(!shift_lsconv[s]) continue;
 
-      for(auto i = 0; i < gmres_hist; i++) { 
         sch
-          (x1_a(h1_oa)               += y(i,0) * Q1_a[i](h1_oa))
-          (x2_aaa(p1_va,h1_oa,h2_oa) += y(i,0) * Q2_aaa[i](p1_va,h1_oa,h2_oa))
-          (x2_bab(p1_vb,h1_oa,h2_ob) += y(i,0) * Q2_bab[i](p1_vb,h1_oa,h2_ob));
-      }
-      sch.execute();
-
-      write_to_disk(x1_a,  x1_a_inter_wpi_file);
-      write_to_disk(x2_aaa,x2_aaa_inter_wpi_file);
-      write_to_disk(x2_bab,x2_bab_inter_wpi_file);       
-
-      free_vec_tensors(Q1_a,Q2_aaa,Q2_bab);
-      Q1_a.clear();
-      Q2_aaa.clear();
-      Q2_bab.clear();
-
-      // auto gf_gmres_6 = std::chrono::high_resolution_clock::now();
-      // gftime =
-      //   std::chrono::duration_cast<std::chrono::duration<double>>((gf_gmres_6 - gf_gmres_5)).count();
-      // if(root_ppi==0 && debug) cout << "  #iter " << gf_iter << ", T(least_square+X_updat+misc.): " << gftime << endl;
-                
-    }while(true);
-
-    //deallocate memory
-    sch.deallocate(tmp).execute();
-
-    if(gf_conv) {
-      std::string x1_a_conv_wpi_file   = files_prefix+".x1_a.w"  +gfo.str()+".oi"+std::to_string(pi);
-      std::string x2_aaa_conv_wpi_file = files_prefix+".x2_aaa.w"+gfo.str()+".oi"+std::to_string(pi);
-      std::string x2_bab_conv_wpi_file = files_prefix+".x2_bab.w"+gfo.str()+".oi"+std::to_string(pi);
-      write_to_disk(x1_a,  x1_a_conv_wpi_file);
-      write_to_disk(x2_aaa,x2_aaa_conv_wpi_file);
-      write_to_disk(x2_bab,x2_bab_conv_wpi_file);
-      fs::remove(x1_a_inter_wpi_file);
-      fs::remove(x2_aaa_inter_wpi_file);
-      fs::remove(x2_bab_inter_wpi_file);
-    }
-    
-    if(!gf_conv && root_ppi==0) {
-      std::string error_string = gfo.str()+","+std::to_string(pi)+".";
-      tamm_terminate("ERROR: GF-CCSD does not converge for w,oi = "+error_string);
-    }      
+          (x1_a()   = 0)
+          (x2_aaa() = 0)
+          (x2_bab() = 0)
+          (r1_a()   = 0)
+          (r2_aaa() = 0)
+          (r2_bab() = 0);
+        for(size_t i = 0; i < kdim; i++) {
+          sch
+            (x1_a()   += shift_y[s](i,0) * Q1_a[i]())
+            (x2_aaa() += shift_y[s](i,0) * Q2_aaa[i]())
+            (x2_bab() += shift_y[s](i,0) * Q2_bab[i]());
+        }
+        for(size_t i = 0; i < Q1_a.size(); i++) {
+          sch
+            (r1_a()   += shift_c[s](i,0) * Q1_a[i]())
+            (r2_aaa() += shift_c[s](i,0) * Q2_aaa[i]())
+            (r2_bab() += shift_c[s](i,0) * Q2_bab[i]());
+        }
+        sch.execute();
 
-    auto gf_t2 = std::chrono::high_resolution_clock::now();
-    double gftime =
-      std::chrono::duration_cast<std::chrono::duration<double>>((gf_t2 - gf_t1)).count();
-    if(root_ppi == 0) {
-      std::string gf_stats;
-      gf_stats = gfacc_str("R-GF-CCSD Time for w,oi (", gfo.str(), ",", std::to_string(pi), ") = ", 
-                 std::to_string(gftime), " secs, #iter = ", std::to_string(gf_iter),
-                 ", using PG ", std::to_string(pg_id));
-      
-      if(debug){
-        gf_stats += gfacc_str("|----------initial guess  : ",std::to_string(gf_t_guess  ));
-        gf_stats += gfacc_str("|----------x1 contraction : ",std::to_string(gf_t_x1_tot ));
-        gf_stats += gfacc_str("|----------x2 contraction : ",std::to_string(gf_t_x2_tot ));
-        gf_stats += gfacc_str("|----------computing res. : ",std::to_string(gf_t_res_tot));
-        gf_stats += gfacc_str("           |----------misc. contr. : ",std::to_string(gf_t_res_tot_1));
-        gf_stats += gfacc_str("           |----------compt. norm  : ",std::to_string(gf_t_res_tot_2));
-        gf_stats += gfacc_str("|----------updating x1/x2 : ",std::to_string(gf_t_upd_tot));
-        gf_stats += gfacc_str("|----------diis update    : ",std::to_string(gf_t_dis_tot));
+        if(gf_preconditioning) {
+          read_from_disk(dtmp_a,   dtmp_file("a",  s));
+          read_from_disk(dtmp_aaa, dtmp_file("aaa",s));
+          read_from_disk(dtmp_bab, dtmp_file("bab",s));
+          // the sigma tensors are free after the k loop
+          sch
+            (Hx1_a(h1_oa) = dtmp_a(h1_oa) * r1_a(h1_oa))
+            (Hx2_aaa(p1_va,h1_oa,h2_oa) = dtmp_aaa(p1_va,h1_oa,h2_oa) * r2_aaa(p1_va,h1_oa,h2_oa))
+            (Hx2_bab(p1_vb,h1_oa,h1_ob) = dtmp_bab(p1_vb,h1_oa,h1_ob) * r2_bab(p1_vb,h1_oa,h1_ob))
+            .execute();
+        }
+        const bool conv = gf_preconditioning ?
+                          std::abs(gf_ip_norm(ec, Hx1_a, Hx2_aaa, Hx2_bab)) < gf_threshold :
+                          std::abs(gf_ip_norm(ec, r1_a, r2_aaa, r2_bab)) < gf_threshold;
+
+        // Unconverged requested shifts are handed to the restarted GMRES in gfccsd_driver_ip_a
+        if(conv || s < nreq) {
+          write_to_disk(x1_a,   x_file("x1_a",  s,pi,conv));
+          write_to_disk(x2_aaa, x_file("x2_aaa",s,pi,conv));
+          write_to_disk(x2_bab, x_file("x2_bab",s,pi,conv));
+        }
+        if(conv && s < nreq) nconv++;
+        if(conv && s >= nreq) ngrid++;
       }
-      std::cout << std::fixed << std::setprecision(6) << gf_stats << std::flush;
-    }      
-
-    sch.deallocate(Hx1_a, Hx2_aaa, Hx2_bab,
-                   dx1_a, dx2_aaa, dx2_bab, Minv_a,
-                    x1_a,  x2_aaa,  x2_bab, B1_a).execute();
-
-    if(root_ppi == 0) next = ac->fetch_add(0, 1);
-    ec.pg().broadcast(&next,0);
 
-   }
-    // #if GF_PGROUPS
-    // }
-    // #endif
-   if(root_ppi == 0) taskcount++;
-   ec.pg().broadcast(&taskcount,0);
-   //ec.pg().barrier();
-  } //end all remaining pi 
+      free_vec_tensors(Q1_a, Q2_aaa, Q2_bab);
+      if(gf_preconditioning) sch.deallocate(dtmp_a, dtmp_aaa, dtmp_bab).execute();
+      sch.deallocate(x1_a, x2_aaa, x2_bab, r1_a, r2_aaa, r2_bab,
+                     Hx1_a, Hx2_aaa, Hx2_bab, B1_a).execute();
 
-  auto cc_t2 = std::chrono::high_resolution_clock::now();
-  double time =
-    std::chrono::duration_cast<std::chrono::duration<double>>((cc_t2 - cc_t1)).count();
+      auto gf_t2 = std::chrono::high_resolution_clock::now();
+      double gftime =
+        std::chrono::duration_cast<std::chrono::duration<double>>((gf_t2 - gf_t1)).count();
+      if(root_ppi == 0) {
+        std::string gf_stats;
+        gf_stats = gfacc_str("R-GF-CCSD (shifted) Time for oi ", std::to_string(pi), " = ",
+                   std::to_string(gftime), " secs, Krylov dim = ", std::to_string(kdim),
+                   ", converged freq's = ", std::to_string(nconv), "/", std::to_string(nopen),
+                   " (+", std::to_string(ngrid), " on the grid)",
+                   ", using PG ", std::to_string(color));
+        std::cout << std::fixed << std::setprecision(6) << gf_stats << std::flush;
+      }
 
-  if(root_ppi==0) {
-    cout << "Total orbitals executed by process group " << pg_id << " = " << total_pi_pg << endl;
-    cout << "  --> Total R-GF-CCSD Time = " << time << " secs" << endl;
+      if(root_ppi == 0) next = ac->fetch_add(0, 1);
+      ec.pg().broadcast(&next,0);
+    }
+    if(root_ppi == 0) taskcount++;
+    ec.pg().broadcast(&taskcount,0);
   }
 
-  #if GF_PGROUPS
-    ec.flush_and_sync();
-    //MemoryManagerGA::destroy_coll(mgr);    
-    pg.destroy_coll();
-  #endif
+  ec.flush_and_sync();
+  pg.destroy_coll();
   ac->deallocate();
   delete ac;
   gec.pg().barrier();
 
-  cc_t2 = std::chrono::high_resolution_clock::now();
-  time =
+  auto cc_t2 = std::chrono::high_resolution_clock::now();
+  double time =
     std::chrono::duration_cast<std::chrono::duration<double>>((cc_t2 - cc_t1)).count();
   if(rank == 0) {
-    std::cout << "Total R-GF-CCSD Time (w = " << gfo.str() << ") = " << time << " secs" << std::endl;
+    std::cout << "Total R-GF-CCSD (shifted) Time for " << nreq << " frequencies = " << time << " secs" << std::endl;
     std::cout << std::string(55, '-') << std::endl;
   }
 
-  gsch.deallocate(dtmp_a,dtmp_aaa,dtmp_bab).execute();
   MPI_Comm_free(&gf_comm);
 }
 
+// Blocked classical Gram-Schmidt (BCGS2) for the MOR basis. The panel vectors
+// [pstart,pend) of p1_a/p2_aaa/p2_bab are orthogonalized against the first nq
+// columns of q1_a/q2_aaa/q2_bab and then among themselves, twice. Each pass is one
+// projection GEMM, a panel Gram matrix and a small dense orthogonalization of the
+// Gram matrix. Vectors whose norm after projection is below tol_lindep are dropped
+// in the first pass. The remaining vectors are appended from column nq of q1/q2.
+// Returns the number of vectors appended.
+template<typename T>
+size_t gfccsd_gs_panel(ExecutionContext& ec, const TiledIndexSpace& otis, const tamm::Tile tilesize,
+                       Tensor<std::complex<T>>& q1_a, Tensor<std::complex<T>>& q2_aaa,
+                       Tensor<std::complex<T>>& q2_bab, const size_t nq,
+                       std::vector<Tensor<std::complex<T>>>& p1_a,
+                       std::vector<Tensor<std::complex<T>>>& p2_aaa,
+                       std::vector<Tensor<std::complex<T>>>& p2_bab,
+                       const size_t pstart, const size_t pend, const T tol_lindep) {
+
+  using ComplexTensor = Tensor<std::complex<T>>;
+  using CMatrix = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using CVector = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, 1>;
+
+  Scheduler sch{ec};
+  const auto rank = ec.pg().rank();
+  const size_t npan = pend - pstart;
+
+  TiledIndexLabel p1_va, p1_vb, h1_oa, h2_oa, h1_ob;
+  std::tie(p1_va)       = v_alpha.labels<1>("all");
+  std::tie(p1_vb)       = v_beta.labels<1>("all");
+  std::tie(h1_oa,h2_oa) = o_alpha.labels<2>("all");
+  std::tie(h1_ob)       = o_beta.labels<1>("all");
+
+  // current basis and its conjugate, retiled for the projection GEMMs
+  TiledIndexSpace qtis_opt;
+  ComplexTensor qc1_a, qc2_aaa, qc2_bab;
+  ComplexTensor qc1_a_conj, qc2_aaa_conj, qc2_bab_conj;
+  if(nq > 0) {
+    qtis_opt = {IndexSpace{range(0,nq)}, tilesize};
+    qc1_a   = {o_alpha,qtis_opt};
+    qc2_aaa = {v_alpha,o_alpha,o_alpha,qtis_opt};
+    qc2_bab = {v_beta, o_alpha,o_beta, qtis_opt};
+    sch.allocate(qc1_a,qc2_aaa,qc2_bab).execute();
+
+    // the first nq columns only
+    retile_tamm_tensor(q1_a,qc1_a);
+    retile_tamm_tensor(q2_aaa,qc2_aaa);
+    retile_tamm_tensor(q2_bab,qc2_bab);
+
+    qc1_a_conj   = tamm::conj(qc1_a);
+    qc2_aaa_conj = tamm::conj(qc2_aaa);
+    qc2_bab_conj = tamm::conj(qc2_bab);
+  }
+
+  // pack the panel, one column per tile, then retile
+  TiledIndexSpace ptis{IndexSpace{range(npan)}};
+  TiledIndexSpace ptis_opt{IndexSpace{range(npan)}, tilesize};
+  ComplexTensor a1_a{o_alpha,ptis_opt};
+  ComplexTensor a2_aaa{v_alpha,o_alpha,o_alpha,ptis_opt};
+  ComplexTensor a2_bab{v_beta, o_alpha,o_beta, ptis_opt};
+  {
+    ComplexTensor x1p_a{o_alpha,ptis};
+    ComplexTensor x2p_aaa{v_alpha,o_alpha,o_alpha,ptis};
+    ComplexTensor x2p_bab{v_beta, o_alpha,o_beta, ptis};
+    sch.allocate(x1p_a,x2p_aaa,x2p_bab,a1_a,a2_aaa,a2_bab);
+    for(size_t j=0; j < npan; j++) {
+      TiledIndexSpace tsj{ptis, range(j,j+1)};
+      auto [sj] = tsj.labels<1>("all");
+      sch
+        (x1p_a(h1_oa,sj) = p1_a[pstart+j](h1_oa))
+        (x2p_aaa(p1_va,h1_oa,h2_oa,sj) = p2_aaa[pstart+j](p1_va,h1_oa,h2_oa))
+        (x2p_bab(p1_vb,h1_oa,h1_ob,sj) = p2_bab[pstart+j](p1_vb,h1_oa,h1_ob));
+    }
+    sch.execute();
+
+    retile_tamm_tensor(x1p_a,a1_a);
+    retile_tamm_tensor(x2p_aaa,a2_aaa);
+    retile_tamm_tensor(x2p_bab,a2_bab);
+    sch.deallocate(x1p_a,x2p_aaa,x2p_bab).execute();
+  }
+
+  // Gram-Schmidt in the coefficient space of the panel: column k of S holds the
+  // k-th orthonormal vector as a combination of the panel vectors.
+  auto gram_coeffs = [](const CMatrix& G, const T tol) {
+    const Eigen::Index na = G.rows();
+    CMatrix S = CMatrix::Zero(na,na);
+    Eigen::Index nk = 0;
+    for(Eigen::Index j=0; j < na; j++) {
+      CVector s = CVector::Zero(na);
+      s(j) = 1.0;
+      for(int igs=0; igs < 2 && nk > 0; igs++) {
+        CVector proj = S.leftCols(nk).adjoint() * (G * s);
+        s -= S.leftCols(nk) * proj;
+      }
+      const T snorm = std::sqrt(std::max(T{0}, std::real(s.dot(G * s))));
+      if(snorm < tol || snorm == T{0}) continue;
+      S.col(nk++) = s / snorm;
+    }
+    return CMatrix(S.leftCols(nk));
+  };
+
+  TiledIndexSpace atis = ptis_opt;
+  for(int igs=0; igs < 2; igs++) {
+    TiledIndexLabel pc1, pc2;
+    std::tie(pc1,pc2) = atis.labels<2>("all");
+
+    if(nq > 0) {
+      auto [sc] = qtis_opt.labels<1>("all");
+      ComplexTensor cqa{qtis_opt,atis};
+      sch.allocate(cqa)
+        (cqa(sc,pc1)  = 1.0 * qc1_a_conj(h1_oa,sc) * a1_a(h1_oa,pc1))
+        (cqa(sc,pc1) += 0.5 * qc2_aaa_conj(p1_va,h1_oa,h2_oa,sc) * a2_aaa(p1_va,h1_oa,h2_oa,pc1))
+        (cqa(sc,pc1) += 1.0 * qc2_bab_conj(p1_vb,h1_oa,h1_ob,sc) * a2_bab(p1_vb,h1_oa,h1_ob,pc1))
+        (a1_a(h1_oa,pc1) += -1.0 * qc1_a(h1_oa,sc) * cqa(sc,pc1))
+        (a2_aaa(p1_va,h1_oa,h2_oa,pc1) += -1.0 * qc2_aaa(p1_va,h1_oa,h2_oa,sc) * cqa(sc,pc1))
+        (a2_bab(p1_vb,h1_oa,h1_ob,pc1) += -1.0 * qc2_bab(p1_vb,h1_oa,h1_ob,sc) * cqa(sc,pc1))
+        .deallocate(cqa);
+      #if defined(USE_TALSH) || defined(USE_DPCPP)
+        sch.execute(ExecutionHW::GPU);
+      #else
+        sch.execute();
+      #endif
+    }
+
+    ComplexTensor gram{atis,atis};
+    ComplexTensor a1_a_conj   = tamm::conj(a1_a);
+    ComplexTensor a2_aaa_conj = tamm::conj(a2_aaa);
+    ComplexTensor a2_bab_conj = tamm::conj(a2_bab);
+    sch.allocate(gram)
+      (gram(pc1,pc2)  = 1.0 * a1_a_conj(h1_oa,pc1) * a1_a(h1_oa,pc2))
+      (gram(pc1,pc2) += 0.5 * a2_aaa_conj(p1_va,h1_oa,h2_oa,pc1) * a2_aaa(p1_va,h1_oa,h2_oa,pc2))
+      (gram(pc1,pc2) += 1.0 * a2_bab_conj(p1_vb,h1_oa,h1_ob,pc1) * a2_bab(p1_vb,h1_oa,h1_ob,pc2))
+      .deallocate(a1_a_conj,a2_aaa_conj,a2_bab_conj)
+      .execute();
+
+    const auto na = atis.index_space().num_indices();
+    CMatrix G = CMatrix::Zero(na,na);
+    tamm_to_eigen_tensor(gram,G);
+    sch.deallocate(gram).execute();
+
+    // the second pass only re-orthogonalizes, it does not drop vectors
+    CMatrix S = gram_coeffs(G, igs == 0 ? tol_lindep : T{0});
+    const size_t nkeep = S.cols();
+    if(nkeep == 0) {
+      sch.deallocate(a1_a,a2_aaa,a2_bab).execute();
+      if(nq > 0) sch.deallocate(qc1_a,qc2_aaa,qc2_bab,qc1_a_conj,qc2_aaa_conj,qc2_bab_conj).execute();
+      return 0;
+    }
+
+    TiledIndexSpace ktis{IndexSpace{range(nkeep)}, tilesize};
+    auto [kc] = ktis.labels<1>("all");
+    ComplexTensor stens{atis,ktis};
+    ComplexTensor b1_a{o_alpha,ktis};
+    ComplexTensor b2_aaa{v_alpha,o_alpha,o_alpha,ktis};
+    ComplexTensor b2_bab{v_beta, o_alpha,o_beta, ktis};
+    sch.allocate(stens,b1_a,b2_aaa,b2_bab).execute();
+    if(rank == 0) eigen_to_tamm_tensor(stens,S);
+    ec.pg().barrier();
+
+    sch
+      (b1_a(h1_oa,kc) = a1_a(h1_oa,pc1) * stens(pc1,kc))
+      (b2_aaa(p1_va,h1_oa,h2_oa,kc) = a2_aaa(p1_va,h1_oa,h2_oa,pc1) * stens(pc1,kc))
+      (b2_bab(p1_vb,h1_oa,h1_ob,kc) = a2_bab(p1_vb,h1_oa,h1_ob,pc1) * stens(pc1,kc))
+      .deallocate(stens,a1_a,a2_aaa,a2_bab);
+    #if defined(USE_TALSH) || defined(USE_DPCPP)
+      sch.execute(ExecutionHW::GPU);
+    #else
+      sch.execute();
+    #endif
+
+    a1_a = b1_a; a2_aaa = b2_aaa; a2_bab = b2_bab;
+    atis = ktis;
+  }
+
+  if(nq > 0) sch.deallocate(qc1_a,qc2_aaa,qc2_bab,qc1_a_conj,qc2_aaa_conj,qc2_bab_conj).execute();
+
+  // append to the basis, through a copy with one column per tile
+  const size_t nkeep = atis.index_space().num_indices();
+  TiledIndexSpace tsn{otis, range(nq,nq+nkeep)};
+  auto [sn] = tsn.labels<1>("all");
+  ComplexTensor x1n_a{o_alpha,tsn};
+  ComplexTensor x2n_aaa{v_alpha,o_alpha,o_alpha,tsn};
+  ComplexTensor x2n_bab{v_beta, o_alpha,o_beta, tsn};
+  sch.allocate(x1n_a,x2n_aaa,x2n_bab).execute();
+  retile_tamm_tensor(a1_a,x1n_a);
+  retile_tamm_tensor(a2_aaa,x2n_aaa);
+  retile_tamm_tensor(a2_bab,x2n_bab);
+
+  sch
+    (q1_a(h1_oa,sn) = x1n_a(h1_oa,sn))
+    (q2_aaa(p1_va,h1_oa,h2_oa,sn) = x2n_aaa(p1_va,h1_oa,h2_oa,sn))
+    (q2_bab(p1_vb,h1_oa,h1_ob,sn) = x2n_bab(p1_vb,h1_oa,h1_ob,sn))
+    .deallocate(x1n_a,x2n_aaa,x2n_bab,a1_a,a2_aaa,a2_bab)
+    .execute();
+
+  return nkeep;
+}
+
 ////////////////////_Main-///////////////////////////
 void gfccsd_main_driver(std::string filename) {
 
@@ -1045,10 +2186,10 @@ void gfccsd_main_driver(std::string filename) {
     if(ccsd_restart) {
         read_from_disk(d_f1,f1file);
         if(fs::exists(t1file) && fs::exists(t2file)) {
-          read_from_disk(d_t1,t1file);
-          read_from_disk(d_t2,t2file);
+          read_from_disk(d_t1,t1file,true,{},false,0,ccsd_options.collective_io);
+          read_from_disk(d_t2,t2file,true,{},false,0,ccsd_options.collective_io);
         }
-        read_from_disk(cholVpr,v2file);
+        read_from_disk(cholVpr,v2file,true,{},false,0,ccsd_options.collective_io);
         ec.pg().barrier();
         p_evl_sorted = tamm::diagonal(d_f1);
     }
@@ -1058,7 +2199,7 @@ void gfccsd_main_driver(std::string filename) {
         if(!fs::exists(files_dir)) fs::create_directories(files_dir);
 
         write_to_disk(d_f1,f1file);
-        write_to_disk(cholVpr,v2file);
+        write_to_disk(cholVpr,v2file,true,false,0,ccsd_options.collective_io);
 
         if(rank==0){
           std::ofstream out(cholfile, std::ios::out);
@@ -1224,6 +2365,10 @@ void gfccsd_main_driver(std::string filename) {
   gf_threshold         = ccsd_options.gf_threshold;
   gf_lshift            = ccsd_options.gf_lshift;
   gf_preconditioning   = ccsd_options.gf_preconditioning;
+  gf_shifted_krylov    = ccsd_options.gf_shifted_krylov;
+  gf_async_scheduler   = ccsd_options.gf_async_scheduler;
+  gf_shifted_maxdim    = ccsd_options.gf_shifted_maxdim;
+  gf_block_size        = ccsd_options.gf_block_size;
   omega_min_ip         = ccsd_options.gf_omega_min_ip;
   omega_max_ip         = ccsd_options.gf_omega_max_ip;
   lomega_min_ip        = ccsd_options.gf_omega_min_ip_e;
@@ -1896,10 +3041,48 @@ void gfccsd_main_driver(std::string filename) {
         TiledIndexSpace unit_tis{otis,range(0,1)};
         // auto [u1] = unit_tis.labels<1>("all");
 
+        //On restart the shifted solver skips the (w,oi) pairs that are converged or
+        //have an intermediate solution, so it also runs when the level is restarted
+        if(gf_shifted_krylov) {
+          gfccsd_driver_ip_a_shifted<T>(ec, *sub_ec, subcomm, MO,
+                              d_t1_a, d_t1_b, d_t2_aaaa, d_t2_bbbb, d_t2_abab,
+                              d_f1, ix1_1_1_a, ix1_1_1_b,
+                              ix2_1_aaaa, ix2_1_abab,
+                              ix2_2_a, ix2_2_b,
+                              ix2_3_a, ix2_3_b,
+                              ix2_4_aaaa, ix2_4_abab,
+                              ix2_5_aaaa, ix2_5_abba, ix2_5_abab,
+                              ix2_5_bbbb, ix2_5_baab,
+                              ix2_6_2_a, ix2_6_2_b,
+                              ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
+                              ix2_6_3_bbbb, ix2_6_3_baab,
+                              v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
+                              p_evl_sorted_occ, p_evl_sorted_virt,
+                              omega_extra, omega_space_ip, unit_tis, files_prefix, levelstr, noa);
+        }
+
+        //With shifted or batched GMRES, this only solves the (w,oi) pairs that did not converge there
         for(auto x: omega_extra) {
           // omega_extra_finished.push_back(x);
           ndiis=ccsd_options.gf_ndiis;
           gf_omega = x;
+          if(gf_block_size > 1) {
+              gfccsd_driver_ip_a_block<T>(ec, *sub_ec, subcomm, MO,
+                              d_t1_a, d_t1_b, d_t2_aaaa, d_t2_bbbb, d_t2_abab,
+                              d_f1, t2v2_o, ix1_1_1_a, ix1_1_1_b,
+                              ix2_1_aaaa, ix2_1_abab,
+                              ix2_2_a, ix2_2_b,
+                              ix2_3_a, ix2_3_b,
+                              ix2_4_aaaa, ix2_4_abab,
+                              ix2_5_aaaa, ix2_5_abba, ix2_5_abab,
+                              ix2_5_bbbb, ix2_5_baab,
+                              ix2_6_2_a, ix2_6_2_b,
+                              ix2_6_3_aaaa, ix2_6_3_abba, ix2_6_3_abab,
+                              ix2_6_3_bbbb, ix2_6_3_baab,
+                              v2ijab_aaaa, v2ijab_abab, v2ijab_bbbb,
+                              p_evl_sorted_occ, p_evl_sorted_virt, nocc,
+                              files_prefix, levelstr, noa);
+          }
           if(!gf_restart){
               gfccsd_driver_ip_a<T>(ec, *sub_ec, subcomm, MO, 
                               d_t1_a, d_t1_b, d_t2_aaaa, d_t2_bbbb, d_t2_abab, 
@@ -1963,22 +3146,9 @@ void gfccsd_main_driver(std::string filename) {
             read_from_disk(q2_prev_aaa,pq2_aaa_file);
             read_from_disk(q2_prev_bab,pq2_bab_file);
 
-            { //retile q1 prev a,aaa,bab tensors
-              int q1_prev_a_ga   = tamm_to_ga(ec,q1_prev_a);
-              int q2_prev_aaa_ga = tamm_to_ga(ec,q2_prev_aaa);
-              int q2_prev_bab_ga = tamm_to_ga(ec,q2_prev_bab);
-              sch.deallocate(q1_prev_a, q2_prev_aaa, q2_prev_bab).execute();
-
-              q1_prev_a   = {o_alpha,otis_prev};
-              q2_prev_aaa = {v_alpha,o_alpha,o_alpha,otis_prev};
-              q2_prev_bab = {v_beta, o_alpha,o_beta, otis_prev};        
-              sch.allocate(q1_prev_a, q2_prev_aaa, q2_prev_bab).execute();
-
-              ga_to_tamm(ec,q1_prev_a,q1_prev_a_ga);
-              ga_to_tamm(ec,q2_prev_aaa,q2_prev_aaa_ga);
-              ga_to_tamm(ec,q2_prev_bab,q2_prev_bab_ga);
-              NGA_Destroy(q1_prev_a_ga); NGA_Destroy(q2_prev_aaa_ga); NGA_Destroy(q2_prev_bab_ga);    
-            }
+            retile_ip(q1_prev_a,  {o_alpha,otis_prev});
+            retile_ip(q2_prev_aaa,{v_alpha,o_alpha,o_alpha,otis_prev});
+            retile_ip(q2_prev_bab,{v_beta, o_alpha,o_beta, otis_prev});
 
   
             if(subcomm != MPI_COMM_NULL){
@@ -2009,10 +3179,8 @@ void gfccsd_main_driver(std::string filename) {
           std::vector<ComplexTensor> gs_q2_tmp_aaa; //{v_alpha,o_alpha,o_alpha};
           std::vector<ComplexTensor> gs_q2_tmp_bab; //{v_beta, o_alpha,o_beta};
         
-          //TODO: optimize Q1/Q2 computation
           //Gram-Schmidt orthogonalization
           double time_gs_orth = 0.0;
-          double time_gs_norm = 0.0;
   
           double q_norm_threshold = sys_data.options_map.scf_options.tol_lindep;
           if(rank==0 && debug) {
@@ -2069,287 +3237,115 @@ void gfccsd_main_driver(std::string filename) {
             }
 
             auto ivec_start=prev_qr_rank_orig;
+            TiledIndexSpace otis_gs_opt = {IndexSpace{range(qr_rank_orig)}, static_cast<tamm::Tile>(ccsd_options.tilesize)};
 
             //setup for restarting ivec loop as needed
             std::string gs_ivec_file  = files_prefix+".gs_ivec.l"+levelstr;
+            auto q1_gs_file   = files_prefix+".r_q1_a.gs_ivec.l"+levelstr;
+            auto q2aaa_gs_file = files_prefix+".r_q2_aaa.gs_ivec.l"+levelstr;
+            auto q2bab_gs_file = files_prefix+".r_q2_bab.gs_ivec.l"+levelstr;
             #if 1
             if(ccsd_options.gf_restart) {
               bool gsivec_exists = fs::exists(gs_ivec_file);
+              //the file holds "ivec lindep"; files written before the blocked GS only hold ivec,
+              //which does not tell where the accepted columns end, so the GS state is rebuilt
+              int gsivec_valid = 0;
               if(rank == 0 && gsivec_exists) {
                 decltype(qr_rank_orig) gs_istart = 0;
                 std::ifstream in(gs_ivec_file, std::ios::in);
-                int rstatus = 0;
-                if(in.is_open()) rstatus = 1;
-                if(rstatus == 1) in >> gs_istart;
-                ivec_start = gs_istart;
+                if(in.is_open() && (in >> gs_istart >> gs_cur_lindep)) {
+                  ivec_start   = gs_istart;
+                  gsivec_valid = 1;
+                }
+                else {
+                  std::cout << "WARNING: " << gs_ivec_file << " is in an old format or unreadable, "
+                            << "redoing Gram-Schmidt from ivec: " << prev_qr_rank_orig << std::endl;
+                  gs_cur_lindep = 0;
+                }
               }
-              if(gsivec_exists) {
+              if(gsivec_exists) ec.pg().broadcast(&gsivec_valid,0);
+              if(gsivec_exists && gsivec_valid) {
                 ec.pg().broadcast(&ivec_start,0);
-                auto q1_a_file    = files_prefix+".r_q1_a.gs_ivec.l"+levelstr;
-                auto q2_aaa_file  = files_prefix+".r_q2_aaa.gs_ivec.l"+levelstr;
-                auto q2_bab_file  = files_prefix+".r_q2_bab.gs_ivec.l"+levelstr;
-                auto q_exist = fs::exists(q1_a_file) && fs::exists(q2_aaa_file) && fs::exists(q2_bab_file);
+                ec.pg().broadcast(&gs_cur_lindep,0);
+                auto q_exist = fs::exists(q1_gs_file) && fs::exists(q2aaa_gs_file) && fs::exists(q2bab_gs_file);
                 if(q_exist) {
                   if(rank == 0) std::cout << "Restarting GS loop from ivec: " << ivec_start << std::endl;
-                  ComplexTensor i_q1_tamm_a   = {o_alpha,otis_opt};
-                  ComplexTensor i_q2_tamm_aaa = {v_alpha,o_alpha,o_alpha,otis_opt};
-                  ComplexTensor i_q2_tamm_bab = {v_beta, o_alpha,o_beta, otis_opt};
+                  ComplexTensor i_q1_tamm_a   = {o_alpha,otis_gs_opt};
+                  ComplexTensor i_q2_tamm_aaa = {v_alpha,o_alpha,o_alpha,otis_gs_opt};
+                  ComplexTensor i_q2_tamm_bab = {v_beta, o_alpha,o_beta, otis_gs_opt};
                   sch.allocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
                   read_from_disk_group<std::complex<T>>(
                     ec, std::vector{i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab},
-                    {q1_a_file, q2_aaa_file, q2_bab_file}, {}, gf_profile);
+                    {q1_gs_file, q2aaa_gs_file, q2bab_gs_file}, {}, gf_profile);
 
-                  int q1_tamm_a_ga   = tamm_to_ga(ec,i_q1_tamm_a);
-                  int q2_tamm_aaa_ga = tamm_to_ga(ec,i_q2_tamm_aaa);
-                  int q2_tamm_bab_ga = tamm_to_ga(ec,i_q2_tamm_bab);
+                  retile_tamm_tensor(i_q1_tamm_a,q1_tamm_a);
+                  retile_tamm_tensor(i_q2_tamm_aaa,q2_tamm_aaa);
+                  retile_tamm_tensor(i_q2_tamm_bab,q2_tamm_bab);
                   sch.deallocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
-
-                  ga_to_tamm(ec,q1_tamm_a,q1_tamm_a_ga);
-                  ga_to_tamm(ec,q2_tamm_aaa,q2_tamm_aaa_ga);
-                  ga_to_tamm(ec,q2_tamm_bab,q2_tamm_bab_ga);
-                  NGA_Destroy(q1_tamm_a_ga); NGA_Destroy(q2_tamm_aaa_ga); NGA_Destroy(q2_tamm_bab_ga);
+                }
+                else {
+                  ivec_start    = prev_qr_rank_orig;
+                  gs_cur_lindep = 0;
                 }
               }
             }
             #endif
 
-            for(auto ivec=ivec_start;ivec<qr_rank_orig;ivec++) {
-
-              if(gf_profile && rank == 0)
-                std::cout << " -- GS: ivec " << ivec;
+            //Blocked Gram-Schmidt, one panel per frequency (noa vectors).
+            //Accepted vectors are stored contiguously: column ivec-gs_prev_lindep-gs_cur_lindep.
+            for(auto ivec=ivec_start;ivec<qr_rank_orig;) {
+              const auto ivec_end = std::min(qr_rank_orig, (ivec/noa+1)*noa);
+              const size_t nq = ivec - gs_prev_lindep - gs_cur_lindep;
+              const bool gs_first = (ivec == ivec_start);
 
               auto cc_t0 = std::chrono::high_resolution_clock::now();
 
-              const auto gs_sind       = ivec%ngsvecs;
-              ComplexTensor q1_tmp_a   = gs_q1_tmp_a  [gs_sind];
-              ComplexTensor q2_tmp_aaa = gs_q2_tmp_aaa[gs_sind];
-              ComplexTensor q2_tmp_bab = gs_q2_tmp_bab[gs_sind];
-
-              //TODO: schedule all iterations before executing
-              if(ivec>0){
-                TiledIndexSpace tsc{otis, range(0,ivec-gs_prev_lindep)};
-                auto [sc] = tsc.labels<1>("all");
-                TiledIndexSpace tsc_opt = {IndexSpace{range(0,ivec-gs_prev_lindep)}, static_cast<tamm::Tile>(ccsd_options.tilesize)};
-                auto [sc_opt] = tsc_opt.labels<1>("all");
-
-                ComplexTensor oscalar{tsc_opt};
-                ComplexTensor x1c_a{o_alpha,tsc};
-                ComplexTensor x2c_aaa{v_alpha,o_alpha,o_alpha,tsc};
-                ComplexTensor x2c_bab{v_beta, o_alpha,o_beta, tsc};
-  
-                #if GF_GS_SG
-                if(subcomm != MPI_COMM_NULL){
-                  sub_sch.allocate
-                #else
-                  sch.allocate
-                #endif
-                    (x1c_a,x2c_aaa,x2c_bab)                        
-                    (x1c_a(h1_oa,sc) = q1_tamm_a(h1_oa,sc))
-                    (x2c_aaa(p1_va,h1_oa,h2_oa,sc) = q2_tamm_aaa(p1_va,h1_oa,h2_oa,sc))
-                    (x2c_bab(p1_vb,h1_oa,h2_ob,sc) = q2_tamm_bab(p1_vb,h1_oa,h2_ob,sc))
-                    .execute();      
-  
-                { //retile x1c a,aaa,bab tensors
-                  int x1c_a_ga   = tamm_to_ga(ec,x1c_a);
-                  int x2c_aaa_ga = tamm_to_ga(ec,x2c_aaa);
-                  int x2c_bab_ga = tamm_to_ga(ec,x2c_bab);
-                  sch.deallocate(x1c_a,x2c_aaa,x2c_bab).execute();
-
-                  x1c_a   = {o_alpha,tsc_opt};
-                  x2c_aaa = {v_alpha,o_alpha,o_alpha,tsc_opt};
-                  x2c_bab = {v_beta, o_alpha,o_beta, tsc_opt};
-                  sch.allocate(x1c_a,x2c_aaa,x2c_bab).execute();
-
-                  ga_to_tamm(ec,x1c_a,x1c_a_ga);
-                  ga_to_tamm(ec,x2c_aaa,x2c_aaa_ga);
-                  ga_to_tamm(ec,x2c_bab,x2c_bab_ga);
-                  NGA_Destroy(x1c_a_ga); NGA_Destroy(x2c_aaa_ga); NGA_Destroy(x2c_bab_ga);
-                }
-
-                ComplexTensor x1c_a_conj   = tamm::conj(x1c_a);
-                ComplexTensor x2c_aaa_conj = tamm::conj(x2c_aaa);
-                ComplexTensor x2c_bab_conj = tamm::conj(x2c_bab); 
-  
-                #if GF_GS_SG
-                  sub_sch.allocate
-                #else
-                  sch.allocate
-                #endif
-
-                    // 1st GS
-                    (oscalar)
-                    (oscalar(sc_opt)  = -1.0 * q1_tmp_a(h1_oa) * x1c_a_conj(h1_oa,sc_opt))
-                    (oscalar(sc_opt) += -0.5 * q2_tmp_aaa(p1_va,h1_oa,h2_oa) * x2c_aaa_conj(p1_va,h1_oa,h2_oa,sc_opt))
-                    (oscalar(sc_opt) += -1.0 * q2_tmp_bab(p1_vb,h1_oa,h2_ob) * x2c_bab_conj(p1_vb,h1_oa,h2_ob,sc_opt))
-
-                    (q1_tmp_a(h1_oa) += oscalar(sc_opt) * x1c_a(h1_oa,sc_opt))
-                    (q2_tmp_aaa(p1_va,h1_oa,h2_oa) += oscalar(sc_opt) * x2c_aaa(p1_va,h1_oa,h2_oa,sc_opt))
-                    (q2_tmp_bab(p1_vb,h1_oa,h2_ob) += oscalar(sc_opt) * x2c_bab(p1_vb,h1_oa,h2_ob,sc_opt))
-
-                    // 2nd GS
-                    // (oscalar(sc_opt)  = -1.0 * q1_tmp_a(h1_oa) * x1c_a_conj(h1_oa,sc_opt))
-                    // (oscalar(sc_opt) += -0.5 * q2_tmp_aaa(p1_va,h1_oa,h2_oa) * x2c_aaa_conj(p1_va,h1_oa,h2_oa,sc_opt))
-                    // (oscalar(sc_opt) += -1.0 * q2_tmp_bab(p1_vb,h1_oa,h2_ob) * x2c_bab_conj(p1_vb,h1_oa,h2_ob,sc_opt))
-  
-                    // (q1_tmp_a(h1_oa) += oscalar(sc_opt) * x1c_a(h1_oa,sc_opt))
-                    // (q2_tmp_aaa(p1_va,h1_oa,h2_oa) += oscalar(sc_opt) * x2c_aaa(p1_va,h1_oa,h2_oa,sc_opt))
-                    // (q2_tmp_bab(p1_vb,h1_oa,h2_ob) += oscalar(sc_opt) * x2c_bab(p1_vb,h1_oa,h2_ob,sc_opt))
-                    .deallocate(oscalar,x1c_a,x2c_aaa,x2c_bab,x1c_a_conj,x2c_aaa_conj,x2c_bab_conj);
-                    // end of 2nd GS
-
-
-                  #if GF_IN_SG
-                    #if defined(USE_TALSH) || defined(USE_DPCPP)
-                      sub_sch.execute(ExecutionHW::GPU);
-                    #else
-                      sub_sch.execute();
-                    #endif
-                  }
-                  ec.pg().barrier();
-                  #else
-                    #if defined(USE_TALSH) || defined(USE_DPCPP)
-                      sch.execute(ExecutionHW::GPU);
-                    #else
-                      sch.execute();
-                    #endif
-                  #endif
+              const size_t nadd = gfccsd_gs_panel<T>(ec, otis, static_cast<tamm::Tile>(ccsd_options.tilesize),
+                                    q1_tamm_a, q2_tamm_aaa, q2_tamm_bab, nq,
+                                    gs_q1_tmp_a, gs_q2_tmp_aaa, gs_q2_tmp_bab,
+                                    ivec-prev_qr_rank_orig, ivec_end-prev_qr_rank_orig, q_norm_threshold);
+              gs_cur_lindep += (ivec_end - ivec) - nadd;
 
-              }
-  
               auto cc_t1 = std::chrono::high_resolution_clock::now();
               const auto time_gs_orth_i = std::chrono::duration_cast<std::chrono::duration<double>>((cc_t1 - cc_t0)).count();
               time_gs_orth += time_gs_orth_i;
-  
-              if(gf_profile && rank == 0)
-                std::cout << ": Orthogonalization: " << time_gs_orth_i;
-
-              auto q1norm_a   = norm(q1_tmp_a); 
-              auto q2norm_aaa = norm(q2_tmp_aaa);
-              auto q2norm_bab = norm(q2_tmp_bab);
-          
-              // Normalization factor
-              T q_norm = std::real(sqrt(q1norm_a*q1norm_a + 0.5*q2norm_aaa*q2norm_aaa + q2norm_bab*q2norm_bab));
-
-              if(q_norm < q_norm_threshold) {
-                gs_cur_lindep++;
-                if(gf_profile && rank == 0) cout << " --- continue" << endl;
-                #if 1
-                if (ccsd_options.gf_restart && ((ivec-ivec_start)%ndiis == 0)) {
-                  if(rank==0) {
-                    std::ofstream out(gs_ivec_file, std::ios::out);
-                    if(!out) cerr << "Error opening file " << gs_ivec_file << endl;
-                    out << ivec << std::endl;
-                    out.close();
-                  }
-                  auto q1_a_file    = files_prefix+".r_q1_a.gs_ivec.l"+levelstr;
-                  auto q2_aaa_file  = files_prefix+".r_q2_aaa.gs_ivec.l"+levelstr;
-                  auto q2_bab_file  = files_prefix+".r_q2_bab.gs_ivec.l"+levelstr;
-                  { //retile q1 a,aaa,bab tensors
-                    int q1_tamm_a_ga   = tamm_to_ga(ec,q1_tamm_a);
-                    int q2_tamm_aaa_ga = tamm_to_ga(ec,q2_tamm_aaa);
-                    int q2_tamm_bab_ga = tamm_to_ga(ec,q2_tamm_bab);
-
-                    ComplexTensor i_q1_tamm_a   = {o_alpha,otis_opt};
-                    ComplexTensor i_q2_tamm_aaa = {v_alpha,o_alpha,o_alpha,otis_opt};
-                    ComplexTensor i_q2_tamm_bab = {v_beta, o_alpha,o_beta, otis_opt};
-                    sch.allocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
-
-                    ga_to_tamm(ec,i_q1_tamm_a,q1_tamm_a_ga);
-                    ga_to_tamm(ec,i_q2_tamm_aaa,q2_tamm_aaa_ga);
-                    ga_to_tamm(ec,i_q2_tamm_bab,q2_tamm_bab_ga);
-                    NGA_Destroy(q1_tamm_a_ga); NGA_Destroy(q2_tamm_aaa_ga); NGA_Destroy(q2_tamm_bab_ga);
-                    write_to_disk_group<std::complex<T>>(ec, {i_q1_tamm_a,i_q2_tamm_aaa,i_q2_tamm_bab}, {q1_a_file,q2_aaa_file,q2_bab_file}, gf_profile&&ivec==ivec_start);
-                    sch.deallocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
-                  }
-                }
-                #endif
-                continue;
-              }
 
-              auto cc_norm = std::chrono::high_resolution_clock::now();
               if(gf_profile && rank == 0)
-                std::cout << ", Norm: "
-                          <<  std::chrono::duration_cast<std::chrono::duration<double>>((cc_norm - cc_t1)).count();
-
-              T newsc = 1.0/q_norm;
-  
-              std::complex<T> cnewsc = static_cast<std::complex<T>>(newsc);
-  
-              TiledIndexSpace tsc{otis, range(ivec-gs_prev_lindep,ivec-gs_prev_lindep+1)};
-              auto [sc] = tsc.labels<1>("all");
-  
-              if(subcomm != MPI_COMM_NULL){
-                sub_sch
-                (q1_tamm_a(h1_oa,sc) = cnewsc * q1_tmp_a(h1_oa))
-                (q2_tamm_aaa(p2_va,h1_oa,h2_oa,sc) = cnewsc * q2_tmp_aaa(p2_va,h1_oa,h2_oa))
-                (q2_tamm_bab(p2_vb,h1_oa,h2_ob,sc) = cnewsc * q2_tmp_bab(p2_vb,h1_oa,h2_ob))
-                .execute();
-              }
-              ec.pg().barrier();
+                std::cout << "GS: Time (s) for processing ivec " << ivec << "-" << ivec_end-1 << ": "
+                          << time_gs_orth_i << ", vectors kept: " << nadd << endl;
 
-              auto cc_copy = std::chrono::high_resolution_clock::now();
-              if(gf_profile && rank == 0)
-                std::cout << ", Copy: "
-                          <<  std::chrono::duration_cast<std::chrono::duration<double>>((cc_copy - cc_norm)).count();
-                          
-              if(gf_profile && rank == 0) std::cout << std::endl;
-
-              // check q1/2 inside G-S
-              if(debug) {
-                auto nrm_q1_a_gs   = norm(q1_tamm_a);
-                auto nrm_q2_aaa_gs = norm(q2_tamm_aaa);
-                auto nrm_q2_bab_gs = norm(q2_tamm_bab);
-                if(rank == 0) {
-                  cout << " -- " << ivec << "," << q1norm_a << "," << q2norm_aaa << "," << q2norm_bab << endl;
-                  cout << "   " << "," << cnewsc << "," << nrm_q1_a_gs << "," << nrm_q2_aaa_gs
-                       << "," << nrm_q2_bab_gs << endl;
-                }
-              }
-  
-              auto cc_gs = std::chrono::high_resolution_clock::now();
-              auto time_gs_norm_i = std::chrono::duration_cast<std::chrono::duration<double>>((cc_gs - cc_t1)).count();
-              time_gs_norm  += time_gs_norm_i;
-              if(gf_profile && rank == 0)
-                std::cout << "GS: Time (s) for processing ivec " << ivec << ": Orthogonalization: "
-                          << time_gs_orth_i << ", normalization/copy: " << time_gs_norm_i << endl;
+              ivec = ivec_end;
 
               #if 1
-              if (ccsd_options.gf_restart && ((ivec-ivec_start)%ndiis == 0)) {
+              if (ccsd_options.gf_restart) {
                 if(rank==0) {
                   std::ofstream out(gs_ivec_file, std::ios::out);
                   if(!out) cerr << "Error opening file " << gs_ivec_file << endl;
-                  out << ivec << std::endl;
+                  out << ivec << " " << gs_cur_lindep << std::endl;
                   out.close();
                 }
-                auto q1_a_file    = files_prefix+".r_q1_a.gs_ivec.l"+levelstr;
-                auto q2_aaa_file  = files_prefix+".r_q2_aaa.gs_ivec.l"+levelstr;
-                auto q2_bab_file  = files_prefix+".r_q2_bab.gs_ivec.l"+levelstr;
-                { //retile q1 a,aaa,bab tensors
-                  int q1_tamm_a_ga   = tamm_to_ga(ec,q1_tamm_a);
-                  int q2_tamm_aaa_ga = tamm_to_ga(ec,q2_tamm_aaa);
-                  int q2_tamm_bab_ga = tamm_to_ga(ec,q2_tamm_bab);
-
-                  ComplexTensor i_q1_tamm_a   = {o_alpha,otis_opt};
-                  ComplexTensor i_q2_tamm_aaa = {v_alpha,o_alpha,o_alpha,otis_opt};
-                  ComplexTensor i_q2_tamm_bab = {v_beta, o_alpha,o_beta, otis_opt};
-                  sch.allocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
-
-                  ga_to_tamm(ec,i_q1_tamm_a,q1_tamm_a_ga);
-                  ga_to_tamm(ec,i_q2_tamm_aaa,q2_tamm_aaa_ga);
-                  ga_to_tamm(ec,i_q2_tamm_bab,q2_tamm_bab_ga);
-                  NGA_Destroy(q1_tamm_a_ga); NGA_Destroy(q2_tamm_aaa_ga); NGA_Destroy(q2_tamm_bab_ga);
-                  write_to_disk_group<std::complex<T>>(ec, {i_q1_tamm_a,i_q2_tamm_aaa,i_q2_tamm_bab}, {q1_a_file,q2_aaa_file,q2_bab_file}, gf_profile&&ivec==ivec_start);
-                  sch.deallocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
-                }
+                ComplexTensor i_q1_tamm_a   = {o_alpha,otis_gs_opt};
+                ComplexTensor i_q2_tamm_aaa = {v_alpha,o_alpha,o_alpha,otis_gs_opt};
+                ComplexTensor i_q2_tamm_bab = {v_beta, o_alpha,o_beta, otis_gs_opt};
+                sch.allocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
+                retile_tamm_tensor(q1_tamm_a,i_q1_tamm_a);
+                retile_tamm_tensor(q2_tamm_aaa,i_q2_tamm_aaa);
+                retile_tamm_tensor(q2_tamm_bab,i_q2_tamm_bab);
+                write_to_disk_group<std::complex<T>>(ec, {i_q1_tamm_a,i_q2_tamm_aaa,i_q2_tamm_bab}, {q1_gs_file,q2aaa_gs_file,q2bab_gs_file}, gf_profile&&gs_first);
+                sch.deallocate(i_q1_tamm_a, i_q2_tamm_aaa, i_q2_tamm_bab).execute();
               }
               #endif
-            } //end of Gram-Schmidt for loop over ivec
+            } //end of blocked Gram-Schmidt loop over ivec
 
-            if (ccsd_options.gf_restart && rank == 0) {
-              std::ofstream out(gs_ivec_file, std::ios::out);
-              if(!out) cerr << "Error opening file " << gs_ivec_file << endl;
-              out << qr_rank_orig << std::endl;
-              out.close();
+            // check q1/2 after G-S
+            if(debug) {
+              auto nrm_q1_a_gs   = norm(q1_tamm_a);
+              auto nrm_q2_aaa_gs = norm(q2_tamm_aaa);
+              auto nrm_q2_bab_gs = norm(q2_tamm_bab);
+              if(rank == 0) {
+                cout << "norm of q1/2 after Gram-Schmidt, #lindep = " << gs_cur_lindep << endl;
+                cout << nrm_q1_a_gs << "," << nrm_q2_aaa_gs << "," << nrm_q2_bab_gs << endl;
+              }
             }
   
             free_vec_tensors(gs_q1_tmp_a, gs_q2_tmp_aaa, gs_q2_tmp_bab);
@@ -2357,22 +3353,9 @@ void gfccsd_main_driver(std::string filename) {
             qr_rank_updated = qr_rank_orig - gs_cur_lindep - gs_prev_lindep;
             otis_opt = {IndexSpace{range(qr_rank_updated)}, static_cast<tamm::Tile>(ccsd_options.tilesize)};
 
-            { //retile q1 a,aaa,bab tensors
-              int q1_tamm_a_ga   = tamm_to_ga(ec,q1_tamm_a);
-              int q2_tamm_aaa_ga = tamm_to_ga(ec,q2_tamm_aaa);
-              int q2_tamm_bab_ga = tamm_to_ga(ec,q2_tamm_bab);
-              sch.deallocate(q1_tamm_a, q2_tamm_aaa, q2_tamm_bab).execute();
-
-              q1_tamm_a   = {o_alpha,otis_opt};
-              q2_tamm_aaa = {v_alpha,o_alpha,o_alpha,otis_opt};
-              q2_tamm_bab = {v_beta, o_alpha,o_beta, otis_opt};        
-              sch.allocate(q1_tamm_a, q2_tamm_aaa, q2_tamm_bab).execute();
-
-              ga_to_tamm(ec,q1_tamm_a,q1_tamm_a_ga);
-              ga_to_tamm(ec,q2_tamm_aaa,q2_tamm_aaa_ga);
-              ga_to_tamm(ec,q2_tamm_bab,q2_tamm_bab_ga);
-              NGA_Destroy(q1_tamm_a_ga); NGA_Destroy(q2_tamm_aaa_ga); NGA_Destroy(q2_tamm_bab_ga);    
-            }
+            retile_ip(q1_tamm_a,  {o_alpha,otis_opt});
+            retile_ip(q2_tamm_aaa,{v_alpha,o_alpha,o_alpha,otis_opt});
+            retile_ip(q2_tamm_bab,{v_beta, o_alpha,o_beta, otis_opt});
 
             write_to_disk(q1_tamm_a,   q1_a_file);
             write_to_disk(q2_tamm_aaa, q2_aaa_file);
@@ -2389,7 +3372,6 @@ void gfccsd_main_driver(std::string filename) {
 
           if(rank == 0) {
             cout << endl << " -- Gram-Schmidt: Time for orthogonalization: " << std::fixed << std::setprecision(6) << time_gs_orth << " secs" << endl;
-            cout         << " -- Gram-Schmidt: Time for normalizing and copying back: " << std::fixed << std::setprecision(6) << time_gs_norm << " secs" << endl;
             cout         << "Total time for Gram-Schmidt: " << std::fixed << std::setprecision(6) << total_time_gs << " secs" << endl;
           }
           auto cc_gs_x = std::chrono::high_resolution_clock::now();
@@ -2674,8 +3656,9 @@ void gfccsd_main_driver(std::string filename) {
           if(rank==0) cout << endl << "--------------------extrapolate & converge-----------------------" << endl;
           auto cc_t1 = std::chrono::high_resolution_clock::now();
   
-          AtomicCounter* ac = new AtomicCounterGA(ec.pg(), 1);
+          AtomicCounter* ac = new AtomicCounterChunked(ec.pg(), 1);
           ac->allocate(0);
+          ac->set_task_count(0, lomega_npts_ip);
           int64_t taskcount = 0;
           int64_t next = ac->fetch_add(0, 1);
 
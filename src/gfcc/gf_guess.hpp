@@ -4,11 +4,11 @@
 #include <complex>
 using namespace tamm;
 
+// (t2v2_o + diag(w - e_occ - i*eta))^-1, shared by all orbitals at a given omega
 template<typename T>
-void gf_guess_ip(ExecutionContext& ec, const TiledIndexSpace& MO, const TAMM_SIZE nocc, double omega, 
-              double gf_eta, int pi, std::vector<T>& p_evl_sorted_occ,
-              Tensor<T>& t2v2_o, Tensor<std::complex<T>>& x1, 
-              Tensor<std::complex<T>>& Minv, bool opt=false) {
+Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+gf_guess_ip_minv(ExecutionContext& ec, const TiledIndexSpace& MO, const TAMM_SIZE nocc, double omega,
+              double gf_eta, std::vector<T>& p_evl_sorted_occ, Tensor<T>& t2v2_o) {
 
     using ComplexTensor = Tensor<std::complex<T>>;
 
@@ -39,7 +39,17 @@ void gf_guess_ip(ExecutionContext& ec, const TiledIndexSpace& MO, const TAMM_SIZ
         guessM_eig(i,i) += std::complex<T>(denominator, -1.0*gf_eta); 
     }
     
-    CMatrix guessMI = guessM_eig.inverse();
+    return guessM_eig.inverse();
+}
+
+template<typename T>
+void gf_guess_ip(ExecutionContext& ec, const TiledIndexSpace& MO, const TAMM_SIZE nocc, double omega, 
+              double gf_eta, int pi, std::vector<T>& p_evl_sorted_occ,
+              Tensor<T>& t2v2_o, Tensor<std::complex<T>>& x1, 
+              Tensor<std::complex<T>>& Minv, bool opt=false) {
+
+    using CMatrix   = Eigen::Matrix<std::complex<T>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    CMatrix guessMI = gf_guess_ip_minv(ec, MO, nocc, omega, gf_eta, p_evl_sorted_occ, t2v2_o);
 
     if(opt){
         Eigen::Tensor<std::complex<T>, 1, Eigen::RowMajor> x1e(nocc);